@@ -0,0 +1,145 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_benchmark.cpp
+//
+// Identification: benchmark/buffer/buffer_pool_manager_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <functional>
+
+#include "benchmark/benchmark.h"
+#include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "common/benchmark_util.h"
+#include "storage/memory_disk_manager.h"
+
+namespace bustub {
+
+/** Total number of frames of every buffer pool under test. */
+static constexpr size_t BENCHMARK_POOL_SIZE = 1024;
+/** Number of instances of the parallel buffer pools under test. */
+static constexpr size_t BENCHMARK_NUM_INSTANCES = 8;
+
+/**
+ * Each iteration fetches a page, reads its first byte and unpins it. Thread 0 builds the buffer pool before the
+ * benchmark loop and tears it down after it; the loop's start and end synchronize the threads.
+ */
+static void RunBufferPoolBenchmark(benchmark::State *state, Workload workload,
+                                   const std::function<BufferPoolManager *(DiskManager *)> &make_bpm) {
+  static MemoryDiskManager *disk_manager;
+  static BufferPoolManager *bpm;
+  if (state->thread_index() == 0) {
+    disk_manager = new MemoryDiskManager(WorkloadGenerator::NumPages(workload, BENCHMARK_POOL_SIZE));
+    bpm = make_bpm(disk_manager);
+  }
+  WorkloadGenerator generator(workload, BENCHMARK_POOL_SIZE, state->thread_index());
+  LatencyRecorder latencies;
+  uint64_t failed_fetches = 0;
+
+  for (auto _ : *state) {
+    page_id_t page_id = generator.Next();
+    bool sample = latencies.ShouldSample();
+    auto start = sample ? LatencyRecorder::Now() : std::chrono::steady_clock::time_point();
+    Page *page = bpm->FetchPage(page_id);
+    // Every frame can be pinned at once when there are more threads than frames in an instance.
+    if (page == nullptr) {
+      ++failed_fetches;
+      continue;
+    }
+    benchmark::DoNotOptimize(page->GetData()[0]);
+    bpm->UnpinPage(page_id, false);
+    if (sample) {
+      latencies.Record(start);
+    }
+  }
+
+  state->SetItemsProcessed(state->iterations());
+  state->counters["failed_fetches"] = static_cast<double>(failed_fetches);
+  latencies.Report(state);
+  if (state->thread_index() == 0) {
+    BufferPoolStats stats = bpm->GetStats();
+    state->counters["hit_ratio"] = stats.HitRatio();
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+static void BM_BufferPoolManagerInstance(benchmark::State &state, Workload workload) {  // NOLINT
+  auto replacer_type = static_cast<ReplacerType>(state.range(0));
+  RunBufferPoolBenchmark(&state, workload, [replacer_type](DiskManager *disk_manager) {
+    return new BufferPoolManagerInstance(BENCHMARK_POOL_SIZE, disk_manager, nullptr, replacer_type);
+  });
+}
+
+static void BM_ParallelBufferPoolManager(benchmark::State &state, Workload workload) {  // NOLINT
+  auto replacer_type = static_cast<ReplacerType>(state.range(0));
+  RunBufferPoolBenchmark(&state, workload, [replacer_type](DiskManager *disk_manager) {
+    return new ParallelBufferPoolManager(BENCHMARK_NUM_INSTANCES, BENCHMARK_POOL_SIZE / BENCHMARK_NUM_INSTANCES,
+                                         disk_manager, nullptr, replacer_type);
+  });
+}
+
+/**
+ * Each iteration creates a page and unpins it clean, as bulk inserts do, so that it can be evicted without a write.
+ * This measures how well page allocation scales with the number of threads.
+ */
+static void BM_ParallelBufferPoolManagerNewPage(benchmark::State &state) {  // NOLINT
+  static MemoryDiskManager *disk_manager;
+  static BufferPoolManager *bpm;
+  if (state.thread_index() == 0) {
+    disk_manager = new MemoryDiskManager(0);
+    bpm = new ParallelBufferPoolManager(BENCHMARK_NUM_INSTANCES, BENCHMARK_POOL_SIZE / BENCHMARK_NUM_INSTANCES,
+                                        disk_manager);
+  }
+  LatencyRecorder latencies;
+
+  for (auto _ : state) {
+    bool sample = latencies.ShouldSample();
+    auto start = sample ? LatencyRecorder::Now() : std::chrono::steady_clock::time_point();
+    page_id_t page_id;
+    Page *page = bpm->NewPage(&page_id);
+    benchmark::DoNotOptimize(page);
+    bpm->UnpinPage(page_id, false);
+    if (sample) {
+      latencies.Record(start);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  latencies.Report(&state);
+  if (state.thread_index() == 0) {
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+/** Run a buffer pool benchmark with every replacement policy and thread count. */
+static void ApplyBufferPoolArguments(benchmark::internal::Benchmark *benchmark) {
+  benchmark->ArgName("replacer");
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::ARC}) {
+    benchmark->Arg(static_cast<int64_t>(replacer_type));
+  }
+  ApplyThreadCounts(benchmark);
+  benchmark->UseRealTime();
+}
+
+BENCHMARK_CAPTURE(BM_BufferPoolManagerInstance, hit, Workload::HIT)->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_BufferPoolManagerInstance, zipfian, Workload::ZIPFIAN)->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_BufferPoolManagerInstance, uniform_miss, Workload::UNIFORM_MISS)
+    ->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_BufferPoolManagerInstance, scan_point, Workload::SCAN_POINT)->Apply(ApplyBufferPoolArguments);
+
+BENCHMARK_CAPTURE(BM_ParallelBufferPoolManager, hit, Workload::HIT)->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_ParallelBufferPoolManager, zipfian, Workload::ZIPFIAN)->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_ParallelBufferPoolManager, uniform_miss, Workload::UNIFORM_MISS)
+    ->Apply(ApplyBufferPoolArguments);
+BENCHMARK_CAPTURE(BM_ParallelBufferPoolManager, scan_point, Workload::SCAN_POINT)->Apply(ApplyBufferPoolArguments);
+
+BENCHMARK(BM_ParallelBufferPoolManagerNewPage)->Apply(ApplyThreadCounts)->UseRealTime();
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark.cpp
+//
+// Identification: benchmark/buffer/replacer_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "buffer/arc_replacer.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/lru_k_replacer.h"
+#include "buffer/lru_replacer.h"
+#include "common/benchmark_util.h"
+
+namespace bustub {
+
+/** Number of frames of every replacer under test. */
+static constexpr size_t BENCHMARK_NUM_FRAMES = 1024;
+
+/** Create the shared replacer on thread 0, with every frame evictable. */
+template <typename ReplacerT>
+static ReplacerT *SetUpReplacer(benchmark::State *state, ReplacerT **replacer) {
+  if (state->thread_index() == 0) {
+    *replacer = new ReplacerT(BENCHMARK_NUM_FRAMES);
+    for (size_t i = 0; i < BENCHMARK_NUM_FRAMES; ++i) {
+      (*replacer)->SetFramePage(static_cast<frame_id_t>(i), static_cast<page_id_t>(i));
+      (*replacer)->Pin(static_cast<frame_id_t>(i));
+      (*replacer)->Unpin(static_cast<frame_id_t>(i));
+    }
+  }
+  return *replacer;
+}
+
+/**
+ * The replacer side of a buffer pool hit: pin and unpin a frame. Each thread picks among its own frames, so the only
+ * contention is on the replacer's internal synchronization.
+ */
+template <typename ReplacerT>
+static void BM_ReplacerHit(benchmark::State &state) {  // NOLINT
+  static ReplacerT *replacer;
+  SetUpReplacer(&state, &replacer);
+  WorkloadGenerator generator(Workload::ZIPFIAN, std::max<size_t>(BENCHMARK_NUM_FRAMES / 4 / state.threads(), 1),
+                              state.thread_index());
+  auto frame_offset = static_cast<frame_id_t>(state.thread_index() * (BENCHMARK_NUM_FRAMES / state.threads()));
+  LatencyRecorder latencies;
+
+  for (auto _ : state) {
+    frame_id_t frame_id = frame_offset + generator.Next();
+    bool sample = latencies.ShouldSample();
+    auto start = sample ? LatencyRecorder::Now() : std::chrono::steady_clock::time_point();
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+    if (sample) {
+      latencies.Record(start);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  latencies.Report(&state);
+  if (state.thread_index() == 0) {
+    delete replacer;
+  }
+}
+
+/** The replacer side of a buffer pool miss: pick a victim, give it a new page, and unpin it once loaded. */
+template <typename ReplacerT>
+static void BM_ReplacerMiss(benchmark::State &state) {  // NOLINT
+  static ReplacerT *replacer;
+  SetUpReplacer(&state, &replacer);
+  auto next_page_id = static_cast<page_id_t>(BENCHMARK_NUM_FRAMES * (state.thread_index() + 1) * 1000);
+  LatencyRecorder latencies;
+
+  for (auto _ : state) {
+    bool sample = latencies.ShouldSample();
+    auto start = sample ? LatencyRecorder::Now() : std::chrono::steady_clock::time_point();
+    frame_id_t frame_id;
+    if (!replacer->Victim(&frame_id)) {
+      continue;
+    }
+    replacer->SetFramePage(frame_id, next_page_id++);
+    replacer->Pin(frame_id);
+    replacer->Unpin(frame_id);
+    if (sample) {
+      latencies.Record(start);
+    }
+  }
+
+  state.SetItemsProcessed(state.iterations());
+  latencies.Report(&state);
+  if (state.thread_index() == 0) {
+    delete replacer;
+  }
+}
+
+/** Run a replacer benchmark at every thread count. */
+static void ApplyReplacerArguments(benchmark::internal::Benchmark *benchmark) {
+  ApplyThreadCounts(benchmark);
+  benchmark->UseRealTime();
+}
+
+BENCHMARK_TEMPLATE(BM_ReplacerHit, LRUReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerHit, ClockReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerHit, LRUKReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerHit, ARCReplacer)->Apply(ApplyReplacerArguments);
+
+BENCHMARK_TEMPLATE(BM_ReplacerMiss, LRUReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerMiss, ClockReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerMiss, LRUKReplacer)->Apply(ApplyReplacerArguments);
+BENCHMARK_TEMPLATE(BM_ReplacerMiss, ARCReplacer)->Apply(ApplyReplacerArguments);
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels_benchmark.cpp
+//
+// Identification: benchmark/execution/filter_kernels_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "catalog/schema.h"
+#include "execution/batch_filter.h"
+#include "execution/compiled_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/**
+ * A full batch of (a, b) rows, with a uniform in [0, 1000) and b uniform in [0, 1000000), and the predicate
+ * a < selectivity AND b < 500000, which selects about selectivity / 2 rows in a thousand.
+ */
+struct FilterWorkload {
+  explicit FilterWorkload(int32_t selectivity)
+      : schema_(std::vector<Column>{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)}),
+        col_a_(0, 0, TypeId::INTEGER),
+        col_b_(0, 1, TypeId::BIGINT),
+        const_a_(ValueFactory::GetIntegerValue(selectivity)),
+        const_b_(ValueFactory::GetBigIntValue(500000)),
+        a_lt_(&col_a_, &const_a_, ComparisonType::LessThan),
+        b_lt_(&col_b_, &const_b_, ComparisonType::LessThan),
+        predicate_(&a_lt_, &b_lt_, LogicType::And) {
+    std::mt19937 generator(15445);
+    std::uniform_int_distribution<int32_t> distribution_a(0, 999);
+    std::uniform_int_distribution<int64_t> distribution_b(0, 999999);
+    batch_.Init(&schema_);
+    for (size_t i = 0; i < EXECUTION_BATCH_SIZE; i++) {
+      batch_.AppendValue(0, ValueFactory::GetIntegerValue(distribution_a(generator)));
+      batch_.AppendValue(1, ValueFactory::GetBigIntValue(distribution_b(generator)));
+      batch_.FinishRow(RID());
+    }
+  }
+
+  Schema schema_;
+  TupleBatch batch_;
+  ColumnValueExpression col_a_;
+  ColumnValueExpression col_b_;
+  ConstantValueExpression const_a_;
+  ConstantValueExpression const_b_;
+  ComparisonExpression a_lt_;
+  ComparisonExpression b_lt_;
+  LogicExpression predicate_;
+};
+
+/** Each iteration filters one batch with the kernels, into a selection vector. */
+static void BM_BatchFilter(benchmark::State &state) {  // NOLINT
+  FilterWorkload workload(state.range(0));
+  BatchFilter filter(&workload.predicate_, &workload.schema_);
+  SelectionBitmap bitmap;
+  std::vector<uint32_t> selection;
+  for (auto _ : state) {
+    filter.Evaluate(workload.batch_, &bitmap);
+    bitmap.ToSelection(&selection);
+    benchmark::DoNotOptimize(selection.data());
+  }
+  state.SetItemsProcessed(state.iterations() * EXECUTION_BATCH_SIZE);
+}
+
+/** The same filter evaluated row by row into Values, as SeqScanExecutor used to. */
+static void BM_RowFilter(benchmark::State &state) {  // NOLINT
+  FilterWorkload workload(state.range(0));
+  std::vector<uint32_t> selection;
+  for (auto _ : state) {
+    selection.clear();
+    for (uint32_t row = 0; row < workload.batch_.Size(); row++) {
+      Value value = workload.predicate_.EvaluateInBatch(&workload.batch_, row);
+      if (!value.IsNull() && value.GetAs<bool>()) {
+        selection.push_back(row);
+      }
+    }
+    benchmark::DoNotOptimize(selection.data());
+  }
+  state.SetItemsProcessed(state.iterations() * EXECUTION_BATCH_SIZE);
+}
+
+/** The same filter compiled, and run row by row on unboxed values. */
+static void BM_CompiledRowFilter(benchmark::State &state) {  // NOLINT
+  FilterWorkload workload(state.range(0));
+  CompiledExpression predicate(&workload.predicate_, &workload.schema_);
+  std::vector<uint32_t> selection;
+  for (auto _ : state) {
+    selection.clear();
+    for (uint32_t row = 0; row < workload.batch_.Size(); row++) {
+      if (predicate.EvaluateInBatch(&workload.batch_, row) == CmpBool::CmpTrue) {
+        selection.push_back(row);
+      }
+    }
+    benchmark::DoNotOptimize(selection.data());
+  }
+  state.SetItemsProcessed(state.iterations() * EXECUTION_BATCH_SIZE);
+}
+
+BENCHMARK(BM_BatchFilter)->Arg(10)->Arg(100)->Arg(500);
+BENCHMARK(BM_RowFilter)->Arg(10)->Arg(100)->Arg(500);
+BENCHMARK(BM_CompiledRowFilter)->Arg(10)->Arg(100)->Arg(500);
+
+}  // namespace bustub
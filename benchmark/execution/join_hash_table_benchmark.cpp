@@ -0,0 +1,115 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table_benchmark.cpp
+//
+// Identification: benchmark/execution/join_hash_table_benchmark.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "catalog/schema.h"
+#include "execution/join_hash_table.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** Number of probes looked up together, as HashJoinExecutor does. */
+static constexpr size_t BENCHMARK_PROBE_BATCH_SIZE = 64;
+
+/** Build tuples (key, payload) with keys 0 to n - 1, and probe keys of which about half match. */
+struct JoinWorkload {
+  explicit JoinWorkload(size_t num_build_tuples)
+      : schema_(std::vector<Column>{Column("key", TypeId::INTEGER), Column("payload", TypeId::INTEGER)}) {
+    for (size_t i = 0; i < num_build_tuples; i++) {
+      std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(2 * i)};
+      build_tuples_.emplace_back(values, &schema_);
+    }
+    std::mt19937 generator(15445);
+    std::uniform_int_distribution<int32_t> distribution(0, static_cast<int32_t>(2 * num_build_tuples - 1));
+    for (size_t i = 0; i < (1 << 16); i++) {
+      probe_keys_.push_back(ValueFactory::GetIntegerValue(distribution(generator)));
+    }
+  }
+
+  Schema schema_;
+  std::vector<Tuple> build_tuples_;
+  std::vector<Value> probe_keys_;
+};
+
+/** The key of the std::unordered_map HashJoinExecutor used to build on. */
+struct BaselineKey {
+  Value key_;
+  bool operator==(const BaselineKey &other) const { return key_.CompareEquals(other.key_) == CmpBool::CmpTrue; }
+};
+
+struct BaselineKeyHash {
+  size_t operator()(const BaselineKey &key) const { return HashUtil::HashValue(&key.key_); }
+};
+
+/** Each iteration probes one batch and reads the payload of every match. */
+static void BM_JoinHashTableProbe(benchmark::State &state) {  // NOLINT
+  JoinWorkload workload(state.range(0));
+  JoinHashTable table;
+  for (const Tuple &tuple : workload.build_tuples_) {
+    Value key = tuple.GetValue(&workload.schema_, 0);
+    table.Insert(key, HashUtil::HashValue(&key), tuple);
+  }
+
+  std::vector<hash_t> hashes(BENCHMARK_PROBE_BATCH_SIZE);
+  size_t next_probe = 0;
+  Tuple tuple;
+  for (auto _ : state) {
+    const Value *keys = &workload.probe_keys_[next_probe];
+    next_probe = (next_probe + BENCHMARK_PROBE_BATCH_SIZE) % workload.probe_keys_.size();
+    for (size_t i = 0; i < BENCHMARK_PROBE_BATCH_SIZE; i++) {
+      hashes[i] = HashUtil::HashValue(&keys[i]);
+      table.Prefetch(hashes[i]);
+    }
+    for (size_t i = 0; i < BENCHMARK_PROBE_BATCH_SIZE; i++) {
+      for (const char *row = table.Find(keys[i], hashes[i]); row != nullptr; row = JoinHashTable::NextRow(row)) {
+        JoinHashTable::GetTuple(row, &tuple);
+        benchmark::DoNotOptimize(tuple.GetValue(&workload.schema_, 1));
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * BENCHMARK_PROBE_BATCH_SIZE);
+}
+
+/** The same probes against the std::unordered_map of value vectors HashJoinExecutor used to build. */
+static void BM_UnorderedMapProbe(benchmark::State &state) {  // NOLINT
+  JoinWorkload workload(state.range(0));
+  std::unordered_map<BaselineKey, std::vector<std::vector<Value>>, BaselineKeyHash> table;
+  for (const Tuple &tuple : workload.build_tuples_) {
+    std::vector<Value> values{tuple.GetValue(&workload.schema_, 0), tuple.GetValue(&workload.schema_, 1)};
+    table[BaselineKey{values[0]}].push_back(values);
+  }
+
+  size_t next_probe = 0;
+  for (auto _ : state) {
+    const Value *keys = &workload.probe_keys_[next_probe];
+    next_probe = (next_probe + BENCHMARK_PROBE_BATCH_SIZE) % workload.probe_keys_.size();
+    for (size_t i = 0; i < BENCHMARK_PROBE_BATCH_SIZE; i++) {
+      auto iter = table.find(BaselineKey{keys[i]});
+      if (iter == table.end()) {
+        continue;
+      }
+      for (const auto &values : iter->second) {
+        benchmark::DoNotOptimize(values[1]);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * BENCHMARK_PROBE_BATCH_SIZE);
+}
+
+BENCHMARK(BM_JoinHashTableProbe)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+BENCHMARK(BM_UnorderedMapProbe)->RangeMultiplier(16)->Range(1 << 10, 1 << 18);
+
+}  // namespace bustub
@@ -0,0 +1,191 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// benchmark_util.h
+//
+// Identification: benchmark/include/common/benchmark_util.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/** Page access patterns of the buffer pool benchmarks. */
+enum class Workload {
+  /** Uniform accesses to half as many pages as the pool holds. Every access after warm-up is a hit. */
+  HIT,
+  /** Zipfian (theta 0.99) accesses to four times as many pages as the pool holds. */
+  ZIPFIAN,
+  /** Uniform accesses to sixteen times as many pages as the pool holds. Most accesses miss. */
+  UNIFORM_MISS,
+  /**
+   * Zipfian point accesses to as many pages as the pool holds. One access in four instead reads the next page of a
+   * sequential scan over sixteen times as many other pages.
+   */
+  SCAN_POINT,
+};
+
+/**
+ * ZipfianGenerator draws integers in [0, n) where i is drawn with probability proportional to 1 / (i + 1)^theta, with
+ * the method of Gray et al., "Quickly Generating Billion-Record Synthetic Databases". Construction is O(n).
+ */
+class ZipfianGenerator {
+ public:
+  ZipfianGenerator(uint64_t n, double theta) : n_(n) {
+    double zeta_n = 0;
+    for (uint64_t i = 1; i <= n; ++i) {
+      zeta_n += 1 / std::pow(static_cast<double>(i), theta);
+    }
+    double zeta_2 = 1 + 1 / std::pow(2.0, theta);
+    alpha_ = 1 / (1 - theta);
+    eta_ = (1 - std::pow(2.0 / n, 1 - theta)) / (1 - zeta_2 / zeta_n);
+    half_pow_theta_ = 1 + std::pow(0.5, theta);
+    zeta_n_ = zeta_n;
+  }
+
+  template <typename Engine>
+  uint64_t Next(Engine *engine) {
+    double u = std::uniform_real_distribution<double>(0, 1)(*engine);
+    double uz = u * zeta_n_;
+    if (uz < 1) {
+      return 0;
+    }
+    if (uz < half_pow_theta_) {
+      return 1;
+    }
+    auto value = static_cast<uint64_t>(n_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+    return std::min(value, n_ - 1);
+  }
+
+ private:
+  uint64_t n_;
+  double alpha_;
+  double eta_;
+  double zeta_n_;
+  double half_pow_theta_;
+};
+
+/**
+ * WorkloadGenerator produces the page ids one benchmark thread accesses. Each thread owns its generator, so drawing a
+ * page id never synchronizes with other threads.
+ */
+class WorkloadGenerator {
+ public:
+  /**
+   * @param workload the access pattern
+   * @param pool_size the total number of frames of the buffer pool under test
+   * @param thread_index index of the benchmark thread, used as the seed and to spread the scans of the threads
+   */
+  WorkloadGenerator(Workload workload, size_t pool_size, int thread_index)
+      : workload_(workload),
+        engine_(thread_index + 1),
+        num_pages_(NumPages(workload, pool_size)),
+        hot_pages_(workload == Workload::SCAN_POINT ? pool_size : num_pages_),
+        zipfian_(hot_pages_, 0.99),
+        scan_position_(static_cast<size_t>(thread_index) * pool_size) {}
+
+  /** @return the number of distinct page ids the workload accesses, all below this number */
+  static size_t NumPages(Workload workload, size_t pool_size) {
+    switch (workload) {
+      case Workload::HIT:
+        return std::max<size_t>(pool_size / 2, 1);
+      case Workload::ZIPFIAN:
+        return 4 * pool_size;
+      case Workload::UNIFORM_MISS:
+        return 16 * pool_size;
+      case Workload::SCAN_POINT:
+        return 17 * pool_size;
+    }
+    return pool_size;
+  }
+
+  /** @return the next page id to access */
+  page_id_t Next() {
+    switch (workload_) {
+      case Workload::HIT:
+      case Workload::UNIFORM_MISS:
+        return static_cast<page_id_t>(std::uniform_int_distribution<size_t>(0, num_pages_ - 1)(engine_));
+      case Workload::ZIPFIAN:
+        return static_cast<page_id_t>(zipfian_.Next(&engine_));
+      case Workload::SCAN_POINT:
+        if (++op_count_ % 4 == 0) {
+          scan_position_ = (scan_position_ + 1) % (num_pages_ - hot_pages_);
+          return static_cast<page_id_t>(hot_pages_ + scan_position_);
+        }
+        return static_cast<page_id_t>(zipfian_.Next(&engine_));
+    }
+    return 0;
+  }
+
+ private:
+  const Workload workload_;
+  std::mt19937_64 engine_;
+  const size_t num_pages_;
+  /** Page ids below hot_pages_ are drawn at random, the others are scanned. */
+  const size_t hot_pages_;
+  ZipfianGenerator zipfian_;
+  size_t scan_position_;
+  uint64_t op_count_{0};
+};
+
+/**
+ * LatencyRecorder times one operation in every SAMPLE_INTERVAL, so that reading the clock does not dominate the cost
+ * of fast operations, and reports the percentiles of the samples as benchmark counters averaged over the threads.
+ */
+class LatencyRecorder {
+ public:
+  static constexpr uint64_t SAMPLE_INTERVAL = 8;
+
+  /** @return true if the next operation should be timed */
+  bool ShouldSample() { return ++op_count_ % SAMPLE_INTERVAL == 0; }
+
+  static std::chrono::steady_clock::time_point Now() { return std::chrono::steady_clock::now(); }
+
+  void Record(std::chrono::steady_clock::time_point start) {
+    samples_.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Now() - start).count());
+  }
+
+  /** Add the p50, p99 and p99.9 latencies, in nanoseconds, to the benchmark's counters. */
+  void Report(benchmark::State *state) {
+    if (samples_.empty()) {
+      return;
+    }
+    std::sort(samples_.begin(), samples_.end());
+    auto percentile = [this](double p) {
+      return static_cast<double>(samples_[std::min(samples_.size() - 1, static_cast<size_t>(p * samples_.size()))]);
+    };
+    state->counters["p50_ns"] = benchmark::Counter(percentile(0.5), benchmark::Counter::kAvgThreads);
+    state->counters["p99_ns"] = benchmark::Counter(percentile(0.99), benchmark::Counter::kAvgThreads);
+    state->counters["p999_ns"] = benchmark::Counter(percentile(0.999), benchmark::Counter::kAvgThreads);
+  }
+
+ private:
+  uint64_t op_count_{0};
+  std::vector<int64_t> samples_;
+};
+
+/** Run a benchmark at 1, 2, 4, ... threads, up to and including the number of hardware threads. */
+inline void ApplyThreadCounts(benchmark::internal::Benchmark *benchmark) {
+  int max_threads = std::max<int>(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  for (int threads = 1; threads < max_threads; threads *= 2) {
+    benchmark->Threads(threads);
+  }
+  benchmark->Threads(max_threads);
+}
+
+}  // namespace bustub
@@ -0,0 +1,55 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// memory_disk_manager.h
+//
+// Identification: benchmark/include/storage/memory_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "common/macros.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * MemoryDiskManager keeps the pages of a fixed number of page ids in memory, so that a benchmark of the buffer pool
+ * measures its CPU and synchronization costs rather than the disk. Pages that were never written read back as zeros.
+ * It takes no latch: the buffer pool never reads or writes a page from two threads at once.
+ */
+class MemoryDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new in-memory disk manager.
+   * @param num_pages the number of page ids, starting at 0, that can be read and written
+   */
+  explicit MemoryDiskManager(size_t num_pages) : num_pages_(num_pages), data_(new char[num_pages * PAGE_SIZE]()) {}
+
+  ~MemoryDiskManager() override { delete[] data_; }
+
+  void ShutDown() override {}
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    memcpy(PageData(page_id), page_data, PAGE_SIZE);
+  }
+
+  void ReadPage(page_id_t page_id, char *page_data) override { memcpy(page_data, PageData(page_id), PAGE_SIZE); }
+
+ private:
+  char *PageData(page_id_t page_id) {
+    BUSTUB_ASSERT(page_id >= 0 && static_cast<size_t>(page_id) < num_pages_, "page id out of range");
+    return data_ + static_cast<size_t>(page_id) * PAGE_SIZE;
+  }
+
+  const size_t num_pages_;
+  char *data_;
+};
+
+}  // namespace bustub
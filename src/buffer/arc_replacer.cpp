@@ -0,0 +1,176 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.cpp
+//
+// Identification: src/buffer/arc_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/arc_replacer.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+ARCReplacer::ARCReplacer(size_t num_pages, size_t correlated_period)
+    : num_pages_(num_pages), correlated_period_(correlated_period), frames_(num_pages) {}
+
+ARCReplacer::~ARCReplacer() = default;
+
+bool ARCReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  ListType preferred = PreferredList();
+  ListType other = preferred == ListType::T1 ? ListType::T2 : ListType::T1;
+  // If every page of the preferred list is pinned, take from the other one rather than fail.
+  for (ListType list : {preferred, other}) {
+    std::list<frame_id_t> *evictable = Evictable(list);
+    if (!evictable->empty()) {
+      *frame_id = evictable->back();
+      Erase(*frame_id);
+      return true;
+    }
+  }
+  *frame_id = INVALID_PAGE_ID;
+  return false;
+}
+
+void ARCReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  Erase(frame_id);
+  // A reference to a page in T1 that is not correlated with its load makes the page frequent. The pin that comes with
+  // the load itself is at distance zero.
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.list_ == ListType::T1 && current_time_ - frame.load_time_ > correlated_period_) {
+    frame.list_ = ListType::T2;
+    --t1_size_;
+    ++t2_size_;
+  }
+  ++current_time_;
+}
+
+void ARCReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    return;
+  }
+  // A frame the buffer pool never told us about is treated as recent.
+  if (frame.list_ == ListType::NONE) {
+    frame.list_ = ListType::T1;
+    frame.load_time_ = current_time_;
+    ++t1_size_;
+  }
+  std::list<frame_id_t> *evictable = Evictable(frame.list_);
+  evictable->push_front(frame_id);
+  frame.iter_ = evictable->begin();
+  frame.evictable_ = true;
+}
+
+void ARCReplacer::PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  frame_ids->clear();
+  ListType preferred = PreferredList();
+  ListType other = preferred == ListType::T1 ? ListType::T2 : ListType::T1;
+  for (ListType list : {preferred, other}) {
+    std::list<frame_id_t> *evictable = Evictable(list);
+    for (auto iter = evictable->rbegin(); iter != evictable->rend() && frame_ids->size() < count; ++iter) {
+      frame_ids->push_back(*iter);
+    }
+  }
+}
+
+void ARCReplacer::SetFramePage(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // An unpin that raced with the frame being claimed may have put it back.
+  Erase(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+
+  // The page the frame held has been evicted, unless the frame is being freed because the page was deleted.
+  if (frame.list_ == ListType::T1) {
+    --t1_size_;
+  } else if (frame.list_ == ListType::T2) {
+    --t2_size_;
+  }
+  if (frame.page_id_ != INVALID_PAGE_ID && page_id != INVALID_PAGE_ID) {
+    PushGhost(frame.list_ == ListType::T2 ? &b2_ : &b1_, frame.page_id_);
+  }
+  frame.page_id_ = page_id;
+  frame.list_ = ListType::NONE;
+  if (page_id == INVALID_PAGE_ID) {
+    return;
+  }
+
+  // A miss on a ghost adapts the target size of T1 towards the list that would have kept the page.
+  frame.load_time_ = current_time_;
+  if (RemoveGhost(&b1_, page_id)) {
+    size_t delta = std::max<size_t>(b2_.pages_.size() / (b1_.pages_.size() + 1), 1);
+    target_t1_ = std::min(num_pages_, target_t1_ + delta);
+    frame.list_ = ListType::T2;
+    ++t2_size_;
+  } else if (RemoveGhost(&b2_, page_id)) {
+    size_t delta = std::max<size_t>(b1_.pages_.size() / (b2_.pages_.size() + 1), 1);
+    target_t1_ = target_t1_ - std::min(target_t1_, delta);
+    frame.list_ = ListType::T2;
+    ++t2_size_;
+  } else {
+    frame.list_ = ListType::T1;
+    ++t1_size_;
+  }
+
+  // Keep |T1| + |B1| <= c and |T1| + |T2| + |B1| + |B2| <= 2c.
+  while (t1_size_ + b1_.pages_.size() > num_pages_ && !b1_.pages_.empty()) {
+    PopGhost(&b1_);
+  }
+  while (t1_size_ + t2_size_ + b1_.pages_.size() + b2_.pages_.size() > 2 * num_pages_) {
+    PopGhost(b2_.pages_.empty() ? &b1_ : &b2_);
+  }
+}
+
+size_t ARCReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return t1_.size() + t2_.size();
+}
+
+size_t ARCReplacer::GetTargetRecentSize() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return target_t1_;
+}
+
+ARCReplacer::ListType ARCReplacer::PreferredList() const {
+  return t1_size_ > 0 && (t1_size_ > target_t1_ || t2_size_ == 0) ? ListType::T1 : ListType::T2;
+}
+
+void ARCReplacer::Erase(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    Evictable(frame.list_)->erase(frame.iter_);
+    frame.evictable_ = false;
+  }
+}
+
+void ARCReplacer::PushGhost(GhostList *ghost, page_id_t page_id) {
+  RemoveGhost(ghost, page_id);
+  ghost->pages_.push_front(page_id);
+  ghost->index_[page_id] = ghost->pages_.begin();
+}
+
+void ARCReplacer::PopGhost(GhostList *ghost) {
+  ghost->index_.erase(ghost->pages_.back());
+  ghost->pages_.pop_back();
+}
+
+bool ARCReplacer::RemoveGhost(GhostList *ghost, page_id_t page_id) {
+  auto iter = ghost->index_.find(page_id);
+  if (iter == ghost->index_.end()) {
+    return false;
+  }
+  ghost->pages_.erase(iter->second);
+  ghost->index_.erase(iter);
+  return true;
+}
+
+}  // namespace bustub
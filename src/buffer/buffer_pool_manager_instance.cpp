@@ -12,76 +12,109 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     int numa_node, size_t max_pool_size)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type, numa_node, max_pool_size) {
+}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                                                     DiskManager *disk_manager, LogManager *log_manager)
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type, int numa_node, size_t max_pool_size)
     : pool_size_(pool_size),
+      max_pool_size_(std::max(pool_size, max_pool_size)),
       num_instances_(num_instances),
       instance_index_(instance_index),
-      next_page_id_(instance_index),
       disk_manager_(disk_manager),
-      log_manager_(log_manager) {
+      log_manager_(log_manager),
+      frame_arena_(max_pool_size_, numa_node),
+      page_table_(max_pool_size_) {
   BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
   BUSTUB_ASSERT(
       instance_index < num_instances,
       "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
-  // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  // The frames' data is one consecutive mapping, and their book-keeping a separate array. Both are allocated for the
+  // maximum pool size, but the mapping only takes memory once a frame is used.
+  pages_ = new Page[max_pool_size_];
+  io_cv_ = new std::condition_variable[max_pool_size_];
+  pinned_since_ = new std::atomic<uint64_t>[max_pool_size_];
+  prefetched_ = new std::atomic<bool>[max_pool_size_];
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      replacer_ = new LRUReplacer(max_pool_size_);
+      break;
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(max_pool_size_);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(max_pool_size_);
+      break;
+    case ReplacerType::ARC:
+      replacer_ = new ARCReplacer(max_pool_size_);
+      break;
+  }
 
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
+  // Initially, every page of the pool is in the free list. Free frames have a pin count of -1 so they cannot be
+  // pinned through a stale page table lookup.
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    if (i < pool_size) {
+      free_list_.emplace_back(static_cast<int>(i));
+    }
+    pages_[i].data_ = frame_arena_.GetFrame(static_cast<frame_id_t>(i));
     pages_[i].page_id_ = INVALID_PAGE_ID;
     pages_[i].is_dirty_ = false;
-    pages_[i].pin_count_ = 0;
+    pages_[i].pin_count_ = -1;
+    pinned_since_[i] = 0;
+    prefetched_[i] = false;
   }
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
+  StopBackgroundWriter();
+  // Prefetch completions still reference the frames.
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    prefetch_cv_.wait(lock, [this] { return prefetches_in_flight_ == 0; });
+  }
   delete[] pages_;
+  delete[] io_cv_;
+  delete[] pinned_since_;
+  delete[] prefetched_;
   delete replacer_;
 }
 
 bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
   // Make sure you call DiskManager::WritePage!
-  frame_id_t frame_id;
-  std::lock_guard<std::mutex> guard(latch_);
+  std::unique_lock<std::mutex> lock = LockLatch();
   ValidatePageId(page_id);
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    frame_id = iter->second;
-    pages_[frame_id].RLatch();
-    if (pages_[frame_id].is_dirty_) {
-      disk_manager_->WritePage(page_id, pages_[frame_id].data_);
-    }
-    pages_[frame_id].is_dirty_ = false;
-    pages_[frame_id].RUnlatch();
-    return true;
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    return false;
   }
-  return false;
+  if (pages_[frame_id].is_dirty_) {
+    WriteBackFrames(&lock, {frame_id});
+  }
+  return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
   // You can do it!
-  frame_id_t frame_id;
-  std::lock_guard<std::mutex> guard(latch_);
-  for (auto iter : page_table_) {
-    frame_id = iter.second;
-    pages_[frame_id].RLatch();
-    if (pages_->IsDirty()) {
-      disk_manager_->WritePage(iter.first, pages_[frame_id].GetData());
-      pages_->is_dirty_ = false;
+  std::unique_lock<std::mutex> lock = LockLatch();
+  std::vector<frame_id_t> dirty_frames;
+  for (size_t i = 0; i < max_pool_size_; ++i) {
+    if (pages_[i].page_id_ != INVALID_PAGE_ID && pages_[i].is_dirty_) {
+      dirty_frames.push_back(static_cast<frame_id_t>(i));
     }
-    pages_[frame_id].RUnlatch();
   }
+  WriteBackFrames(&lock, dirty_frames);
 }
 
 Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
@@ -90,35 +123,32 @@ Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
   // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
   // 3.   Update P's metadata, zero out memory and add P to the page table.
   // 4.   Set the page ID output parameter. Return a pointer to P.
-  frame_id_t frame_id;
-  std::lock_guard<std::mutex> guard(latch_);
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    goto found;
+  std::unique_lock<std::mutex> lock = LockLatch();
+  return NewPageLocked(&lock, page_id);
+}
+
+Page *BufferPoolManagerInstance::TryNewPage(page_id_t *page_id) {
+  *page_id = INVALID_PAGE_ID;
+  if (out_of_frames_.load(std::memory_order_relaxed)) {
+    return nullptr;
   }
-  if (replacer_->Victim(&frame_id)) {
-    page_id_t victim_page_id = pages_[frame_id].GetPageId();
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(victim_page_id, pages_[frame_id].GetData());
-      pages_[frame_id].is_dirty_ = false;
-    }
-    page_table_.erase(victim_page_id);
-    goto found;
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  if (!lock.owns_lock()) {
+    return nullptr;
   }
-  *page_id = INVALID_PAGE_ID;
-  return nullptr;
-found:
-  page_id_t pid = AllocatePage();
-  Page *page = pages_ + frame_id;
-  page_table_[pid] = frame_id;
-  page->ResetMemory();
-  page->is_dirty_ = false;
-  page->page_id_ = pid;
-  page->pin_count_ = 1;
-  *page_id = pid;
-  replacer_->Pin(frame_id);
-  return page;
+  stats_.RecordLatchWait(0);
+  return NewPageLocked(&lock, page_id);
+}
+
+Page *BufferPoolManagerInstance::NewPageLocked(std::unique_lock<std::mutex> *lock, page_id_t *page_id) {
+  frame_id_t frame_id;
+  if (!FindFreeFrame(&frame_id)) {
+    *page_id = INVALID_PAGE_ID;
+    return nullptr;
+  }
+  *page_id = AllocatePage();
+  stats_.RecordNewPage();
+  return LoadPage(lock, frame_id, *page_id, false);
 }
 
 Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
@@ -131,41 +161,50 @@ Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
   // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
   ValidatePageId(page_id);
   frame_id_t frame_id;
-  std::lock_guard<std::mutex> guard(latch_);
-  ValidatePageId(page_id);
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    frame_id = iter->second;
-    goto found;
-  }
-  if (!free_list_.empty()) {
-    frame_id = free_list_.front();
-    free_list_.pop_front();
-    pages_[frame_id].ResetMemory();
-    disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
-    pages_[frame_id].is_dirty_ = false;
-    goto found;
+  // A hit only needs a lock-free lookup and an atomic pin. latch_ is taken on a miss, or to wait for P's I/O.
+  if (page_table_.Find(page_id, &frame_id) && TryPinFrame(frame_id, page_id)) {
+    stats_.RecordHit();
+    ClearPrefetched(frame_id);
+    Page *page = pages_ + frame_id;
+    if (page->io_in_progress_) {
+      stats_.RecordPinWait();
+      std::unique_lock<std::mutex> lock = LockLatch();
+      io_cv_[frame_id].wait(lock, [page] { return !page->io_in_progress_; });
+    }
+    return page;
   }
-  if (replacer_->Victim(&frame_id)) {
-    page_id_t victim_id = pages_[frame_id].GetPageId();
-    if (pages_[frame_id].IsDirty()) {
-      disk_manager_->WritePage(victim_id, pages_[frame_id].GetData());
+
+  std::unique_lock<std::mutex> lock = LockLatch();
+  while (true) {
+    if (page_table_.Find(page_id, &frame_id)) {
+      stats_.RecordHit();
+      ClearPrefetched(frame_id);
+      Page *page = pages_ + frame_id;
+      if (page->pin_count_++ == 0) {
+        StartPinInterval(frame_id);
+        replacer_->Pin(frame_id);
+      }
+      // Another thread may still be reading P in. Our pin keeps the frame from being reused while we wait.
+      if (page->io_in_progress_) {
+        stats_.RecordPinWait();
+        io_cv_[frame_id].wait(lock, [page] { return !page->io_in_progress_; });
+      }
+      return page;
     }
-    pages_[frame_id].is_dirty_ = false;
-    pages_[frame_id].ResetMemory();
-    page_table_.erase(victim_id);
-    disk_manager_->ReadPage(page_id, pages_[frame_id].GetData());
-    goto found;
+    auto write_back = write_back_table_.find(page_id);
+    if (write_back == write_back_table_.end()) {
+      break;
+    }
+    // P was just evicted and its dirty contents are not on disk yet. Reading it now would return stale data.
+    stats_.RecordPinWait();
+    io_cv_[write_back->second].wait(lock);
   }
 
-  return nullptr;
-found:
-  Page *page = pages_ + frame_id;
-  page_table_[page_id] = frame_id;
-  page->page_id_ = page_id;
-  ++page->pin_count_;
-  replacer_->Pin(frame_id);
-  return pages_ + frame_id;
+  if (!FindFreeFrame(&frame_id)) {
+    return nullptr;
+  }
+  stats_.RecordMiss();
+  return LoadPage(&lock, frame_id, page_id, true);
 }
 
 bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
@@ -175,47 +214,439 @@ bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
   // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
   // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
   ValidatePageId(page_id);
-  std::lock_guard<std::mutex> guard(latch_);
-  auto iter = page_table_.find(page_id);
-  if (iter == page_table_.end()) {
+  std::unique_lock<std::mutex> lock = LockLatch();
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    // A write-back still in flight would land after the page is deallocated, and possibly allocated again.
+    for (auto write_back = write_back_table_.find(page_id); write_back != write_back_table_.end();
+         write_back = write_back_table_.find(page_id)) {
+      io_cv_[write_back->second].wait(lock);
+    }
+    if (page_table_.Find(page_id, &frame_id)) {
+      lock.unlock();
+      return DeletePgImp(page_id);
+    }
+    lock.unlock();
+    DeallocatePage(page_id);
     return true;
   }
-  frame_id_t frame_id = iter->second;
   Page *page = pages_ + frame_id;
-  if (page->pin_count_ != 0) {
+  int unpinned = 0;
+  if (!page->pin_count_.compare_exchange_strong(unpinned, -1)) {
     return false;
   }
-  DeallocatePage(page_id);
-  page_table_.erase(iter);
+  ClearPrefetched(frame_id);
+  page_table_.Remove(page_id);
   page->page_id_ = INVALID_PAGE_ID;
   page->is_dirty_ = false;
   page->ResetMemory();
-  replacer_->Unpin(frame_id);
-  free_list_.emplace_back(frame_id);
+  replacer_->Pin(frame_id);
+  replacer_->SetFramePage(frame_id, INVALID_PAGE_ID);
+  // A frame being removed by Resize is left out of the free list.
+  if (static_cast<size_t>(frame_id) < pool_size_) {
+    free_list_.emplace_back(frame_id);
+    ClearOutOfFrames();
+  }
+  // The page is out of the buffer pool, so updating the free page map and file need not hold up other requests.
+  lock.unlock();
+  DeallocatePage(page_id);
   return true;
 }
 
 bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
-  std::lock_guard<std::mutex> guard(latch_);
   if (page_id == INVALID_PAGE_ID) {
     return false;
   }
-  auto iter = page_table_.find(page_id);
-  if (iter != page_table_.end()) {
-    frame_id_t frame_id = iter->second;
-    Page *page = pages_ + frame_id;
-    page->is_dirty_ |= is_dirty;
-    if (--page->pin_count_ == 0) {
-      replacer_->Unpin(frame_id);
+  frame_id_t frame_id;
+  // The caller's pin keeps the frame from being reassigned, so a hit can be trusted once the frame's page id matches.
+  // Anything else is settled under latch_.
+  if (!page_table_.Find(page_id, &frame_id) || pages_[frame_id].page_id_ != page_id) {
+    std::unique_lock<std::mutex> lock = LockLatch();
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
     }
+  }
+  Page *page = pages_ + frame_id;
+  int pin_count = page->pin_count_;
+  if (pin_count <= 0) {
+    return false;
+  }
+  // Mark the page dirty before dropping the pin, or it could be evicted without being written back.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1)) {
+    if (pin_count <= 0) {
+      return false;
+    }
+  }
+  if (pin_count == 1) {
+    ReleaseFrame(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = pages_ + frame_id;
+  int pin_count = page->pin_count_;
+  do {
+    // The frame holds no page or is being evicted.
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  if (pin_count == 0) {
+    StartPinInterval(frame_id);
+    replacer_->Pin(frame_id);
+  }
+  // The frame may have been given to another page between the lookup and the pin. Our pin keeps that from
+  // happening from now on, so one check is enough.
+  if (page->page_id_ != page_id) {
+    UnpinFrame(frame_id);
+    return false;
+  }
+  return true;
+}
+
+void BufferPoolManagerInstance::UnpinFrame(frame_id_t frame_id) {
+  if (--pages_[frame_id].pin_count_ == 0) {
+    ReleaseFrame(frame_id);
+  }
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id) {
+  EndPinInterval(frame_id);
+  // Without latch_, the frame can be pinned, or claimed by an eviction or a delete, as soon as its pin count reaches
+  // 0. Whoever pinned it puts it back into the replacer, and a frame that was claimed is taken out again by
+  // SetFramePage when it is reused, so the unpin that comes late only has to be skipped when it can be.
+  if (pages_[frame_id].pin_count_ == 0) {
+    replacer_->Unpin(frame_id);
+  }
+  ClearOutOfFrames();
+  // Resize is waiting for the frame to be unpinned. Signalling under retire_latch_ keeps the wakeup from being lost
+  // between its check of the pin count and its wait.
+  if (retiring_frame_ == frame_id) {
+    std::lock_guard<std::mutex> guard(retire_latch_);
+    retire_cv_.notify_all();
+  }
+}
+
+bool BufferPoolManagerInstance::FindFreeFrame(frame_id_t *frame_id) {
+  if (!free_list_.empty()) {
+    *frame_id = free_list_.front();
+    free_list_.pop_front();
     return true;
   }
+  // A victim may have been pinned since it entered the replacer, by a lock-free hit or by WriteBackFrames, or be a
+  // free frame that a late unpin put back. Claiming it by moving its pin count from 0 to -1 settles the race with
+  // lock-free hits. Skipped frames go back into the replacer when their last pin is dropped.
+  while (replacer_->Victim(frame_id)) {
+    // The frame is being removed by Resize, which will evict its page. It goes back into the replacer if it is
+    // pinned and unpinned in the meantime.
+    if (static_cast<size_t>(*frame_id) >= pool_size_) {
+      continue;
+    }
+    int unpinned = 0;
+    if (pages_[*frame_id].pin_count_.compare_exchange_strong(unpinned, -1)) {
+      return true;
+    }
+  }
+  out_of_frames_.store(true, std::memory_order_relaxed);
   return false;
 }
 
+Page *BufferPoolManagerInstance::LoadPage(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t page_id,
+                                          bool read_page) {
+  Page *page = pages_ + frame_id;
+  page_id_t victim_page_id;
+  ClearPrefetched(frame_id);
+  bool write_back = ReserveFrame(frame_id, page_id, &victim_page_id);
+
+  // The frame is pinned and marked as doing I/O, so nobody else touches its data until we are done.
+  lock->unlock();
+  if (write_back) {
+    disk_manager_->WritePage(victim_page_id, page->GetData());
+  }
+  page->ResetMemory();
+  if (read_page) {
+    disk_manager_->ReadPage(page_id, page->GetData());
+  }
+  lock->lock();
+
+  FinishPageIO(frame_id, victim_page_id, write_back);
+  return page;
+}
+
+void BufferPoolManagerInstance::PrefetchPage(page_id_t page_id) {
+  ValidatePageId(page_id);
+  std::unique_lock<std::mutex> lock = LockLatch();
+  // Leave at least three quarters of the pool for pages that are actually being fetched. A prefetched page counts
+  // until it is fetched, not only while it is being read: a synchronous disk manager completes the read before this
+  // call returns.
+  frame_id_t frame_id;
+  if (unfetched_prefetches_ >= pool_size_ / 4 || page_table_.Find(page_id, &frame_id) ||
+      write_back_table_.count(page_id) != 0) {
+    return;
+  }
+  if (!FindFreeFrame(&frame_id)) {
+    return;
+  }
+  // The victim was read ahead and has not been fetched yet. Evicting it would only mean reading it again, so put it
+  // back and give up on this prefetch instead.
+  if (prefetched_[frame_id]) {
+    pages_[frame_id].pin_count_ = 0;
+    replacer_->Unpin(frame_id);
+    return;
+  }
+  // Flag the frame before ReserveFrame publishes it, so that a fetch that gets to it first clears the flag.
+  prefetched_[frame_id] = true;
+  ++unfetched_prefetches_;
+  Page *page = pages_ + frame_id;
+  page_id_t victim_page_id;
+  bool write_back = ReserveFrame(frame_id, page_id, &victim_page_id);
+  ++prefetches_in_flight_;
+  stats_.RecordPrefetch();
+  lock.unlock();
+
+  // The pin taken by ReserveFrame is dropped as soon as the read completes, leaving the page unpinned in the pool.
+  auto read_page = [this, page, frame_id, page_id, victim_page_id, write_back] {
+    disk_manager_->ReadPageAsync(page_id, page->GetData(), [this, frame_id, victim_page_id, write_back] {
+      std::lock_guard<std::mutex> guard(latch_);
+      FinishPageIO(frame_id, victim_page_id, write_back);
+      UnpinFrame(frame_id);
+      if (--prefetches_in_flight_ == 0) {
+        prefetch_cv_.notify_all();
+      }
+    });
+  };
+  if (write_back) {
+    disk_manager_->WritePageAsync(victim_page_id, page->GetData(), read_page);
+  } else {
+    read_page();
+  }
+}
+
+bool BufferPoolManagerInstance::ReserveFrame(frame_id_t frame_id, page_id_t page_id, page_id_t *victim_page_id) {
+  Page *page = pages_ + frame_id;
+  *victim_page_id = page->page_id_;
+  bool write_back = *victim_page_id != INVALID_PAGE_ID && page->is_dirty_;
+  if (*victim_page_id != INVALID_PAGE_ID) {
+    page_table_.Remove(*victim_page_id);
+    if (write_back) {
+      write_back_table_[*victim_page_id] = frame_id;
+      // The background writer is falling behind, don't wait for its next round.
+      writer_cv_.notify_one();
+    }
+    stats_.RecordEviction(write_back);
+  }
+  // The frame's pin count is -1 until now. Publish the pin last, so that a lock-free hit that pins the frame also sees
+  // the new page id and the I/O flag.
+  page->io_in_progress_ = true;
+  page->is_dirty_ = false;
+  page->page_id_ = page_id;
+  page->pin_count_ = 1;
+  StartPinInterval(frame_id);
+  page_table_.Insert(page_id, frame_id);
+  replacer_->SetFramePage(frame_id, page_id);
+  replacer_->Pin(frame_id);
+  return write_back;
+}
+
+void BufferPoolManagerInstance::FinishPageIO(frame_id_t frame_id, page_id_t victim_page_id, bool write_back) {
+  if (write_back) {
+    write_back_table_.erase(victim_page_id);
+  }
+  pages_[frame_id].io_in_progress_ = false;
+  io_cv_[frame_id].notify_all();
+}
+
+void BufferPoolManagerInstance::WriteBackFrames(std::unique_lock<std::mutex> *lock, const std::vector<frame_id_t> &frames,
+                                                bool skip_latched) {
+  // Pin the frames so they cannot be evicted while latch_ is dropped. These pins are not reported to the replacer,
+  // so the frames keep their place in the eviction order. The dirty flag is cleared up front: anyone who modifies a
+  // page while it is being written sets it again when they unpin.
+  for (frame_id_t frame_id : frames) {
+    if (++pages_[frame_id].pin_count_ == 1) {
+      StartPinInterval(frame_id);
+    }
+    pages_[frame_id].is_dirty_ = false;
+  }
+  lock->unlock();
+
+  // Copy each page under its own latch, released before the next one is taken, and write the copies. A thread that
+  // holds one page latch while waiting for another never waits on this one, and no latch is held across the writes.
+  std::vector<char> copies(frames.size() * PAGE_SIZE);
+  std::mutex done_latch;
+  std::condition_variable done_cv;
+  size_t remaining = frames.size();
+  size_t written = 0;
+  for (size_t i = 0; i < frames.size(); ++i) {
+    Page *page = pages_ + frames[i];
+    char *copy = &copies[i * PAGE_SIZE];
+    if (skip_latched && !page->TryRLatch()) {
+      // Someone is writing to the page. It is still dirty, and is left for a later round.
+      page->is_dirty_ = true;
+      std::lock_guard<std::mutex> guard(done_latch);
+      --remaining;
+      continue;
+    }
+    if (!skip_latched) {
+      page->RLatch();
+    }
+    memcpy(copy, page->GetData(), PAGE_SIZE);
+    page->RUnlatch();
+    // Issue every write before waiting on any of them so the disk manager can keep them all in flight.
+    disk_manager_->WritePageAsync(page->GetPageId(), copy, [&done_latch, &done_cv, &remaining] {
+      std::lock_guard<std::mutex> guard(done_latch);
+      if (--remaining == 0) {
+        done_cv.notify_one();
+      }
+    });
+    ++written;
+  }
+  {
+    std::unique_lock<std::mutex> done_lock(done_latch);
+    done_cv.wait(done_lock, [&remaining] { return remaining == 0; });
+  }
+  stats_.RecordWriteBacks(written);
+
+  lock->lock();
+  for (frame_id_t frame_id : frames) {
+    UnpinFrame(frame_id);
+  }
+}
+
+bool BufferPoolManagerInstance::Resize(size_t pool_size) {
+  if (pool_size == 0 || pool_size > max_pool_size_) {
+    return false;
+  }
+  std::lock_guard<std::mutex> resize_guard(resize_latch_);
+  std::unique_lock<std::mutex> lock = LockLatch();
+  size_t old_pool_size = pool_size_;
+  if (pool_size >= old_pool_size) {
+    for (size_t i = old_pool_size; i < pool_size; ++i) {
+      free_list_.emplace_back(static_cast<frame_id_t>(i));
+    }
+    pool_size_ = pool_size;
+    ClearOutOfFrames();
+    return true;
+  }
+
+  // From now on no page is loaded into the removed frames, so each only has to be emptied once.
+  pool_size_ = pool_size;
+  free_list_.remove_if([pool_size](frame_id_t frame_id) { return static_cast<size_t>(frame_id) >= pool_size; });
+  for (size_t i = pool_size; i < old_pool_size; ++i) {
+    RetireFrame(&lock, static_cast<frame_id_t>(i));
+  }
+  frame_arena_.Release(static_cast<frame_id_t>(pool_size), old_pool_size - pool_size);
+  return true;
+}
+
+void BufferPoolManagerInstance::RetireFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id) {
+  Page *page = pages_ + frame_id;
+  // Claim the frame like FindFreeFrame does, waiting for the page to be unpinned. The unpin that drops its last pin
+  // signals retire_cv_, without latch_, so the wait is on retire_latch_ instead.
+  retiring_frame_ = frame_id;
+  int pin_count = 0;
+  while (!page->pin_count_.compare_exchange_strong(pin_count, -1)) {
+    // The frame is free already.
+    if (pin_count < 0) {
+      break;
+    }
+    lock->unlock();
+    {
+      std::unique_lock<std::mutex> retire_lock(retire_latch_);
+      retire_cv_.wait(retire_lock, [page] { return page->pin_count_ <= 0; });
+    }
+    lock->lock();
+    pin_count = 0;
+  }
+  retiring_frame_ = -1;
+  if (pin_count < 0) {
+    return;
+  }
+
+  page_id_t page_id = page->page_id_;
+  ClearPrefetched(frame_id);
+  replacer_->Pin(frame_id);
+  replacer_->SetFramePage(frame_id, INVALID_PAGE_ID);
+  page_table_.Remove(page_id);
+  page->page_id_ = INVALID_PAGE_ID;
+  stats_.RecordEviction(page->is_dirty_);
+  if (page->is_dirty_) {
+    // Fetches of the page wait for the write to complete, as they do for an evicted page.
+    write_back_table_[page_id] = frame_id;
+    lock->unlock();
+    disk_manager_->WritePage(page_id, page->GetData());
+    lock->lock();
+    write_back_table_.erase(page_id);
+    page->is_dirty_ = false;
+    io_cv_[frame_id].notify_all();
+  }
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter(size_t clean_target) {
+  std::lock_guard<std::mutex> guard(latch_);
+  writer_clean_target_ = clean_target;
+  if (writer_thread_ == nullptr) {
+    writer_running_ = true;
+    writer_thread_ = new std::thread(&BufferPoolManagerInstance::BackgroundWriterLoop, this);
+  }
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (writer_thread_ == nullptr) {
+      return;
+    }
+    writer_running_ = false;
+  }
+  writer_cv_.notify_one();
+  writer_thread_->join();
+  delete writer_thread_;
+  writer_thread_ = nullptr;
+}
+
+void BufferPoolManagerInstance::BackgroundWriterLoop() {
+  std::unique_lock<std::mutex> lock(latch_);
+  std::vector<frame_id_t> candidates;
+  std::vector<frame_id_t> dirty_frames;
+  while (writer_running_) {
+    replacer_->PeekVictims(writer_clean_target_, &candidates);
+    dirty_frames.clear();
+    for (frame_id_t frame_id : candidates) {
+      const Page &page = pages_[frame_id];
+      if (page.is_dirty_ && page.pin_count_ == 0 && !page.io_in_progress_) {
+        dirty_frames.push_back(frame_id);
+      }
+    }
+    if (dirty_frames.empty()) {
+      writer_cv_.wait_for(lock, background_writer_interval);
+      continue;
+    }
+    // Write the whole batch at once. The frames stay in the replacer and keep their place in the eviction order. A
+    // frame can be pinned and latched by a lock-free hit since it was checked, so pages that are latched are skipped
+    // rather than waited for.
+    WriteBackFrames(&lock, dirty_frames, true);
+  }
+}
+
+std::unique_lock<std::mutex> BufferPoolManagerInstance::LockLatch() {
+  std::unique_lock<std::mutex> lock(latch_, std::try_to_lock);
+  if (lock.owns_lock()) {
+    stats_.RecordLatchWait(0);
+    return lock;
+  }
+  uint64_t start = BufferPoolCounters::Now();
+  lock.lock();
+  // A wait that rounds down to zero still counts as contended.
+  stats_.RecordLatchWait(std::max<uint64_t>(BufferPoolCounters::Now() - start, 1));
+  return lock;
+}
+
 page_id_t BufferPoolManagerInstance::AllocatePage() {
-  const page_id_t next_page_id = next_page_id_;
-  next_page_id_ += num_instances_;
+  const page_id_t next_page_id = disk_manager_->AllocatePage(num_instances_, instance_index_);
   ValidatePageId(next_page_id);
   return next_page_id;
 }
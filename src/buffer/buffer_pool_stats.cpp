@@ -0,0 +1,93 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.cpp
+//
+// Identification: src/buffer/buffer_pool_stats.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_pool_stats.h"
+
+#include <sstream>
+
+namespace bustub {
+
+double BufferPoolStats::HitRatio() const {
+  uint64_t fetches = hits_ + misses_;
+  return fetches == 0 ? 0 : static_cast<double>(hits_) / fetches;
+}
+
+double BufferPoolStats::AveragePinDuration() const {
+  return pin_intervals_ == 0 ? 0 : static_cast<double>(pin_duration_ns_) / pin_intervals_ / 1000;
+}
+
+BufferPoolStats &BufferPoolStats::operator+=(const BufferPoolStats &other) {
+  hits_ += other.hits_;
+  misses_ += other.misses_;
+  new_pages_ += other.new_pages_;
+  prefetches_ += other.prefetches_;
+  clean_evictions_ += other.clean_evictions_;
+  dirty_evictions_ += other.dirty_evictions_;
+  write_backs_ += other.write_backs_;
+  pin_waits_ += other.pin_waits_;
+  for (size_t i = 0; i < LATCH_WAIT_BUCKETS; ++i) {
+    latch_waits_[i] += other.latch_waits_[i];
+  }
+  latch_wait_ns_ += other.latch_wait_ns_;
+  pin_intervals_ += other.pin_intervals_;
+  pin_duration_ns_ += other.pin_duration_ns_;
+  return *this;
+}
+
+std::string BufferPoolStats::ToString() const {
+  std::ostringstream os;
+  os << "hits=" << hits_ << " misses=" << misses_ << " hit_ratio=" << HitRatio() << " new_pages=" << new_pages_
+     << " prefetches=" << prefetches_ << " clean_evictions=" << clean_evictions_
+     << " dirty_evictions=" << dirty_evictions_ << " write_backs=" << write_backs_ << " pin_waits=" << pin_waits_
+     << " latch_wait_us=" << latch_wait_ns_ / 1000 << " avg_pin_us=" << AveragePinDuration() << " latch_waits=[";
+  for (size_t i = 0; i < LATCH_WAIT_BUCKETS; ++i) {
+    os << (i == 0 ? "" : " ") << latch_waits_[i];
+  }
+  os << "]";
+  return os.str();
+}
+
+void BufferPoolCounters::RecordLatchWait(uint64_t wait_ns) {
+  size_t bucket = 0;
+  if (wait_ns > 0) {
+    // Bucket 1 is for waits under a microsecond, and every following bucket doubles the bound.
+    uint64_t wait_us = wait_ns / 1000;
+    bucket = 1;
+    while (wait_us > 0 && bucket < BufferPoolStats::LATCH_WAIT_BUCKETS - 1) {
+      wait_us >>= 1;
+      ++bucket;
+    }
+    Add(&latch_wait_ns_, wait_ns);
+  }
+  Add(&latch_waits_[bucket], 1);
+}
+
+BufferPoolStats BufferPoolCounters::Snapshot() const {
+  BufferPoolStats stats;
+  stats.hits_ = hits_.load(std::memory_order_relaxed);
+  stats.misses_ = misses_.load(std::memory_order_relaxed);
+  stats.new_pages_ = new_pages_.load(std::memory_order_relaxed);
+  stats.prefetches_ = prefetches_.load(std::memory_order_relaxed);
+  stats.clean_evictions_ = clean_evictions_.load(std::memory_order_relaxed);
+  stats.dirty_evictions_ = dirty_evictions_.load(std::memory_order_relaxed);
+  stats.write_backs_ = write_backs_.load(std::memory_order_relaxed);
+  stats.pin_waits_ = pin_waits_.load(std::memory_order_relaxed);
+  for (size_t i = 0; i < BufferPoolStats::LATCH_WAIT_BUCKETS; ++i) {
+    stats.latch_waits_[i] = latch_waits_[i].load(std::memory_order_relaxed);
+  }
+  stats.latch_wait_ns_ = latch_wait_ns_.load(std::memory_order_relaxed);
+  stats.pin_intervals_ = pin_intervals_.load(std::memory_order_relaxed);
+  stats.pin_duration_ns_ = pin_duration_ns_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+}  // namespace bustub
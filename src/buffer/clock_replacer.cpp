@@ -14,16 +14,72 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages) : num_pages_(num_pages) {
+  in_replacer_ = new std::atomic<bool>[num_pages_];
+  referenced_ = new std::atomic<bool>[num_pages_];
+  for (size_t i = 0; i < num_pages_; ++i) {
+    in_replacer_[i] = false;
+    referenced_[i] = false;
+  }
+}
 
-ClockReplacer::~ClockReplacer() = default;
+ClockReplacer::~ClockReplacer() {
+  delete[] in_replacer_;
+  delete[] referenced_;
+}
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // Two sweeps are enough: the first one clears every reference bit it passes over. Frames that are pinned or
+  // unpinned while the hand moves may need a few more steps, but only while the replacer is not empty.
+  while (size_ > 0) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % num_pages_;
+    if (!in_replacer_[frame] || referenced_[frame].exchange(false)) {
+      continue;
+    }
+    // A concurrent Pin may take the frame out first.
+    if (in_replacer_[frame].exchange(false)) {
+      --size_;
+      *frame_id = static_cast<frame_id_t>(frame);
+      return true;
+    }
+  }
+  *frame_id = INVALID_PAGE_ID;
+  return false;
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  if (in_replacer_[frame_id].exchange(false)) {
+    --size_;
+  }
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  referenced_[frame_id] = true;
+  // Count the frame before it becomes visible, so that a racing Pin or Victim never takes size_ below zero.
+  ++size_;
+  if (in_replacer_[frame_id].exchange(true)) {
+    --size_;
+  }
+}
 
-size_t ClockReplacer::Size() { return 0; }
+void ClockReplacer::SetFramePage(frame_id_t frame_id, page_id_t page_id) { Pin(frame_id); }
+
+void ClockReplacer::PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  frame_ids->clear();
+  // Victim would take the unreferenced frames in hand order first, and then the referenced ones on the next sweep.
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < num_pages_ && frame_ids->size() < count; ++i) {
+      size_t frame = (hand_ + i) % num_pages_;
+      if (in_replacer_[frame] && referenced_[frame] == referenced) {
+        frame_ids->push_back(static_cast<frame_id_t>(frame));
+      }
+    }
+  }
+}
+
+size_t ClockReplacer::Size() { return size_; }
 
 }  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.cpp
+//
+// Identification: src/buffer/frame_arena.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_arena.h"
+
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+/** Memory policy mode of mbind(2) that only allocates from the given nodes, from linux/mempolicy.h. */
+static constexpr int MPOL_BIND_MODE = 2;
+
+static long Mbind(void *addr, size_t len, int mode, const uint64_t *node_mask, uint64_t max_node) {  // NOLINT
+  return syscall(__NR_mbind, addr, len, mode, node_mask, max_node, 0);
+}
+
+FrameArena::FrameArena(size_t num_frames, int numa_node) {
+  size_ = (num_frames * PAGE_SIZE + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  if (size_ == 0) {
+    size_ = HUGE_PAGE_SIZE;
+  }
+
+  void *data = mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+  if (data != MAP_FAILED) {
+    huge_tlb_ = true;
+  } else {
+    // No reserved huge pages. Over-allocate by a huge page and trim, so that the arena is aligned on a huge page
+    // boundary and transparent huge pages can back all of it.
+    size_t mapped_size = size_ + HUGE_PAGE_SIZE;
+    data = mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY,
+                      "can't map the buffer pool frames: " + std::string(strerror(errno)));
+    }
+    auto start = reinterpret_cast<uintptr_t>(data);
+    uintptr_t aligned = (start + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    if (aligned > start) {
+      munmap(data, aligned - start);
+    }
+    if (aligned + size_ < start + mapped_size) {
+      munmap(reinterpret_cast<void *>(aligned + size_), start + mapped_size - aligned - size_);
+    }
+    data = reinterpret_cast<void *>(aligned);
+    madvise(data, size_, MADV_HUGEPAGE);
+  }
+  data_ = static_cast<char *>(data);
+
+  // The policy only applies to pages faulted in after the call, which is all of them: nothing has touched the arena.
+  if (numa_node != NO_NUMA_NODE) {
+    uint64_t node_mask[16] = {};
+    if (numa_node >= 0 && numa_node < static_cast<int>(sizeof(node_mask) * 8)) {
+      node_mask[numa_node / 64] = uint64_t{1} << (numa_node % 64);
+      bound_to_node_ = Mbind(data_, size_, MPOL_BIND_MODE, node_mask, sizeof(node_mask) * 8) == 0;
+    }
+    if (!bound_to_node_) {
+      LOG_WARN("can't bind the buffer pool frames to NUMA node %d", numa_node);
+    }
+  }
+}
+
+FrameArena::~FrameArena() { munmap(data_, size_); }
+
+void FrameArena::Release(frame_id_t first_frame, size_t num_frames) {
+  auto begin = reinterpret_cast<uintptr_t>(GetFrame(first_frame));
+  uintptr_t end = begin + num_frames * PAGE_SIZE;
+  // Explicit huge pages can only be dropped whole.
+  if (huge_tlb_) {
+    begin = (begin + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    end = end / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+  }
+  if (begin < end) {
+    madvise(reinterpret_cast<void *>(begin), end - begin, MADV_DONTNEED);
+  }
+}
+
+int FrameArena::NumNumaNodes() {
+  static const int num_nodes = [] {
+    int count = 0;
+    DIR *dir = opendir("/sys/devices/system/node");
+    if (dir == nullptr) {
+      return 1;
+    }
+    while (dirent *entry = readdir(dir)) {
+      if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(entry->d_name[4]) != 0) {
+        ++count;
+      }
+    }
+    closedir(dir);
+    return count > 0 ? count : 1;
+  }();
+  return num_nodes;
+}
+
+int FrameArena::CurrentNumaNode() {
+  unsigned cpu;
+  unsigned node;
+  if (syscall(__NR_getcpu, &cpu, &node, nullptr) != 0) {
+    return 0;
+  }
+  return static_cast<int>(node);
+}
+
+}  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k, size_t correlated_period)
+    : k_(k), correlated_period_(correlated_period), frames_(num_pages) {
+  BUSTUB_ASSERT(k_ > 0, "LRU-K needs to track at least one reference.");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto *candidates = cold_frames_.empty() ? &hot_frames_ : &cold_frames_;
+  if (candidates->empty()) {
+    *frame_id = INVALID_PAGE_ID;
+    return false;
+  }
+  *frame_id = candidates->begin()->second;
+  candidates->erase(candidates->begin());
+  frames_[*frame_id].evictable_ = false;
+  return true;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  Erase(frame_id);
+  // Every pin is a reference to the page.
+  FrameInfo &frame = frames_[frame_id];
+  ++current_time_;
+  if (frame.history_.empty() || current_time_ - frame.history_.front() > correlated_period_) {
+    frame.history_.push_front(current_time_);
+    if (frame.history_.size() > k_) {
+      frame.history_.pop_back();
+    }
+  }
+  frame.last_access_ = current_time_;
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (!frames_[frame_id].evictable_) {
+    Insert(frame_id);
+  }
+}
+
+void LRUKReplacer::PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  frame_ids->clear();
+  for (const auto *candidates : {&cold_frames_, &hot_frames_}) {
+    for (auto iter = candidates->begin(); iter != candidates->end() && frame_ids->size() < count; ++iter) {
+      frame_ids->push_back(iter->second);
+    }
+  }
+}
+
+void LRUKReplacer::SetFramePage(frame_id_t frame_id, page_id_t page_id) {
+  std::lock_guard<std::mutex> guard(latch_);
+  // An unpin that raced with the frame being claimed may have put it back.
+  Erase(frame_id);
+  FrameInfo &frame = frames_[frame_id];
+
+  // Remember the history of the page the frame held, forgetting the oldest eviction if there are too many.
+  if (frame.page_id_ != INVALID_PAGE_ID && !frame.history_.empty()) {
+    evicted_order_.push_back(frame.page_id_);
+    evicted_history_[frame.page_id_] = {std::move(frame.history_), std::prev(evicted_order_.end())};
+    if (evicted_order_.size() > frames_.size()) {
+      evicted_history_.erase(evicted_order_.front());
+      evicted_order_.pop_front();
+    }
+  }
+
+  frame.page_id_ = page_id;
+  frame.history_.clear();
+  frame.last_access_ = 0;
+  auto iter = evicted_history_.find(page_id);
+  if (iter != evicted_history_.end()) {
+    frame.history_ = std::move(iter->second.first);
+    frame.last_access_ = frame.history_.front();
+    evicted_order_.erase(iter->second.second);
+    evicted_history_.erase(iter);
+  }
+}
+
+size_t LRUKReplacer::Size() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return cold_frames_.size() + hot_frames_.size();
+}
+
+std::pair<size_t, frame_id_t> LRUKReplacer::Key(frame_id_t frame_id) const {
+  const FrameInfo &frame = frames_[frame_id];
+  if (frame.history_.size() < k_) {
+    return {frame.last_access_, frame_id};
+  }
+  return {frame.history_.back(), frame_id};
+}
+
+void LRUKReplacer::Insert(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  frame.evictable_ = true;
+  (frame.history_.size() < k_ ? cold_frames_ : hot_frames_).insert(Key(frame_id));
+}
+
+void LRUKReplacer::Erase(frame_id_t frame_id) {
+  FrameInfo &frame = frames_[frame_id];
+  if (frame.evictable_) {
+    frame.evictable_ = false;
+    (frame.history_.size() < k_ ? cold_frames_ : hot_frames_).erase(Key(frame_id));
+  }
+}
+
+}  // namespace bustub
@@ -47,6 +47,16 @@ void LRUReplacer::Unpin(frame_id_t frame_id) {
   }
 }
 
+void LRUReplacer::SetFramePage(frame_id_t frame_id, page_id_t page_id) { Pin(frame_id); }
+
+void LRUReplacer::PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) {
+  std::lock_guard<std::mutex> guard(latch_);
+  frame_ids->clear();
+  for (auto iter = list_.rbegin(); iter != list_.rend() && frame_ids->size() < count; ++iter) {
+    frame_ids->push_back(*iter);
+  }
+}
+
 size_t LRUReplacer::Size() {
   std::lock_guard<std::mutex> guard(latch_);
   return list_.size();
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) : num_slots_(8), slot_bits_(3) {
+  while (num_slots_ < 2 * num_frames) {
+    num_slots_ <<= 1;
+    ++slot_bits_;
+  }
+  slots_ = new std::atomic<uint64_t>[num_slots_];
+  for (size_t i = 0; i < num_slots_; ++i) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+}
+
+PageTable::~PageTable() { delete[] slots_; }
+
+size_t PageTable::Home(page_id_t page_id) const {
+  // Page ids are handed out sequentially, so scramble them with a multiplicative hash and keep the high bits.
+  uint64_t hash = static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL;
+  return static_cast<size_t>(hash >> (64 - slot_bits_));
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  const size_t mask = num_slots_ - 1;
+  size_t slot = Home(page_id);
+  // Entries can move under a concurrent Remove, so bound the probe rather than rely on reaching an empty slot.
+  for (size_t probes = 0; probes < num_slots_; ++probes, slot = (slot + 1) & mask) {
+    uint64_t entry = slots_[slot].load(std::memory_order_acquire);
+    if (entry == EMPTY_SLOT) {
+      return false;
+    }
+    if (EntryPageId(entry) == page_id) {
+      *frame_id = EntryFrameId(entry);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  const size_t mask = num_slots_ - 1;
+  size_t slot = Home(page_id);
+  while (true) {
+    uint64_t entry = slots_[slot].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT || EntryPageId(entry) == page_id) {
+      slots_[slot].store(MakeEntry(page_id, frame_id), std::memory_order_release);
+      return;
+    }
+    slot = (slot + 1) & mask;
+  }
+}
+
+bool PageTable::Remove(page_id_t page_id) {
+  const size_t mask = num_slots_ - 1;
+  size_t hole = Home(page_id);
+  while (true) {
+    uint64_t entry = slots_[hole].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      return false;
+    }
+    if (EntryPageId(entry) == page_id) {
+      break;
+    }
+    hole = (hole + 1) & mask;
+  }
+
+  // Shift back every later entry of the probe sequence whose home is not between the hole and its current slot. The
+  // hole is overwritten before the moved entry's old slot is, so the slot being vacated is never seen empty early.
+  for (size_t slot = (hole + 1) & mask;; slot = (slot + 1) & mask) {
+    uint64_t entry = slots_[slot].load(std::memory_order_relaxed);
+    if (entry == EMPTY_SLOT) {
+      break;
+    }
+    size_t home = Home(EntryPageId(entry));
+    if (((slot - home) & mask) >= ((slot - hole) & mask)) {
+      slots_[hole].store(entry, std::memory_order_release);
+      hole = slot;
+    }
+  }
+  slots_[hole].store(EMPTY_SLOT, std::memory_order_release);
+  return true;
+}
+
+}  // namespace bustub
@@ -15,12 +15,19 @@
 namespace bustub {
 
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : num_instances_(num_instances), pool_size_(pool_size), current_index_(0) {
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     bool numa_aware, size_t max_pool_size)
+    : num_instances_(num_instances), next_instance_(0) {
   // Allocate and create individual BufferPoolManagerInstances
   instances_ = std::vector<BufferPoolManagerInstance *>(0);
   for (size_t i = 0; i < num_instances; ++i) {
-    instances_.emplace_back(new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager));
+    int numa_node = NO_NUMA_NODE;
+    if (numa_aware) {
+      numa_node = static_cast<int>(i % FrameArena::NumNumaNodes());
+      instance_nodes_.push_back(numa_node);
+    }
+    instances_.emplace_back(new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager,
+                                                          replacer_type, numa_node, max_pool_size));
   }
 }
 
@@ -33,7 +40,22 @@ ParallelBufferPoolManager::~ParallelBufferPoolManager() {
 
 size_t ParallelBufferPoolManager::GetPoolSize() {
   // Get size of all BufferPoolManagerInstances
-  return num_instances_ * pool_size_;
+  size_t pool_size = 0;
+  for (auto iter : instances_) {
+    pool_size += iter->GetPoolSize();
+  }
+  return pool_size;
+}
+
+bool ParallelBufferPoolManager::Resize(size_t pool_size) {
+  if (pool_size == 0 || pool_size > instances_[0]->GetMaxPoolSize()) {
+    return false;
+  }
+  // Each instance keeps serving while it is resized, and the others are not affected.
+  for (auto iter : instances_) {
+    iter->Resize(pool_size);
+  }
+  return true;
 }
 
 BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
@@ -41,6 +63,31 @@ BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t pag
   return instances_[page_id % num_instances_];
 }
 
+void ParallelBufferPoolManager::PrefetchPage(page_id_t page_id) {
+  BufferPoolManager *bpm = GetBufferPoolManager(page_id);
+  bpm->PrefetchPage(page_id);
+}
+
+void ParallelBufferPoolManager::RunBackgroundWriter(size_t clean_target) {
+  for (auto iter : instances_) {
+    iter->RunBackgroundWriter(clean_target);
+  }
+}
+
+void ParallelBufferPoolManager::StopBackgroundWriter() {
+  for (auto iter : instances_) {
+    iter->StopBackgroundWriter();
+  }
+}
+
+BufferPoolStats ParallelBufferPoolManager::GetStats() {
+  BufferPoolStats stats;
+  for (auto iter : instances_) {
+    stats += iter->GetStats();
+  }
+  return stats;
+}
+
 Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
   // Fetch page for page_id from responsible BufferPoolManagerInstance
   BufferPoolManager *bpm = GetBufferPoolManager(page_id);
@@ -66,14 +113,36 @@ Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
   // starting index and return nullptr
   // 2.   Bump the starting index (mod number of instances) to start search at a different BPMI each time this function
   // is called
-  std::lock_guard<std::mutex> guard(latch_);
+  // The starting index is taken from an atomic cursor, so concurrent callers start at different instances without a
+  // shared latch. A first pass skips the instances that are busy or full rather than queue behind their latch; only
+  // if it finds nothing does a second pass wait on each instance in turn.
+  size_t start = next_instance_.fetch_add(1, std::memory_order_relaxed);
+  // The new page's id ties it to the instance that creates it, so creating it on the caller's node keeps the accesses
+  // that follow, by the same thread, local.
+  if (!instance_nodes_.empty()) {
+    int numa_node = FrameArena::CurrentNumaNode();
+    for (size_t i = 0; i < num_instances_; ++i) {
+      size_t index = (start + i) % num_instances_;
+      if (instance_nodes_[index] != numa_node) {
+        continue;
+      }
+      Page *page = instances_[index]->TryNewPage(page_id);
+      if (page != nullptr) {
+        return page;
+      }
+    }
+  }
+  for (size_t i = 0; i < num_instances_; ++i) {
+    Page *page = instances_[(start + i) % num_instances_]->TryNewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
   for (size_t i = 0; i < num_instances_; ++i) {
-    BufferPoolManager *bpm = GetBufferPoolManager(current_index_);
-    Page *page = bpm->NewPage(page_id);
+    Page *page = instances_[(start + i) % num_instances_]->NewPage(page_id);
     if (page != nullptr) {
       return page;
     }
-    ++current_index_;
   }
   return nullptr;
 }
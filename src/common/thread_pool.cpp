@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.cpp
+//
+// Identification: src/common/thread_pool.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "common/thread_pool.h"
+
+#include <utility>
+
+namespace bustub {
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> guard(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+  std::lock_guard<std::mutex> guard(latch_);
+  tasks_.push_back(std::move(task));
+  if (num_idle_ >= tasks_.size()) {
+    cv_.notify_one();
+  } else {
+    threads_.emplace_back(&ThreadPool::Work, this);
+  }
+}
+
+size_t ThreadPool::GetNumThreads() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return threads_.size();
+}
+
+void ThreadPool::Work() {
+  std::unique_lock<std::mutex> lock(latch_);
+  while (true) {
+    num_idle_++;
+    cv_.wait(lock, [this] { return shutdown_ || !tasks_.empty(); });
+    num_idle_--;
+    // The tasks left are run before the pool stops.
+    if (tasks_.empty()) {
+      return;
+    }
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
+
+}  // namespace bustub
@@ -129,6 +129,71 @@ bool HASH_TABLE_TYPE::Insert(Transaction *transaction, const KeyType &key, const
   return success;
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+size_t HASH_TABLE_TYPE::BulkInsert(Transaction *transaction,
+                                   const std::vector<std::pair<KeyType, ValueType>> &entries) {
+  std::vector<std::pair<KeyType, ValueType>> overflow;
+  size_t inserted = 0;
+  table_latch_.WLock();
+  HashTableDirectoryPage *directory_page = FetchDirectoryPage();
+  page_id_t first_bucket_page_id = directory_page->GetBucketPageId(0);
+  Page *first_page = FetchBucketPage(first_bucket_page_id);
+  bool empty = directory_page->GetGlobalDepth() == 0 && GetBucketData(first_page)->IsEmpty();
+  if (!empty) {
+    buffer_pool_manager_->UnpinPage(first_bucket_page_id, false);
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    table_latch_.WUnlock();
+    for (const auto &entry : entries) {
+      inserted += Insert(transaction, entry.first, entry.second) ? 1 : 0;
+    }
+    return inserted;
+  }
+
+  /* pick the smallest depth that leaves the buckets about three quarters full */
+  uint32_t depth = 0;
+  while ((static_cast<size_t>(BUCKET_ARRAY_SIZE) * 3 / 4 << depth) < entries.size() &&
+         (static_cast<size_t>(1) << (depth + 1)) <= DIRECTORY_ARRAY_SIZE) {
+    ++depth;
+  }
+  uint32_t mask = (1U << depth) - 1;
+  std::vector<std::vector<uint32_t>> partitions(1U << depth);
+  for (uint32_t i = 0; i < entries.size(); ++i) {
+    partitions[Hash(entries[i].first) & mask].push_back(i);
+  }
+  for (uint32_t d = 0; d < depth; ++d) {
+    directory_page->IncrGlobalDepth();
+  }
+  for (uint32_t bucket_idx = 0; bucket_idx < partitions.size(); ++bucket_idx) {
+    page_id_t bucket_page_id = first_bucket_page_id;
+    Page *page = first_page;
+    if (bucket_idx != 0) {
+      page = buffer_pool_manager_->NewPage(&bucket_page_id);
+      assert(page != nullptr);
+    }
+    page->WLatch();
+    HASH_TABLE_BUCKET_TYPE *bucket_page = GetBucketData(page);
+    for (uint32_t i : partitions[bucket_idx]) {
+      if (bucket_page->Insert(entries[i].first, entries[i].second, comparator_)) {
+        ++inserted;
+      } else if (bucket_page->IsFull()) {
+        overflow.push_back(entries[i]);
+      }
+    }
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+    directory_page->SetBucketPageId(bucket_idx, bucket_page_id);
+    directory_page->SetLocalDepth(bucket_idx, depth);
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  table_latch_.WUnlock();
+
+  /* skewed buckets split as usual */
+  for (const auto &entry : overflow) {
+    inserted += Insert(transaction, entry.first, entry.second) ? 1 : 0;
+  }
+  return inserted;
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 bool HASH_TABLE_TYPE::SplitInsert(Transaction *transaction, const KeyType &key, const ValueType &value) {
   table_latch_.WLock();
@@ -23,39 +23,43 @@ AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const Aggreg
       plan_(plan),
       child_(std::move(child)),
       aht_(plan_->GetAggregates(), plan_->GetAggregateTypes()),
-      aht_iterator_(aht_.Begin()) {}
+      aht_iterator_(aht_.Begin()) {
+  if (plan_->GetHaving() != nullptr) {
+    having_ = std::make_unique<CompiledExpression>(plan_->GetHaving());
+  }
+}
 
 void AggregationExecutor::Init() {
   child_->Init();
-  Tuple tuple;
-  RID rid;
-  while (child_->Next(&tuple, &rid)) {
-    aht_.InsertCombine(MakeAggregateKey(&tuple), MakeAggregateValue(&tuple));
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (size_t i = 0; i < batch.Size(); i++) {
+      uint32_t row = batch.GetRow(i);
+      aht_.InsertCombine(MakeAggregateKey(&batch, row), MakeAggregateValue(&batch, row));
+    }
   }
   aht_iterator_ = aht_.Begin();
+  ResetBatch();
 }
 
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
-  while (aht_iterator_ != aht_.End()) {
-    if (plan_->GetHaving() != nullptr) {
-      if (!plan_->GetHaving()
-               ->EvaluateAggregate(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_)
-               .GetAs<bool>()) {
-        ++aht_iterator_;
-        continue;
-      }
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  batch->Init(plan_->OutputSchema());
+  const auto &columns = plan_->OutputSchema()->GetColumns();
+  for (; aht_iterator_ != aht_.End() && !batch->IsFull(); ++aht_iterator_) {
+    const auto &group_bys = aht_iterator_.Key().group_bys_;
+    const auto &aggregates = aht_iterator_.Val().aggregates_;
+    if (having_ != nullptr && having_->EvaluateAggregate(group_bys, aggregates) != CmpBool::CmpTrue) {
+      continue;
     }
-    std::vector<Value> values;
-    for (auto &col : plan_->OutputSchema()->GetColumns()) {
-      auto expr = reinterpret_cast<const AggregateValueExpression *>(col.GetExpr());
-      values.push_back(expr->EvaluateAggregate(aht_iterator_.Key().group_bys_, aht_iterator_.Val().aggregates_));
+    for (uint32_t col_idx = 0; col_idx < columns.size(); col_idx++) {
+      auto expr = reinterpret_cast<const AggregateValueExpression *>(columns[col_idx].GetExpr());
+      batch->AppendValue(col_idx, expr->EvaluateAggregate(group_bys, aggregates));
     }
-    *tuple = Tuple(values, plan_->OutputSchema());
-    *rid = tuple->GetRid();
-    ++aht_iterator_;
-    return true;
+    batch->FinishRow(RID{});
   }
-  return false;
+  return !batch->IsEmpty();
 }
 
 const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
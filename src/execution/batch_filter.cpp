@@ -0,0 +1,152 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_filter.cpp
+//
+// Identification: src/execution/batch_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/batch_filter.h"
+
+#include <utility>
+
+#include "common/exception.h"
+#include "common/macros.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+
+namespace bustub {
+
+/** @return the comparison that gives the same result with its operands swapped */
+static ComparisonType Mirror(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+static bool IsInteger(TypeId type_id) {
+  return type_id == TypeId::TINYINT || type_id == TypeId::SMALLINT || type_id == TypeId::INTEGER ||
+         type_id == TypeId::BIGINT;
+}
+
+/**
+ * Cast a constant to the type of the column it is compared with, if the comparison gives the same result.
+ * @return false if it does not
+ */
+static bool CastConstant(const Value &constant, TypeId type_id, Value *out) {
+  if (constant.GetTypeId() == type_id) {
+    *out = constant;
+    return true;
+  }
+  // An integer compares with an integer column as the column's type does, as long as it fits in it.
+  if (!IsInteger(constant.GetTypeId()) || !IsInteger(type_id) || constant.IsNull()) {
+    return false;
+  }
+  try {
+    *out = constant.CastAs(type_id);
+  } catch (Exception &e) {
+    return false;
+  }
+  return true;
+}
+
+BatchFilter::BatchFilter(const AbstractExpression *predicate, const Schema *schema)
+    : root_(Compile(predicate, schema)) {}
+
+void BatchFilter::Evaluate(const TupleBatch &batch, SelectionBitmap *out) {
+  BUSTUB_ASSERT(!batch.HasSelection(), "A filter evaluates every row of a batch.");
+  Evaluate(root_.get(), batch, out);
+}
+
+std::unique_ptr<BatchFilter::Node> BatchFilter::Compile(const AbstractExpression *expr, const Schema *schema) {
+  auto node = std::make_unique<Node>();
+  if (auto logic = dynamic_cast<const LogicExpression *>(expr); logic != nullptr) {
+    node->type_ = logic->GetLogicType() == LogicType::And ? NodeType::And : NodeType::Or;
+    node->left_ = Compile(expr->GetChildAt(0), schema);
+    node->right_ = Compile(expr->GetChildAt(1), schema);
+    return node;
+  }
+  node->type_ = NodeType::Row;
+
+  auto comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  const ColumnValueExpression *left_col = nullptr;
+  const AbstractExpression *rhs = nullptr;
+  ComparisonType comp_type = ComparisonType::Equal;
+  if (comparison != nullptr) {
+    comp_type = comparison->GetComparisonType();
+    const AbstractExpression *lhs = expr->GetChildAt(0);
+    rhs = expr->GetChildAt(1);
+    // Keep a column on the left.
+    if (dynamic_cast<const ColumnValueExpression *>(lhs) == nullptr) {
+      std::swap(lhs, rhs);
+      comp_type = Mirror(comp_type);
+    }
+    left_col = dynamic_cast<const ColumnValueExpression *>(lhs);
+  }
+
+  TypeId type_id = left_col != nullptr ? schema->GetColumn(left_col->GetColIdx()).GetType() : TypeId::INVALID;
+  if (FilterKernels::IsSupported(type_id)) {
+    auto right_col = dynamic_cast<const ColumnValueExpression *>(rhs);
+    auto right_constant = dynamic_cast<const ConstantValueExpression *>(rhs);
+    if (right_col != nullptr && schema->GetColumn(right_col->GetColIdx()).GetType() == type_id) {
+      node->type_ = NodeType::ColumnColumn;
+      node->right_col_idx_ = right_col->GetColIdx();
+    } else if (right_constant != nullptr &&
+               CastConstant(right_constant->Evaluate(nullptr, nullptr), type_id, &node->constant_)) {
+      node->type_ = NodeType::ColumnConstant;
+    }
+    node->comp_type_ = comp_type;
+    node->left_col_idx_ = left_col->GetColIdx();
+  }
+  if (node->type_ == NodeType::Row) {
+    node->compiled_ = std::make_unique<CompiledExpression>(expr, schema);
+  }
+  return node;
+}
+
+void BatchFilter::Evaluate(Node *node, const TupleBatch &batch, SelectionBitmap *out) {
+  switch (node->type_) {
+    case NodeType::ColumnConstant:
+      FilterKernels::CompareConstant(node->comp_type_, batch.GetColumn(node->left_col_idx_), node->constant_, out);
+      return;
+    case NodeType::ColumnColumn:
+      FilterKernels::CompareColumns(node->comp_type_, batch.GetColumn(node->left_col_idx_),
+                                    batch.GetColumn(node->right_col_idx_), out);
+      return;
+    case NodeType::And:
+    case NodeType::Or:
+      // A null operand has its bit clear like a false one, which selects the rows for which AND or OR is true.
+      Evaluate(node->left_.get(), batch, out);
+      Evaluate(node->right_.get(), batch, &node->right_bitmap_);
+      if (node->type_ == NodeType::And) {
+        out->And(node->right_bitmap_);
+      } else {
+        out->Or(node->right_bitmap_);
+      }
+      return;
+    case NodeType::Row:
+      out->Reset(batch.Size());
+      for (uint32_t row = 0; row < batch.Size(); row++) {
+        if (node->compiled_->EvaluateInBatch(&batch, row) == CmpBool::CmpTrue) {
+          out->Set(row);
+        }
+      }
+      return;
+  }
+}
+
+}  // namespace bustub
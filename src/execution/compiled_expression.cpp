@@ -0,0 +1,420 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.cpp
+//
+// Identification: src/execution/compiled_expression.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_expression.h"
+
+#include "common/macros.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+/** The rows of a program run on a row of a batch. */
+struct BatchSource {
+  template <typename T>
+  T Column(uint32_t tuple_idx, uint32_t col_idx) const {
+    return batch_->GetColumn(col_idx).GetData<T>()[row_];
+  }
+  const Value &Term(bool is_group_by_term, uint32_t term_idx) const {
+    UNREACHABLE("A batch has no group-by or aggregate terms.");
+  }
+  Value Interpret(const AbstractExpression *expr) const { return expr->EvaluateInBatch(batch_, row_); }
+
+  const TupleBatch *batch_;
+  uint32_t row_;
+};
+
+/** The rows of a program run on a pair of rows of a join. */
+struct JoinSource {
+  template <typename T>
+  T Column(uint32_t tuple_idx, uint32_t col_idx) const {
+    return tuple_idx == 0 ? left_batch_->GetColumn(col_idx).GetData<T>()[left_row_]
+                          : right_batch_->GetColumn(col_idx).GetData<T>()[right_row_];
+  }
+  const Value &Term(bool is_group_by_term, uint32_t term_idx) const {
+    UNREACHABLE("A join has no group-by or aggregate terms.");
+  }
+  Value Interpret(const AbstractExpression *expr) const {
+    return expr->EvaluateJoinInBatch(left_batch_, left_row_, right_batch_, right_row_);
+  }
+
+  const TupleBatch *left_batch_;
+  uint32_t left_row_;
+  const TupleBatch *right_batch_;
+  uint32_t right_row_;
+};
+
+/** The terms of a program run on a group of an aggregation. */
+struct AggregateSource {
+  template <typename T>
+  T Column(uint32_t tuple_idx, uint32_t col_idx) const {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+  const Value &Term(bool is_group_by_term, uint32_t term_idx) const {
+    return is_group_by_term ? (*group_bys_)[term_idx] : (*aggregates_)[term_idx];
+  }
+  Value Interpret(const AbstractExpression *expr) const { return expr->EvaluateAggregate(*group_bys_, *aggregates_); }
+
+  const std::vector<Value> *group_bys_;
+  const std::vector<Value> *aggregates_;
+};
+
+template <typename T>
+static bool CompareValues(ComparisonType comp_type, T left, T right) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return left == right;
+    case ComparisonType::NotEqual:
+      return left != right;
+    case ComparisonType::LessThan:
+      return left < right;
+    case ComparisonType::LessThanOrEqual:
+      return left <= right;
+    case ComparisonType::GreaterThan:
+      return left > right;
+    case ComparisonType::GreaterThanOrEqual:
+      return left >= right;
+  }
+  UNREACHABLE("Unknown comparison type.");
+}
+
+CompiledExpression::CompiledExpression(const AbstractExpression *expr, const Schema *left_schema,
+                                       const Schema *right_schema)
+    : left_schema_(left_schema), right_schema_(right_schema) {
+  int64_t result = Compile(expr);
+  BUSTUB_ASSERT(result >= 0 && register_classes_[result] == RegisterClass::Boolean, "Expected a boolean expression.");
+  result_ = static_cast<uint32_t>(result);
+}
+
+CmpBool CompiledExpression::EvaluateInBatch(const TupleBatch *batch, uint32_t row) {
+  return Run(BatchSource{batch, row});
+}
+
+CmpBool CompiledExpression::EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row,
+                                                const TupleBatch *right_batch, uint32_t right_row) {
+  return Run(JoinSource{left_batch, left_row, right_batch, right_row});
+}
+
+CmpBool CompiledExpression::EvaluateAggregate(const std::vector<Value> &group_bys,
+                                              const std::vector<Value> &aggregates) {
+  return Run(AggregateSource{&group_bys, &aggregates});
+}
+
+int64_t CompiledExpression::Compile(const AbstractExpression *expr) {
+  RegisterClass register_class;
+  if (auto constant = dynamic_cast<const ConstantValueExpression *>(expr); constant != nullptr) {
+    Value value = constant->Evaluate(nullptr, nullptr);
+    if (!GetRegisterClass(value.GetTypeId(), &register_class)) {
+      return -1;
+    }
+    uint32_t reg = NewRegister(register_class);
+    Unbox(value, &registers_[reg]);
+    return reg;
+  }
+
+  if (auto column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+    const Schema *schema = right_schema_ != nullptr && column->GetTupleIdx() != 0 ? right_schema_ : left_schema_;
+    if (schema == nullptr) {
+      return CompileInterpret(expr);
+    }
+    TypeId type_id = schema->GetColumn(column->GetColIdx()).GetType();
+    if (!GetRegisterClass(type_id, &register_class)) {
+      return -1;
+    }
+    Instruction instruction;
+    switch (type_id) {
+      case TypeId::BOOLEAN:
+        instruction.op_ = OpCode::LoadBoolean;
+        break;
+      case TypeId::TINYINT:
+        instruction.op_ = OpCode::LoadTinyint;
+        break;
+      case TypeId::SMALLINT:
+        instruction.op_ = OpCode::LoadSmallint;
+        break;
+      case TypeId::INTEGER:
+        instruction.op_ = OpCode::LoadInteger;
+        break;
+      case TypeId::BIGINT:
+        instruction.op_ = OpCode::LoadBigint;
+        break;
+      case TypeId::DECIMAL:
+        instruction.op_ = OpCode::LoadDecimal;
+        break;
+      default:
+        instruction.op_ = OpCode::LoadTimestamp;
+        break;
+    }
+    instruction.out_ = NewRegister(register_class);
+    instruction.left_ = column->GetTupleIdx();
+    instruction.right_ = column->GetColIdx();
+    program_.push_back(instruction);
+    return instruction.out_;
+  }
+
+  if (auto term = dynamic_cast<const AggregateValueExpression *>(expr); term != nullptr) {
+    if (!GetRegisterClass(expr->GetReturnType(), &register_class)) {
+      return -1;
+    }
+    Instruction instruction;
+    instruction.op_ = OpCode::LoadTerm;
+    instruction.type_id_ = expr->GetReturnType();
+    instruction.out_ = NewRegister(register_class);
+    instruction.left_ = term->IsGroupByTerm() ? 1 : 0;
+    instruction.right_ = term->GetTermIdx();
+    program_.push_back(instruction);
+    return instruction.out_;
+  }
+
+  auto comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  auto logic = dynamic_cast<const LogicExpression *>(expr);
+  if (comparison == nullptr && logic == nullptr) {
+    return CompileInterpret(expr);
+  }
+
+  // If the operands do not fit the instructions, drop what they added and evaluate the whole node instead.
+  size_t program_size = program_.size();
+  size_t num_registers = registers_.size();
+  int64_t left = Compile(expr->GetChildAt(0));
+  int64_t right = Compile(expr->GetChildAt(1));
+  bool supported = false;
+  Instruction instruction;
+  if (left >= 0 && right >= 0) {
+    RegisterClass left_class = register_classes_[left];
+    RegisterClass right_class = register_classes_[right];
+    if (logic != nullptr) {
+      supported = left_class == RegisterClass::Boolean && right_class == RegisterClass::Boolean;
+      instruction.op_ = logic->GetLogicType() == LogicType::And ? OpCode::And : OpCode::Or;
+    } else if (left_class == right_class) {
+      supported = true;
+      instruction.op_ = left_class == RegisterClass::Decimal     ? OpCode::CompareDecimal
+                        : left_class == RegisterClass::Timestamp ? OpCode::CompareTimestamp
+                                                                 : OpCode::CompareInteger;
+    } else if (left_class == RegisterClass::Integer && right_class == RegisterClass::Decimal) {
+      supported = true;
+      left = ToDecimal(left);
+      instruction.op_ = OpCode::CompareDecimal;
+    } else if (left_class == RegisterClass::Decimal && right_class == RegisterClass::Integer) {
+      supported = true;
+      right = ToDecimal(right);
+      instruction.op_ = OpCode::CompareDecimal;
+    }
+  }
+  if (!supported) {
+    program_.resize(program_size);
+    registers_.resize(num_registers);
+    register_classes_.resize(num_registers);
+    return CompileInterpret(expr);
+  }
+  if (comparison != nullptr) {
+    instruction.comp_type_ = comparison->GetComparisonType();
+  }
+  instruction.out_ = NewRegister(RegisterClass::Boolean);
+  instruction.left_ = left;
+  instruction.right_ = right;
+  program_.push_back(instruction);
+  return instruction.out_;
+}
+
+uint32_t CompiledExpression::NewRegister(RegisterClass register_class) {
+  registers_.emplace_back();
+  registers_.back().integer_ = 0;
+  registers_.back().is_null_ = false;
+  register_classes_.push_back(register_class);
+  return registers_.size() - 1;
+}
+
+uint32_t CompiledExpression::ToDecimal(uint32_t reg) {
+  Instruction instruction;
+  instruction.op_ = OpCode::IntegerToDecimal;
+  instruction.out_ = NewRegister(RegisterClass::Decimal);
+  instruction.left_ = reg;
+  program_.push_back(instruction);
+  return instruction.out_;
+}
+
+int64_t CompiledExpression::CompileInterpret(const AbstractExpression *expr) {
+  RegisterClass register_class;
+  if (!GetRegisterClass(expr->GetReturnType(), &register_class)) {
+    return -1;
+  }
+  Instruction instruction;
+  instruction.op_ = OpCode::Interpret;
+  instruction.type_id_ = expr->GetReturnType();
+  instruction.out_ = NewRegister(register_class);
+  instruction.expr_ = expr;
+  program_.push_back(instruction);
+  return instruction.out_;
+}
+
+bool CompiledExpression::GetRegisterClass(TypeId type_id, RegisterClass *register_class) {
+  switch (type_id) {
+    case TypeId::BOOLEAN:
+      *register_class = RegisterClass::Boolean;
+      return true;
+    case TypeId::TINYINT:
+    case TypeId::SMALLINT:
+    case TypeId::INTEGER:
+    case TypeId::BIGINT:
+      *register_class = RegisterClass::Integer;
+      return true;
+    case TypeId::DECIMAL:
+      *register_class = RegisterClass::Decimal;
+      return true;
+    case TypeId::TIMESTAMP:
+      *register_class = RegisterClass::Timestamp;
+      return true;
+    default:
+      return false;
+  }
+}
+
+void CompiledExpression::Unbox(const Value &value, Register *reg) {
+  reg->is_null_ = value.IsNull();
+  switch (value.GetTypeId()) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      reg->integer_ = value.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      reg->integer_ = value.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      reg->integer_ = value.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      reg->integer_ = value.GetAs<int64_t>();
+      break;
+    case TypeId::DECIMAL:
+      reg->decimal_ = value.GetAs<double>();
+      break;
+    case TypeId::TIMESTAMP:
+      reg->timestamp_ = value.GetAs<uint64_t>();
+      break;
+    default:
+      UNREACHABLE("A register cannot hold a value of this type.");
+  }
+}
+
+void CompiledExpression::UnboxAs(const Value &value, TypeId type_id, Register *reg) {
+  if (value.GetTypeId() == type_id) {
+    Unbox(value, reg);
+  } else {
+    Unbox(value.CastAs(type_id), reg);
+  }
+}
+
+template <typename Source>
+CmpBool CompiledExpression::Run(const Source &source) {
+  Register *registers = registers_.data();
+  for (const Instruction &instruction : program_) {
+    Register *out = &registers[instruction.out_];
+    switch (instruction.op_) {
+      case OpCode::LoadBoolean:
+      case OpCode::LoadTinyint: {
+        auto value = source.template Column<int8_t>(instruction.left_, instruction.right_);
+        out->integer_ = value;
+        out->is_null_ = value == BUSTUB_INT8_NULL;
+        break;
+      }
+      case OpCode::LoadSmallint: {
+        auto value = source.template Column<int16_t>(instruction.left_, instruction.right_);
+        out->integer_ = value;
+        out->is_null_ = value == BUSTUB_INT16_NULL;
+        break;
+      }
+      case OpCode::LoadInteger: {
+        auto value = source.template Column<int32_t>(instruction.left_, instruction.right_);
+        out->integer_ = value;
+        out->is_null_ = value == BUSTUB_INT32_NULL;
+        break;
+      }
+      case OpCode::LoadBigint: {
+        auto value = source.template Column<int64_t>(instruction.left_, instruction.right_);
+        out->integer_ = value;
+        out->is_null_ = value == BUSTUB_INT64_NULL;
+        break;
+      }
+      case OpCode::LoadDecimal: {
+        auto value = source.template Column<double>(instruction.left_, instruction.right_);
+        out->decimal_ = value;
+        out->is_null_ = value == BUSTUB_DECIMAL_NULL;
+        break;
+      }
+      case OpCode::LoadTimestamp: {
+        auto value = source.template Column<uint64_t>(instruction.left_, instruction.right_);
+        out->timestamp_ = value;
+        out->is_null_ = value == BUSTUB_TIMESTAMP_NULL;
+        break;
+      }
+      case OpCode::LoadTerm: {
+        UnboxAs(source.Term(instruction.left_ != 0, instruction.right_), instruction.type_id_, out);
+        break;
+      }
+      case OpCode::IntegerToDecimal: {
+        const Register &operand = registers[instruction.left_];
+        out->decimal_ = static_cast<double>(operand.integer_);
+        out->is_null_ = operand.is_null_;
+        break;
+      }
+      case OpCode::CompareInteger: {
+        const Register &left = registers[instruction.left_];
+        const Register &right = registers[instruction.right_];
+        out->integer_ = CompareValues(instruction.comp_type_, left.integer_, right.integer_) ? 1 : 0;
+        out->is_null_ = left.is_null_ || right.is_null_;
+        break;
+      }
+      case OpCode::CompareDecimal: {
+        const Register &left = registers[instruction.left_];
+        const Register &right = registers[instruction.right_];
+        out->integer_ = CompareValues(instruction.comp_type_, left.decimal_, right.decimal_) ? 1 : 0;
+        out->is_null_ = left.is_null_ || right.is_null_;
+        break;
+      }
+      case OpCode::CompareTimestamp: {
+        const Register &left = registers[instruction.left_];
+        const Register &right = registers[instruction.right_];
+        out->integer_ = CompareValues(instruction.comp_type_, left.timestamp_, right.timestamp_) ? 1 : 0;
+        out->is_null_ = left.is_null_ || right.is_null_;
+        break;
+      }
+      case OpCode::And:
+      case OpCode::Or: {
+        const Register &left = registers[instruction.left_];
+        const Register &right = registers[instruction.right_];
+        // The value that decides the result on its own: false (0) for AND, true (1) for OR.
+        int64_t decisive = instruction.op_ == OpCode::And ? 0 : 1;
+        bool left_decides = !left.is_null_ && (left.integer_ != 0) == (decisive != 0);
+        bool right_decides = !right.is_null_ && (right.integer_ != 0) == (decisive != 0);
+        bool decided = left_decides || right_decides;
+        out->integer_ = decided ? decisive : 1 - decisive;
+        out->is_null_ = !decided && (left.is_null_ || right.is_null_);
+        break;
+      }
+      case OpCode::Interpret: {
+        UnboxAs(source.Interpret(instruction.expr_), instruction.type_id_, out);
+        break;
+      }
+    }
+  }
+
+  const Register &result = registers[result_];
+  if (result.is_null_) {
+    return CmpBool::CmpNull;
+  }
+  return result.integer_ != 0 ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+}
+
+}  // namespace bustub
@@ -0,0 +1,258 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.cpp
+//
+// Identification: src/execution/exchange_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/exchange_executor.h"
+
+#include <utility>
+
+#include "common/exception.h"
+#include "common/util/hash_util.h"
+#include "execution/executor_factory.h"
+
+namespace bustub {
+
+Exchange::Exchange(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, size_t num_partitions)
+    : exec_ctx_(exec_ctx), plan_(plan), free_batches_(EXCHANGE_QUEUE_CAPACITY * num_partitions) {
+  for (size_t i = 0; i < num_partitions; i++) {
+    partitions_.push_back(std::make_unique<BatchQueue>(EXCHANGE_QUEUE_CAPACITY));
+  }
+}
+
+Exchange::~Exchange() {
+  Close();
+  std::unique_lock<std::mutex> lock(latch_);
+  done_cv_.wait(lock, [this] { return running_ == 0; });
+}
+
+void Exchange::Start() {
+  size_t num_copies = exec_ctx_->GetParallelism();
+  pipeline_ctx_ = exec_ctx_->MakePipelineContext(num_copies);
+  for (size_t i = 0; i < num_copies; i++) {
+    copies_.push_back(ExecutorFactory::CreateExecutor(pipeline_ctx_.get(), plan_->GetChildPlan()));
+  }
+  // An exchange read in a copy of a pipeline stops with it; the contexts of pipeline copies are short-lived, so the
+  // callback does not pile up in the context of the query.
+  if (exec_ctx_->GetNumPipelineCopies() > 1) {
+    std::weak_ptr<Exchange> weak_exchange = weak_from_this();
+    exec_ctx_->OnCancel([weak_exchange] {
+      if (auto exchange = weak_exchange.lock()) {
+        exchange->Close();
+      }
+    });
+  }
+  running_ = num_copies;
+  producing_ = num_copies;
+  ThreadPool *thread_pool = exec_ctx_->GetThreadPool();
+  for (auto &copy : copies_) {
+    thread_pool->Submit([this, executor = copy.get()] { Produce(executor); });
+  }
+}
+
+size_t Exchange::AddReader() {
+  size_t partition = num_readers_++;
+  BUSTUB_ASSERT(partition < partitions_.size(), "An exchange has more readers than partitions.");
+  return partition;
+}
+
+bool Exchange::Pop(size_t partition, TupleBatch *batch) {
+  std::unique_ptr<TupleBatch> popped;
+  if (!partitions_[partition]->Pop(&popped)) {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (error_ != nullptr) {
+      std::rethrow_exception(error_);
+    }
+    batch->Init(plan_->OutputSchema());
+    return false;
+  }
+  // Hand the caller's batch to the copies in exchange, so that its memory is reused.
+  std::swap(*batch, *popped);
+  free_batches_.TryPush(&popped);
+  return true;
+}
+
+void Exchange::Produce(AbstractExecutor *copy) {
+  try {
+    copy->Init();
+    std::vector<std::unique_ptr<TupleBatch>> partials(partitions_.size());
+    std::unique_ptr<TupleBatch> batch = NewBatch();
+    bool open = true;
+    while (open && copy->NextBatch(batch.get())) {
+      switch (plan_->GetExchangeType()) {
+        case ExchangeType::Gather:
+          open = partitions_[0]->Push(&batch);
+          batch = NewBatch();
+          break;
+        case ExchangeType::Broadcast:
+          for (size_t i = 0; open && i + 1 < partitions_.size(); i++) {
+            std::unique_ptr<TupleBatch> copied = NewBatch();
+            *copied = *batch;
+            open = partitions_[i]->Push(&copied);
+          }
+          open = open && partitions_.back()->Push(&batch);
+          batch = NewBatch();
+          break;
+        case ExchangeType::Repartition:
+          open = Repartition(*batch, &partials);
+          break;
+      }
+    }
+    for (size_t i = 0; open && i < partials.size(); i++) {
+      if (partials[i] != nullptr && !partials[i]->IsEmpty()) {
+        open = partitions_[i]->Push(&partials[i]);
+      }
+    }
+  } catch (...) {
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      if (error_ == nullptr) {
+        error_ = std::current_exception();
+      }
+    }
+    Close();
+  }
+  // The last copy done ends the partitions. The count the destructor waits for drops only after that, as the last
+  // thing the copy does.
+  if (producing_.fetch_sub(1) == 1) {
+    Close();
+  }
+  std::lock_guard<std::mutex> guard(latch_);
+  running_--;
+  done_cv_.notify_all();
+}
+
+bool Exchange::Repartition(const TupleBatch &batch, std::vector<std::unique_ptr<TupleBatch>> *partials) {
+  const Schema *output_schema = plan_->OutputSchema();
+  uint32_t num_columns = output_schema->GetColumnCount();
+  for (size_t i = 0; i < batch.Size(); i++) {
+    uint32_t row = batch.GetRow(i);
+    hash_t hash = 0;
+    for (const AbstractExpression *key : plan_->GetPartitionKeys()) {
+      Value value = key->EvaluateInBatch(&batch, row);
+      if (!value.IsNull()) {
+        hash = HashUtil::CombineHashes(hash, HashUtil::HashValue(&value));
+      }
+    }
+    size_t partition = HashUtil::MixHash(hash) % partials->size();
+    std::unique_ptr<TupleBatch> &partial = (*partials)[partition];
+    if (partial == nullptr) {
+      partial = NewBatch();
+      partial->Init(output_schema);
+    }
+    for (uint32_t col_idx = 0; col_idx < num_columns; col_idx++) {
+      partial->AppendValue(col_idx, batch.GetValue(col_idx, row));
+    }
+    partial->FinishRow(batch.GetRid(row));
+    if (partial->IsFull() && !partitions_[partition]->Push(&partial)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::unique_ptr<TupleBatch> Exchange::NewBatch() {
+  std::unique_ptr<TupleBatch> batch;
+  if (!free_batches_.TryPop(&batch)) {
+    batch = std::make_unique<TupleBatch>();
+  }
+  return batch;
+}
+
+void Exchange::Close() {
+  for (auto &partition : partitions_) {
+    partition->Close();
+  }
+  if (pipeline_ctx_ != nullptr) {
+    pipeline_ctx_->Cancel();
+  }
+}
+
+ExchangeExecutor::ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, bool rescanned)
+    : AbstractExecutor(exec_ctx), plan_(plan), rescanned_(rescanned) {
+  // With logging enabled the transaction takes tuple locks, which one thread at a time may do.
+  if (enable_logging || exec_ctx_->GetParallelism() <= 1) {
+    child_executor_ = ExecutorFactory::CreateExecutor(exec_ctx_, plan_->GetChildPlan());
+  }
+  shared_ = plan_->GetExchangeType() != ExchangeType::Gather && exec_ctx_->GetNumPipelineCopies() > 1;
+}
+
+void ExchangeExecutor::Init() {
+  if (child_executor_ != nullptr) {
+    child_executor_->Init();
+    ResetBatch();
+    return;
+  }
+  ResetBatch();
+  if (!shared_) {
+    // Stop the previous run before starting the next one.
+    exchange_.reset();
+    exchange_ = std::make_shared<Exchange>(exec_ctx_, plan_, 1);
+    exchange_->Start();
+    partition_ = exchange_->AddReader();
+    return;
+  }
+  if (exchange_ == nullptr) {
+    exchange_ = exec_ctx_->GetPipelineState<Exchange>(plan_, [this] {
+      auto exchange = std::make_shared<Exchange>(exec_ctx_, plan_, exec_ctx_->GetNumPipelineCopies());
+      exchange->Start();
+      return exchange;
+    });
+    partition_ = exchange_->AddReader();
+    if (rescanned_) {
+      read_tuples_ = std::make_unique<TmpTupleStore>(exec_ctx_->GetBufferPoolManager());
+    }
+    return;
+  }
+  if (!rescanned_) {
+    if (read_) {
+      throw Exception("An exchange shared by the copies of a pipeline cannot be read twice.");
+    }
+    return;
+  }
+  // Replay what has been read so far; tuples read after the replay go to a new page.
+  read_tuples_->ReleaseTailPage();
+  replay_iter_ = std::make_unique<TmpTupleIterator>(read_tuples_->Begin());
+}
+
+bool ExchangeExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool ExchangeExecutor::NextBatch(TupleBatch *batch) {
+  if (child_executor_ != nullptr) {
+    return child_executor_->NextBatch(batch);
+  }
+  if (!shared_) {
+    return exchange_->Pop(partition_, batch);
+  }
+  if (replay_iter_ != nullptr) {
+    batch->Init(plan_->OutputSchema());
+    for (; !batch->IsFull() && *replay_iter_ != read_tuples_->End(); ++(*replay_iter_)) {
+      batch->AppendTuple(**replay_iter_, RID());
+    }
+    if (!batch->IsEmpty()) {
+      return true;
+    }
+    replay_iter_.reset();
+  }
+  read_ = true;
+  if (!exchange_->Pop(partition_, batch)) {
+    return false;
+  }
+  if (read_tuples_ != nullptr) {
+    for (size_t i = 0; i < batch->Size(); i++) {
+      if (!read_tuples_->Append(batch->GetTuple(batch->GetRow(i)))) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot spill the tuples of a rescanned exchange.");
+      }
+    }
+  }
+  return true;
+}
+
+}  // namespace bustub
@@ -19,6 +19,7 @@
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/delete_executor.h"
 #include "execution/executors/distinct_executor.h"
+#include "execution/executors/exchange_executor.h"
 #include "execution/executors/hash_join_executor.h"
 #include "execution/executors/index_scan_executor.h"
 #include "execution/executors/insert_executor.h"
@@ -32,7 +33,8 @@
 namespace bustub {
 
 std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContext *exec_ctx,
-                                                                  const AbstractPlanNode *plan) {
+                                                                  const AbstractPlanNode *plan, bool rescanned) {
+  // The children of a rescanned executor are rescanned with it.
   switch (plan->GetType()) {
     // Create a new sequential scan executor
     case PlanType::SeqScan: {
@@ -47,51 +49,52 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
     // Create a new insert executor
     case PlanType::Insert: {
       auto insert_plan = dynamic_cast<const InsertPlanNode *>(plan);
-      auto child_executor =
-          insert_plan->IsRawInsert() ? nullptr : ExecutorFactory::CreateExecutor(exec_ctx, insert_plan->GetChildPlan());
+      auto child_executor = insert_plan->IsRawInsert()
+                                ? nullptr
+                                : ExecutorFactory::CreateExecutor(exec_ctx, insert_plan->GetChildPlan(), rescanned);
       return std::make_unique<InsertExecutor>(exec_ctx, insert_plan, std::move(child_executor));
     }
 
     // Create a new update executor
     case PlanType::Update: {
       auto update_plan = dynamic_cast<const UpdatePlanNode *>(plan);
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, update_plan->GetChildPlan());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, update_plan->GetChildPlan(), rescanned);
       return std::make_unique<UpdateExecutor>(exec_ctx, update_plan, std::move(child_executor));
     }
 
     // Create a new delete executor
     case PlanType::Delete: {
       auto delete_plan = dynamic_cast<const DeletePlanNode *>(plan);
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, delete_plan->GetChildPlan());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, delete_plan->GetChildPlan(), rescanned);
       return std::make_unique<DeleteExecutor>(exec_ctx, delete_plan, std::move(child_executor));
     }
 
     // Create a new limit executor
     case PlanType::Limit: {
       auto limit_plan = dynamic_cast<const LimitPlanNode *>(plan);
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, limit_plan->GetChildPlan());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, limit_plan->GetChildPlan(), rescanned);
       return std::make_unique<LimitExecutor>(exec_ctx, limit_plan, std::move(child_executor));
     }
 
     // Create a new distinct executor
     case PlanType::Distinct: {
       auto distinct_plan = dynamic_cast<const DistinctPlanNode *>(plan);
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, distinct_plan->GetChildPlan());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, distinct_plan->GetChildPlan(), rescanned);
       return std::make_unique<DistinctExecutor>(exec_ctx, distinct_plan, std::move(child_executor));
     }
 
     // Create a new aggregation executor
     case PlanType::Aggregation: {
       auto agg_plan = dynamic_cast<const AggregationPlanNode *>(plan);
-      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan());
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, agg_plan->GetChildPlan(), rescanned);
       return std::make_unique<AggregationExecutor>(exec_ctx, agg_plan, std::move(child_executor));
     }
 
-    // Create a new nested-loop join executor
+    // Create a new nested-loop join executor, which reads its inner side again for each outer batch
     case PlanType::NestedLoopJoin: {
       auto nested_loop_join_plan = dynamic_cast<const NestedLoopJoinPlanNode *>(plan);
-      auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_loop_join_plan->GetLeftPlan());
-      auto right = ExecutorFactory::CreateExecutor(exec_ctx, nested_loop_join_plan->GetRightPlan());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_loop_join_plan->GetLeftPlan(), rescanned);
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, nested_loop_join_plan->GetRightPlan(), true);
       return std::make_unique<NestedLoopJoinExecutor>(exec_ctx, nested_loop_join_plan, std::move(left),
                                                       std::move(right));
     }
@@ -99,18 +102,23 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
     // Create a new nested-index join executor
     case PlanType::NestedIndexJoin: {
       auto nested_index_join_plan = dynamic_cast<const NestedIndexJoinPlanNode *>(plan);
-      auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_index_join_plan->GetChildPlan());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, nested_index_join_plan->GetChildPlan(), rescanned);
       return std::make_unique<NestIndexJoinExecutor>(exec_ctx, nested_index_join_plan, std::move(left));
     }
 
     // Create a new hash join executor
     case PlanType::HashJoin: {
       auto hash_join_plan = dynamic_cast<const HashJoinPlanNode *>(plan);
-      auto left = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan());
-      auto right = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan());
+      auto left = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetLeftPlan(), rescanned);
+      auto right = ExecutorFactory::CreateExecutor(exec_ctx, hash_join_plan->GetRightPlan(), rescanned);
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new exchange executor, which creates the copies of its child itself
+    case PlanType::Exchange: {
+      return std::make_unique<ExchangeExecutor>(exec_ctx, dynamic_cast<const ExchangePlanNode *>(plan), rescanned);
+    }
+
     default:
       UNREACHABLE("Unsupported plan type.");
   }
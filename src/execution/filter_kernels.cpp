@@ -0,0 +1,281 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.cpp
+//
+// Identification: src/execution/filter_kernels.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/filter_kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "common/macros.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+void SelectionBitmap::And(const SelectionBitmap &other) {
+  BUSTUB_ASSERT(num_rows_ == other.num_rows_, "Bitmaps of the same rows.");
+  for (size_t i = 0; i < words_.size(); i++) {
+    words_[i] &= other.words_[i];
+  }
+}
+
+void SelectionBitmap::Or(const SelectionBitmap &other) {
+  BUSTUB_ASSERT(num_rows_ == other.num_rows_, "Bitmaps of the same rows.");
+  for (size_t i = 0; i < words_.size(); i++) {
+    words_[i] |= other.words_[i];
+  }
+}
+
+size_t SelectionBitmap::Count() const {
+  size_t count = 0;
+  for (uint64_t word : words_) {
+    count += __builtin_popcountll(word);
+  }
+  return count;
+}
+
+void SelectionBitmap::ToSelection(std::vector<uint32_t> *rows) const {
+  rows->clear();
+  for (size_t i = 0; i < words_.size(); i++) {
+    for (uint64_t word = words_[i]; word != 0; word &= word - 1) {
+      rows->push_back(static_cast<uint32_t>(i * 64 + __builtin_ctzll(word)));
+    }
+  }
+}
+
+/** @return the result of a comparison of two values */
+template <ComparisonType COMP, typename T>
+static inline bool CompareValues(T lhs, T rhs) {
+  switch (COMP) {
+    case ComparisonType::Equal:
+      return lhs == rhs;
+    case ComparisonType::NotEqual:
+      return lhs != rhs;
+    case ComparisonType::LessThan:
+      return lhs < rhs;
+    case ComparisonType::LessThanOrEqual:
+      return lhs <= rhs;
+    case ComparisonType::GreaterThan:
+      return lhs > rhs;
+    case ComparisonType::GreaterThanOrEqual:
+      return lhs >= rhs;
+  }
+  return false;
+}
+
+#ifdef __AVX2__
+
+/**
+ * Lanes gives the AVX2 operations on a register of values of type T. Comparisons yield a mask with every bit of a lane
+ * set where the comparison is true.
+ */
+template <typename T>
+struct Lanes;
+
+template <>
+struct Lanes<int32_t> {
+  static constexpr size_t COUNT = 8;
+  static __m256i Load(const int32_t *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+  static __m256i Broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+  static __m256i Equal(__m256i lhs, __m256i rhs) { return _mm256_cmpeq_epi32(lhs, rhs); }
+  static __m256i Greater(__m256i lhs, __m256i rhs) { return _mm256_cmpgt_epi32(lhs, rhs); }
+  static uint64_t Bits(__m256i mask) { return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_castsi256_ps(mask))); }
+};
+
+template <>
+struct Lanes<int64_t> {
+  static constexpr size_t COUNT = 4;
+  static __m256i Load(const int64_t *data) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)); }
+  static __m256i Broadcast(int64_t value) { return _mm256_set1_epi64x(value); }
+  static __m256i Equal(__m256i lhs, __m256i rhs) { return _mm256_cmpeq_epi64(lhs, rhs); }
+  static __m256i Greater(__m256i lhs, __m256i rhs) { return _mm256_cmpgt_epi64(lhs, rhs); }
+  static uint64_t Bits(__m256i mask) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))); }
+};
+
+/** AVX2 compares signed 64-bit integers only: flipping the sign bit maps the unsigned order onto the signed one. */
+template <>
+struct Lanes<uint64_t> {
+  static constexpr size_t COUNT = 4;
+  static __m256i Load(const uint64_t *data) {
+    return _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data)), SignBit());
+  }
+  static __m256i Broadcast(uint64_t value) {
+    return _mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(value)), SignBit());
+  }
+  static __m256i Equal(__m256i lhs, __m256i rhs) { return _mm256_cmpeq_epi64(lhs, rhs); }
+  static __m256i Greater(__m256i lhs, __m256i rhs) { return _mm256_cmpgt_epi64(lhs, rhs); }
+  static uint64_t Bits(__m256i mask) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))); }
+  static __m256i SignBit() { return _mm256_set1_epi64x(INT64_MIN); }
+};
+
+template <>
+struct Lanes<double> {
+  static constexpr size_t COUNT = 4;
+  static __m256d Load(const double *data) { return _mm256_loadu_pd(data); }
+  static __m256d Broadcast(double value) { return _mm256_set1_pd(value); }
+  static __m256i Equal(__m256d lhs, __m256d rhs) { return _mm256_castpd_si256(_mm256_cmp_pd(lhs, rhs, _CMP_EQ_OQ)); }
+  static __m256i Greater(__m256d lhs, __m256d rhs) {
+    return _mm256_castpd_si256(_mm256_cmp_pd(lhs, rhs, _CMP_GT_OQ));
+  }
+  static uint64_t Bits(__m256i mask) { return static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(mask))); }
+};
+
+/** @return the mask of the lanes where a comparison is true */
+template <ComparisonType COMP, typename T, typename V>
+static inline __m256i CompareLanes(V lhs, V rhs) {
+  const __m256i ones = _mm256_set1_epi32(-1);
+  switch (COMP) {
+    case ComparisonType::Equal:
+      return Lanes<T>::Equal(lhs, rhs);
+    case ComparisonType::NotEqual:
+      return _mm256_xor_si256(Lanes<T>::Equal(lhs, rhs), ones);
+    case ComparisonType::LessThan:
+      return Lanes<T>::Greater(rhs, lhs);
+    case ComparisonType::LessThanOrEqual:
+      return _mm256_xor_si256(Lanes<T>::Greater(lhs, rhs), ones);
+    case ComparisonType::GreaterThan:
+      return Lanes<T>::Greater(lhs, rhs);
+    case ComparisonType::GreaterThanOrEqual:
+      return _mm256_xor_si256(Lanes<T>::Greater(rhs, lhs), ones);
+  }
+  return _mm256_setzero_si256();
+}
+
+/**
+ * Compare the rows of a column a register at a time, as long as a whole register of rows is left.
+ * @return the number of rows compared
+ */
+template <ComparisonType COMP, bool CONSTANT, typename T>
+static size_t CompareLanesOfColumn(const T *left, const T *right, size_t num_rows, T null, uint64_t *words) {
+  using L = Lanes<T>;
+  const auto nulls = L::Broadcast(null);
+  const auto constant = L::Broadcast(right[0]);
+  size_t row = 0;
+  for (; row + L::COUNT <= num_rows; row += L::COUNT) {
+    auto lhs = L::Load(left + row);
+    auto rhs = CONSTANT ? constant : L::Load(right + row);
+    __m256i mask = _mm256_andnot_si256(L::Equal(lhs, nulls), CompareLanes<COMP, T>(lhs, rhs));
+    if (!CONSTANT) {
+      mask = _mm256_andnot_si256(L::Equal(rhs, nulls), mask);
+    }
+    // A register holds a divisor of 64 rows, so that its bits never straddle two words.
+    words[row / 64] |= L::Bits(mask) << (row % 64);
+  }
+  return row;
+}
+
+#endif
+
+/**
+ * Compare the rows of a column with a constant, or with the rows of another column.
+ * @param left the values of the left column
+ * @param right the constant, or the values of the right column
+ * @param num_rows the number of rows
+ * @param null the null value of the type
+ * @param[out] words the bitmap of the rows, cleared
+ */
+template <ComparisonType COMP, bool CONSTANT, typename T>
+static void CompareRows(const T *left, const T *right, size_t num_rows, T null, uint64_t *words) {
+  size_t row = 0;
+#ifdef __AVX2__
+  row = CompareLanesOfColumn<COMP, CONSTANT>(left, right, num_rows, null, words);
+#endif
+  for (; row < num_rows; row++) {
+    T rhs = CONSTANT ? right[0] : right[row];
+    bool selected = left[row] != null && rhs != null && CompareValues<COMP>(left[row], rhs);
+    words[row / 64] |= static_cast<uint64_t>(selected) << (row % 64);
+  }
+}
+
+template <bool CONSTANT, typename T>
+static void CompareRows(ComparisonType comp_type, const T *left, const T *right, size_t num_rows, T null,
+                        uint64_t *words) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return CompareRows<ComparisonType::Equal, CONSTANT>(left, right, num_rows, null, words);
+    case ComparisonType::NotEqual:
+      return CompareRows<ComparisonType::NotEqual, CONSTANT>(left, right, num_rows, null, words);
+    case ComparisonType::LessThan:
+      return CompareRows<ComparisonType::LessThan, CONSTANT>(left, right, num_rows, null, words);
+    case ComparisonType::LessThanOrEqual:
+      return CompareRows<ComparisonType::LessThanOrEqual, CONSTANT>(left, right, num_rows, null, words);
+    case ComparisonType::GreaterThan:
+      return CompareRows<ComparisonType::GreaterThan, CONSTANT>(left, right, num_rows, null, words);
+    case ComparisonType::GreaterThanOrEqual:
+      return CompareRows<ComparisonType::GreaterThanOrEqual, CONSTANT>(left, right, num_rows, null, words);
+  }
+}
+
+/** Compare a column of any supported type, with the right operand given as an array of its type. */
+template <bool CONSTANT>
+static void CompareColumn(ComparisonType comp_type, const ColumnVector &left, const void *right, SelectionBitmap *out) {
+  out->Reset(left.Size());
+  size_t num_rows = left.Size();
+  if (num_rows == 0) {
+    return;
+  }
+  uint64_t *words = out->GetWords();
+  switch (left.GetTypeId()) {
+    case TypeId::INTEGER:
+      return CompareRows<CONSTANT>(comp_type, left.GetData<int32_t>(), static_cast<const int32_t *>(right), num_rows,
+                                     BUSTUB_INT32_NULL, words);
+    case TypeId::BIGINT:
+      return CompareRows<CONSTANT>(comp_type, left.GetData<int64_t>(), static_cast<const int64_t *>(right), num_rows,
+                                     BUSTUB_INT64_NULL, words);
+    case TypeId::DECIMAL:
+      return CompareRows<CONSTANT>(comp_type, left.GetData<double>(), static_cast<const double *>(right), num_rows,
+                                     BUSTUB_DECIMAL_NULL, words);
+    case TypeId::TIMESTAMP:
+      return CompareRows<CONSTANT>(comp_type, left.GetData<uint64_t>(), static_cast<const uint64_t *>(right),
+                                     num_rows, BUSTUB_TIMESTAMP_NULL, words);
+    default:
+      UNREACHABLE("Unsupported column type.");
+  }
+}
+
+bool FilterKernels::IsSupported(TypeId type_id) {
+  return type_id == TypeId::INTEGER || type_id == TypeId::BIGINT || type_id == TypeId::DECIMAL ||
+         type_id == TypeId::TIMESTAMP;
+}
+
+void FilterKernels::CompareConstant(ComparisonType comp_type, const ColumnVector &column, const Value &constant,
+                                    SelectionBitmap *out) {
+  BUSTUB_ASSERT(constant.GetTypeId() == column.GetTypeId(), "The constant has the type of the column.");
+  // Nothing compares true with null.
+  if (constant.IsNull()) {
+    out->Reset(column.Size());
+    return;
+  }
+  // A column holds values as they are serialized.
+  uint64_t storage = 0;
+  constant.SerializeTo(reinterpret_cast<char *>(&storage));
+  CompareColumn<true>(comp_type, column, &storage, out);
+}
+
+void FilterKernels::CompareColumns(ComparisonType comp_type, const ColumnVector &left, const ColumnVector &right,
+                                   SelectionBitmap *out) {
+  BUSTUB_ASSERT(left.GetTypeId() == right.GetTypeId() && left.Size() == right.Size(), "Columns of the same rows.");
+  switch (left.GetTypeId()) {
+    case TypeId::INTEGER:
+      return CompareColumn<false>(comp_type, left, right.GetData<int32_t>(), out);
+    case TypeId::BIGINT:
+      return CompareColumn<false>(comp_type, left, right.GetData<int64_t>(), out);
+    case TypeId::DECIMAL:
+      return CompareColumn<false>(comp_type, left, right.GetData<double>(), out);
+    case TypeId::TIMESTAMP:
+      return CompareColumn<false>(comp_type, left, right.GetData<uint64_t>(), out);
+    default:
+      UNREACHABLE("Unsupported column type.");
+  }
+}
+
+}  // namespace bustub
@@ -11,71 +11,270 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/hash_join_executor.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/macros.h"
 #include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
+static void AppendTuple(TmpTupleStore *store, const Tuple &tuple) {
+  if (!store->Append(tuple)) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot spill a hash join partition.");
+  }
+}
+
+/** Read the next tuple of a child from its current batch, reading the next batch when it is exhausted. */
+static bool NextChildTuple(AbstractExecutor *child, TupleBatch *batch, size_t *pos, Tuple *tuple) {
+  while (*pos >= batch->Size()) {
+    if (!child->NextBatch(batch)) {
+      return false;
+    }
+    *pos = 0;
+  }
+  *tuple = batch->GetTuple(batch->GetRow((*pos)++));
+  return true;
+}
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       left_child_(std::move(left_child)),
-      right_child_(std::move(right_child)),
-      pos_(-1) {}
+      right_child_(std::move(right_child)) {}
 
 void HashJoinExecutor::Init() {
   left_child_->Init();
   right_child_->Init();
-  Tuple left_tuple;
-  RID left_rid;
-  while (left_child_->Next(&left_tuple, &left_rid)) {
-    Value left_key = plan_->LeftJoinKeyExpression()->Evaluate(&left_tuple, plan_->GetLeftPlan()->OutputSchema());
-    std::vector<Value> values;
-    for (size_t i = 0; i < left_child_->GetOutputSchema()->GetColumnCount(); i++) {
-      values.push_back(left_tuple.GetValue(plan_->GetLeftPlan()->OutputSchema(), i));
+  left_batch_.Clear();
+  left_batch_pos_ = 0;
+  right_batch_.Clear();
+  right_batch_pos_ = 0;
+  ResetBatch();
+  memory_budget_ = exec_ctx_->GetMemoryBudget();
+  // Every spilled partition keeps a page pinned while tuples are appended to it.
+  fanout_ = std::clamp<size_t>(exec_ctx_->GetBufferPoolManager()->GetPoolSize() / 4, 2, MAX_FANOUT);
+  memory_used_ = 0;
+  spilled_.clear();
+  left_iter_.reset();
+  right_iter_.reset();
+  source_.reset();
+  chunked_ = false;
+  level_ = 0;
+  partitions_.clear();
+  partitions_.resize(fanout_);
+  probes_.clear();
+  probe_pos_ = 0;
+  row_ = nullptr;
+  Build();
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  batch->Init(GetOutputSchema());
+  while (!batch->IsFull()) {
+    if (row_ != nullptr) {
+      JoinHashTable::GetTuple(row_, &left_tuple_);
+      row_ = JoinHashTable::NextRow(row_);
+      AppendJoinedRow(batch, left_tuple_, probes_[probe_pos_ - 1].first);
+      continue;
     }
-    HashJoinKey key{left_key};
-    if (left_ht_.find(key) == left_ht_.end()) {
-      left_ht_.insert({key, {values}});
-    } else {
-      left_ht_[key].push_back(values);
+    if (probe_pos_ < probes_.size()) {
+      row_ = probes_[probe_pos_++].second;
+      continue;
+    }
+    if (!ProbeBatch() && !NextPass()) {
+      break;
+    }
+  }
+  return !batch->IsEmpty();
+}
+
+size_t HashJoinExecutor::PartitionOf(hash_t hash) const {
+  if (partitions_.size() == 1) {
+    return 0;
+  }
+  // Each level splits with a different hash, so that a partition can be split again.
+  return HashUtil::MixHash(HashUtil::CombineHashes(hash, level_)) % partitions_.size();
+}
+
+bool HashJoinExecutor::NextLeft(Tuple *tuple) {
+  if (source_ == nullptr) {
+    return NextChildTuple(left_child_.get(), &left_batch_, &left_batch_pos_, tuple);
+  }
+  if (*left_iter_ == source_->left_->End()) {
+    return false;
+  }
+  *tuple = **left_iter_;
+  ++*left_iter_;
+  return true;
+}
+
+bool HashJoinExecutor::NextRight(Tuple *tuple) {
+  if (source_ == nullptr) {
+    return NextChildTuple(right_child_.get(), &right_batch_, &right_batch_pos_, tuple);
+  }
+  if (*right_iter_ == source_->right_->End()) {
+    return false;
+  }
+  *tuple = **right_iter_;
+  ++*right_iter_;
+  return true;
+}
+
+void HashJoinExecutor::Build() {
+  const Schema *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  Tuple tuple;
+  // A chunk takes at least one tuple, so that every pass makes progress.
+  while ((!chunked_ || memory_used_ == 0 || memory_used_ < memory_budget_) && NextLeft(&tuple)) {
+    Value key = plan_->LeftJoinKeyExpression()->Evaluate(&tuple, left_schema);
+    // A null key matches nothing.
+    if (key.IsNull()) {
+      continue;
+    }
+    hash_t hash = HashUtil::HashValue(&key);
+    Partition &partition = partitions_[PartitionOf(hash)];
+    if (partition.left_ != nullptr) {
+      AppendTuple(partition.left_.get(), tuple);
+      continue;
+    }
+    size_t memory = partition.table_.GetMemory();
+    partition.table_.Insert(key, hash, tuple);
+    memory_used_ += partition.table_.GetMemory() - memory;
+    while (!chunked_ && memory_used_ > memory_budget_) {
+      SpillLargest();
+    }
+  }
+  for (auto &partition : partitions_) {
+    if (partition.left_ != nullptr) {
+      partition.left_->ReleaseTailPage();
     }
   }
 }
 
-bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  while (true) {
-    if (pos_ == -1) {
-      if (!right_child_->Next(&right_tuple_, &right_rid_)) {
-        return false;
+void HashJoinExecutor::SpillLargest() {
+  Partition *largest = nullptr;
+  for (auto &partition : partitions_) {
+    if (partition.left_ == nullptr &&
+        (largest == nullptr || partition.table_.GetMemory() > largest->table_.GetMemory())) {
+      largest = &partition;
+    }
+  }
+  BUSTUB_ASSERT(largest != nullptr && largest->table_.GetMemory() > 0, "Memory is used by a partition in memory.");
+  largest->left_ = std::make_unique<TmpTupleStore>(exec_ctx_->GetBufferPoolManager());
+  Tuple tuple;
+  largest->table_.ForEachRow([&](const char *row) {
+    JoinHashTable::GetTuple(row, &tuple);
+    AppendTuple(largest->left_.get(), tuple);
+  });
+  memory_used_ -= largest->table_.GetMemory();
+  largest->table_.Clear();
+}
+
+bool HashJoinExecutor::ProbeBatch() {
+  probes_.clear();
+  probe_keys_.clear();
+  probe_hashes_.clear();
+  probe_partitions_.clear();
+  probe_pos_ = 0;
+  const Schema *right_schema = plan_->GetRightPlan()->OutputSchema();
+  bool read = false;
+  Tuple tuple;
+  while (probes_.size() < PROBE_BATCH_SIZE && NextRight(&tuple)) {
+    read = true;
+    Value key = plan_->RightJoinKeyExpression()->Evaluate(&tuple, right_schema);
+    if (key.IsNull()) {
+      continue;
+    }
+    hash_t hash = HashUtil::HashValue(&key);
+    size_t partition_idx = PartitionOf(hash);
+    Partition &partition = partitions_[partition_idx];
+    if (partition.left_ != nullptr) {
+      if (partition.right_ == nullptr) {
+        partition.right_ = std::make_unique<TmpTupleStore>(exec_ctx_->GetBufferPoolManager());
       }
+      AppendTuple(partition.right_.get(), tuple);
+      continue;
+    }
+    if (partition.table_.GetNumTuples() == 0) {
+      continue;
     }
-    auto right_key = plan_->RightJoinKeyExpression()->Evaluate(&right_tuple_, plan_->GetRightPlan()->OutputSchema());
-    auto iter = left_ht_.find(HashJoinKey{right_key});
-    if (iter == left_ht_.end()) {
-      pos_ = -1;
+    partition.table_.Prefetch(hash);
+    probes_.emplace_back(tuple, nullptr);
+    probe_keys_.push_back(key);
+    probe_hashes_.push_back(hash);
+    probe_partitions_.push_back(partition_idx);
+  }
+  for (size_t i = 0; i < probes_.size(); ++i) {
+    probes_[i].second = partitions_[probe_partitions_[i]].table_.Find(probe_keys_[i], probe_hashes_[i]);
+  }
+  return read;
+}
+
+bool HashJoinExecutor::NextPass() {
+  if (chunked_ && *left_iter_ != source_->left_->End()) {
+    // Build on the next chunk and scan the probe tuples again.
+    partitions_[0] = Partition{};
+    memory_used_ = 0;
+    Build();
+    right_iter_ = std::make_unique<TmpTupleIterator>(source_->right_->Begin());
+    return true;
+  }
+
+  // Queue the partitions spilled by this pass. Those without probe tuples produce nothing.
+  size_t num_source_tuples = source_ == nullptr ? 0 : source_->left_->GetNumTuples();
+  for (auto &partition : partitions_) {
+    if (partition.left_ == nullptr || partition.right_ == nullptr) {
+      continue;
+    }
+    partition.right_->ReleaseTailPage();
+    auto spilled = std::make_unique<Partition>(std::move(partition));
+    // A partition that took every tuple of its source does not get smaller by splitting it again.
+    spilled->level_ = spilled->left_->GetNumTuples() == num_source_tuples ? MAX_LEVEL : level_;
+    spilled_.push_back(std::move(spilled));
+  }
+  partitions_.clear();
+  memory_used_ = 0;
+  left_iter_.reset();
+  right_iter_.reset();
+  source_.reset();
+  chunked_ = false;
+  if (spilled_.empty()) {
+    return false;
+  }
+
+  source_ = std::move(spilled_.back());
+  spilled_.pop_back();
+  left_iter_ = std::make_unique<TmpTupleIterator>(source_->left_->Begin());
+  right_iter_ = std::make_unique<TmpTupleIterator>(source_->right_->Begin());
+  size_t memory = source_->left_->GetSize() + source_->left_->GetNumTuples() * TUPLE_OVERHEAD;
+  chunked_ = memory <= memory_budget_ || source_->level_ >= MAX_LEVEL;
+  level_ = source_->level_ + 1;
+  partitions_.resize(chunked_ ? 1 : fanout_);
+  Build();
+  return true;
+}
+
+void HashJoinExecutor::AppendJoinedRow(TupleBatch *batch, const Tuple &left_tuple, const Tuple &right_tuple) {
+  const Schema *left_schema = plan_->GetLeftPlan()->OutputSchema();
+  const Schema *right_schema = plan_->GetRightPlan()->OutputSchema();
+  const auto &columns = plan_->OutputSchema()->GetColumns();
+  for (uint32_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+    auto expr = reinterpret_cast<const ColumnValueExpression *>(columns[col_idx].GetExpr());
+    if (expr->GetTupleIdx() == 0) {
+      batch->AppendValue(col_idx, left_tuple.GetValue(left_schema, expr->GetColIdx()));
     } else {
-      ++pos_;
-      for (; pos_ < int32_t(iter->second.size()); pos_++) {
-        if (iter->first == HashJoinKey{right_key}) {
-          std::vector<Value> values;
-          for (auto &col : plan_->OutputSchema()->GetColumns()) {
-            auto expr = reinterpret_cast<const ColumnValueExpression *>(col.GetExpr());
-            if (expr->GetTupleIdx() == 0) {
-              values.push_back(iter->second[pos_][expr->GetColIdx()]);
-            } else {
-              values.push_back(right_tuple_.GetValue(plan_->GetRightPlan()->OutputSchema(), expr->GetColIdx()));
-            }
-          }
-          *tuple = Tuple(values, plan_->OutputSchema());
-          *rid = tuple->GetRid();
-          return true;
-        }
-      }
-      pos_ = -1;
+      batch->AppendValue(col_idx, right_tuple.GetValue(right_schema, expr->GetColIdx()));
     }
   }
+  batch->FinishRow(RID{});
 }
 
 }  // namespace bustub
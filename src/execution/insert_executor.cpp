@@ -11,6 +11,8 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "execution/executors/insert_executor.h"
 
@@ -29,28 +31,62 @@ void InsertExecutor::Init() {
 }
 
 bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) {
+  // Tuples are inserted in batches, so that the indexes can build their structure for many entries at once, and a
+  // large batch fills each page of the table in one go.
+  std::vector<Tuple> batch;
+  std::vector<RID> rids;
+  std::vector<std::pair<Tuple, RID>> index_entries;
   while (true) {
-    if (plan_->IsRawInsert()) {
-      if (raw_insert_index_ == plan_->RawValues().size()) {
-        return false;
-      }
-      *tuple = Tuple(plan_->RawValues()[raw_insert_index_], &table_info_->schema_);
-      raw_insert_index_++;
-    } else {
-      if (!child_executor_->Next(tuple, rid)) {
-        return false;
+    batch.clear();
+    while (batch.size() < INSERT_BATCH_SIZE) {
+      if (plan_->IsRawInsert()) {
+        if (raw_insert_index_ == plan_->RawValues().size()) {
+          break;
+        }
+        batch.emplace_back(plan_->RawValues()[raw_insert_index_], &table_info_->schema_);
+        raw_insert_index_++;
+      } else {
+        if (!child_executor_->Next(tuple, rid)) {
+          break;
+        }
+        batch.push_back(*tuple);
       }
     }
-    if (!table_info_->table_->InsertTuple(*tuple, rid, exec_ctx_->GetTransaction())) {
+    if (batch.empty()) {
+      return false;
+    }
+    if (!InsertBatch(batch, &rids)) {
       return false;
     }
     for (auto &index_info : index_infos_) {
-      const auto index_key =
-          tuple->KeyFromTuple(table_info_->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
-      index_info->index_->InsertEntry(index_key, *rid, exec_ctx_->GetTransaction());
+      index_entries.clear();
+      for (size_t i = 0; i < batch.size(); ++i) {
+        index_entries.emplace_back(
+            batch[i].KeyFromTuple(table_info_->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs()),
+            rids[i]);
+      }
+      index_info->index_->BulkInsertEntries(index_entries, exec_ctx_->GetTransaction());
     }
   }
   return false;
 }
 
+bool InsertExecutor::InsertBatch(const std::vector<Tuple> &batch, std::vector<RID> *rids) {
+  TableHeap *table = table_info_->table_.get();
+  if (batch.size() >= BULK_INSERT_THRESHOLD) {
+    return table->BulkInsert(batch, rids, exec_ctx_->GetTransaction());
+  }
+  // A few tuples go where the free space map finds room, which reuses deleted space and spreads concurrent inserts
+  // over several pages instead of queueing them on the last one.
+  rids->clear();
+  for (const Tuple &tuple : batch) {
+    RID rid;
+    if (!table->InsertTuple(tuple, &rid, exec_ctx_->GetTransaction())) {
+      return false;
+    }
+    rids->push_back(rid);
+  }
+  return true;
+}
+
 }  // namespace bustub
@@ -0,0 +1,101 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.cpp
+//
+// Identification: src/execution/join_hash_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/join_hash_table.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace bustub {
+
+void JoinHashTable::Insert(const Value &key, hash_t hash, const Tuple &tuple) {
+  // Keep the table at most half full.
+  if (2 * (num_keys_ + 1) > slots_.size()) {
+    Grow();
+  }
+  size_t pos = HashUtil::MixHash(hash) & mask_;
+  while (slots_[pos].head_ != nullptr &&
+         (slots_[pos].hash_ != hash || keys_[pos].CompareEquals(key) != CmpBool::CmpTrue)) {
+    pos = (pos + 1) & mask_;
+  }
+
+  char *row = AllocateRow(RowSize(tuple.GetLength()));
+  memcpy(row, &slots_[pos].head_, sizeof(char *));
+  tuple.SerializeTo(row + sizeof(char *));
+  if (slots_[pos].head_ == nullptr) {
+    slots_[pos].hash_ = hash;
+    keys_[pos] = key;
+    ++num_keys_;
+  }
+  slots_[pos].head_ = row;
+  ++num_tuples_;
+}
+
+const char *JoinHashTable::Find(const Value &key, hash_t hash) const {
+  if (slots_.empty()) {
+    return nullptr;
+  }
+  for (size_t pos = HashUtil::MixHash(hash) & mask_; slots_[pos].head_ != nullptr; pos = (pos + 1) & mask_) {
+    if (slots_[pos].hash_ == hash && keys_[pos].CompareEquals(key) == CmpBool::CmpTrue) {
+      return slots_[pos].head_;
+    }
+  }
+  return nullptr;
+}
+
+void JoinHashTable::Clear() {
+  slots_.clear();
+  slots_.shrink_to_fit();
+  keys_.clear();
+  keys_.shrink_to_fit();
+  mask_ = 0;
+  num_keys_ = 0;
+  num_tuples_ = 0;
+  chunks_.clear();
+  next_chunk_size_ = MIN_CHUNK_SIZE;
+  memory_ = 0;
+}
+
+char *JoinHashTable::AllocateRow(size_t row_size) {
+  if (chunks_.empty() || chunks_.back().size_ - chunks_.back().used_ < row_size) {
+    size_t size = std::max(next_chunk_size_, row_size);
+    chunks_.push_back(Chunk{std::make_unique<char[]>(size), size, 0});
+    next_chunk_size_ = std::min(2 * next_chunk_size_, MAX_CHUNK_SIZE);
+    memory_ += size;
+  }
+  Chunk &chunk = chunks_.back();
+  char *row = chunk.data_.get() + chunk.used_;
+  chunk.used_ += row_size;
+  return row;
+}
+
+void JoinHashTable::Grow() {
+  std::vector<Slot> old_slots(std::max<size_t>(16, 2 * slots_.size()), Slot{0, nullptr});
+  std::vector<Value> old_keys(old_slots.size());
+  std::swap(old_slots, slots_);
+  std::swap(old_keys, keys_);
+  memory_ += (slots_.size() - old_slots.size()) * (sizeof(Slot) + sizeof(Value));
+  mask_ = slots_.size() - 1;
+  for (size_t i = 0; i < old_slots.size(); ++i) {
+    if (old_slots[i].head_ == nullptr) {
+      continue;
+    }
+    size_t pos = HashUtil::MixHash(old_slots[i].hash_) & mask_;
+    while (slots_[pos].head_ != nullptr) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = old_slots[i];
+    Swap(keys_[pos], old_keys[i]);
+  }
+}
+
+}  // namespace bustub
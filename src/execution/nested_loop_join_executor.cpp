@@ -11,7 +11,6 @@
 //===----------------------------------------------------------------------===//
 
 #include "execution/executors/nested_loop_join_executor.h"
-#include "execution/expressions/column_value_expression.h"
 
 namespace bustub {
 
@@ -21,48 +20,60 @@ NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const
     : AbstractExecutor(exec_ctx),
       plan_(plan),
       left_executor_(std::move(left_executor)),
-      right_executor_(std::move(right_executor)) {}
+      right_executor_(std::move(right_executor)) {
+  if (plan_->Predicate() != nullptr) {
+    predicate_ = std::make_unique<CompiledExpression>(plan_->Predicate(), left_executor_->GetOutputSchema(),
+                                                      right_executor_->GetOutputSchema());
+  }
+}
 
 void NestedLoopJoinExecutor::Init() {
   left_executor_->Init();
   right_executor_->Init();
-  left_valid_ = left_executor_->Next(&left_tuple_, &left_rid_);
+  left_valid_ = left_executor_->NextBatch(&left_batch_);
+  // The first inner batch is read by the first call to NextBatch().
+  right_batch_.Clear();
+  left_pos_ = left_batch_.Size();
+  right_pos_ = 0;
+  ResetBatch();
 }
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
-  if (!left_valid_) {
-    return false;
-  }
-  Tuple right_tuple;
-  RID right_rid;
-  while (true) {
-    while (!right_executor_->Next(&right_tuple, &right_rid)) {
-      if (!left_executor_->Next(&left_tuple_, &left_rid_)) {
-        return false;
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool NestedLoopJoinExecutor::NextBatch(TupleBatch *batch) {
+  auto output_schema = GetOutputSchema();
+  batch->Init(output_schema);
+  const auto &columns = output_schema->GetColumns();
+  while (left_valid_ && !batch->IsFull()) {
+    if (left_pos_ < left_batch_.Size()) {
+      uint32_t left_row = left_batch_.GetRow(left_pos_);
+      uint32_t right_row = right_batch_.GetRow(right_pos_);
+      if (++right_pos_ == right_batch_.Size()) {
+        right_pos_ = 0;
+        ++left_pos_;
       }
-      right_executor_->Init();
-    }
-    if (plan_->Predicate() == nullptr || plan_->Predicate()
-                                             ->EvaluateJoin(&left_tuple_, plan_->GetLeftPlan()->OutputSchema(),
-                                                            &right_tuple, plan_->GetRightPlan()->OutputSchema())
-                                             .GetAs<bool>()) {
-      std::vector<Value> values;
-      auto output_schema = GetOutputSchema();
-      values.reserve(output_schema->GetColumns().size());
-      for (auto &col : output_schema->GetColumns()) {
-        auto expr = reinterpret_cast<const ColumnValueExpression *>(col.GetExpr());
-        if (expr->GetTupleIdx() == 0) {
-          values.push_back(left_tuple_.GetValue(plan_->GetLeftPlan()->OutputSchema(), expr->GetColIdx()));
-        } else {
-          values.push_back(right_tuple.GetValue(plan_->GetRightPlan()->OutputSchema(), expr->GetColIdx()));
-        }
+      if (predicate_ != nullptr &&
+          predicate_->EvaluateJoinInBatch(&left_batch_, left_row, &right_batch_, right_row) != CmpBool::CmpTrue) {
+        continue;
+      }
+      for (uint32_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+        auto expr = columns[col_idx].GetExpr();
+        batch->AppendValue(col_idx, expr->EvaluateJoinInBatch(&left_batch_, left_row, &right_batch_, right_row));
       }
-      *tuple = Tuple(values, plan_->OutputSchema());
-      *rid = tuple->GetRid();
-      return true;
+      batch->FinishRow(RID{});
+      continue;
+    }
+    // Every pair of the current batches is joined: move on to the next inner batch, or to the next outer batch.
+    if (right_executor_->NextBatch(&right_batch_)) {
+      left_pos_ = 0;
+      right_pos_ = 0;
+      continue;
     }
+    left_valid_ = left_executor_->NextBatch(&left_batch_);
+    right_executor_->Init();
+    left_pos_ = left_batch_.Size();
   }
-  return false;
+  return !batch->IsEmpty();
 }
 
 }  // namespace bustub
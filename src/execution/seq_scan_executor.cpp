@@ -12,44 +12,197 @@
 
 #include "execution/executors/seq_scan_executor.h"
 
+#include <algorithm>
+#include <utility>
+
 namespace bustub {
 
 SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
-    : AbstractExecutor(exec_ctx), plan_(plan), cur_(nullptr, RID{}, nullptr), end_(nullptr, RID{}, nullptr) {
+    : AbstractExecutor(exec_ctx), plan_(plan) {
   table_info_ = exec_ctx_->GetCatalog()->GetTable(plan_->GetTableOid());
+  auto make_dispenser = [this] { return std::make_shared<MorselDispenser>(table_info_->table_.get()); };
+  shared_dispenser_ = exec_ctx_->GetNumPipelineCopies() > 1;
+  dispenser_ =
+      shared_dispenser_ ? exec_ctx_->GetPipelineState<MorselDispenser>(plan_, make_dispenser) : make_dispenser();
+  size_t num_workers = enable_logging || shared_dispenser_ ? 1 : std::max<size_t>(exec_ctx_->GetParallelism(), 1);
+  for (size_t i = 0; i < num_workers; i++) {
+    auto worker = std::make_unique<ScanWorker>();
+    if (plan_->GetPredicate() != nullptr) {
+      worker->filter_ = std::make_unique<BatchFilter>(plan_->GetPredicate(), &table_info_->schema_);
+    }
+    workers_.push_back(std::move(worker));
+  }
 }
 
+SeqScanExecutor::~SeqScanExecutor() { StopWorkers(); }
+
 void SeqScanExecutor::Init() {
-  cur_ = table_info_->table_->Begin(exec_ctx_->GetTransaction());
-  end_ = table_info_->table_->End();
+  StopWorkers();
+  // A shared dispenser is fresh for the run of the pipeline copies, and may already be handing pages to the others.
+  // The pages it has handed to this scan are not handed out again, so the scan cannot be read twice.
+  if (!shared_dispenser_) {
+    dispenser_->Reset();
+  } else if (read_) {
+    throw Exception("A scan shared by the copies of a pipeline cannot be read twice.");
+  }
+  for (auto &worker : workers_) {
+    worker->morsel_.clear();
+    worker->page_pos_ = 0;
+    worker->next_slot_ = 0;
+    worker->read_ahead_ = 0;
+    worker->prefetch_end_ = 0;
+  }
+  ResetBatch();
+  if (workers_.size() > 1) {
+    stopping_ = false;
+    error_ = nullptr;
+    running_workers_ = workers_.size();
+    for (auto &worker : workers_) {
+      threads_.emplace_back(&SeqScanExecutor::RunWorker, this, worker.get());
+    }
+  }
 }
 
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
-  while (cur_ != end_) {
-    auto predicate = plan_->GetPredicate();
-    if (predicate == nullptr) {
-      goto ok;
-    }
-    auto value = predicate->Evaluate(&(*cur_), &table_info_->schema_);
-    if (value.GetAs<bool>()) {
-      goto ok;
-    }
-    ++cur_;
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return NextFromBatch(tuple, rid); }
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  read_ = shared_dispenser_;
+  if (workers_.size() == 1) {
+    return ScanBatch(workers_[0].get(), batch);
+  }
+  std::unique_lock<std::mutex> lock(queue_latch_);
+  queue_cv_.wait(lock, [this] { return !queue_.empty() || running_workers_ == 0; });
+  if (error_ != nullptr) {
+    std::rethrow_exception(error_);
+  }
+  if (queue_.empty()) {
+    batch->Init(GetOutputSchema());
+    return false;
   }
-  return false;
+  // Hand the caller's batch to the workers in exchange, so that its memory is reused.
+  std::unique_ptr<TupleBatch> output = std::move(queue_.front());
+  queue_.pop_front();
+  std::swap(*batch, *output);
+  free_batches_.push_back(std::move(output));
+  queue_cv_.notify_all();
+  return true;
+}
 
-ok:
-  std::vector<Value> values;
+bool SeqScanExecutor::ScanBatch(ScanWorker *worker, TupleBatch *batch) {
   auto output_schema = GetOutputSchema();
-  for (auto &col : output_schema->GetColumns()) {
-    auto expr = col.GetExpr();
-    Value value = expr->Evaluate(&(*cur_), &table_info_->schema_);
-    values.push_back(value);
-  }
-  *tuple = Tuple(values, output_schema);
-  *rid = cur_->GetRid();
-  ++cur_;
+  batch->Init(output_schema);
+  TupleBatch *scan_batch = &worker->scan_batch_;
+  auto append = [scan_batch](const Tuple &tuple) {
+    scan_batch->AppendTuple(tuple, tuple.GetRid());
+    return !scan_batch->IsFull();
+  };
+  // Every tuple of a scan batch may be filtered out; read on until one is not.
+  while (batch->IsEmpty()) {
+    scan_batch->Init(&table_info_->schema_);
+    while (!scan_batch->IsFull()) {
+      if (worker->page_pos_ == worker->morsel_.size()) {
+        bool claimed = dispenser_->Next(&worker->morsel_);
+        worker->page_pos_ = 0;
+        worker->next_slot_ = 0;
+        worker->prefetch_end_ = 0;
+        if (!claimed) {
+          break;
+        }
+        ReadAhead(worker);
+      }
+      if (table_info_->table_->ScanPage(worker->morsel_[worker->page_pos_], &worker->next_slot_,
+                                        exec_ctx_->GetTransaction(), append)) {
+        worker->page_pos_++;
+        worker->next_slot_ = 0;
+        if (worker->page_pos_ < worker->morsel_.size()) {
+          ReadAhead(worker);
+        }
+      }
+    }
+    if (scan_batch->IsEmpty()) {
+      return false;
+    }
+    if (worker->filter_ != nullptr) {
+      worker->filter_->Evaluate(*scan_batch, &worker->bitmap_);
+      worker->bitmap_.ToSelection(&worker->selection_);
+      scan_batch->Select(worker->selection_);
+    }
+    const auto &columns = output_schema->GetColumns();
+    for (size_t i = 0; i < scan_batch->Size(); ++i) {
+      uint32_t row = scan_batch->GetRow(i);
+      for (uint32_t col_idx = 0; col_idx < columns.size(); ++col_idx) {
+        batch->AppendValue(col_idx, columns[col_idx].GetExpr()->EvaluateInBatch(scan_batch, row));
+      }
+      batch->FinishRow(scan_batch->GetRid(row));
+    }
+  }
   return true;
 }
 
+void SeqScanExecutor::ReadAhead(ScanWorker *worker) {
+  TableHeap *table = table_info_->table_.get();
+  worker->read_ahead_ = std::min(std::max<size_t>(2 * worker->read_ahead_, 1), table->GetReadAheadWindow());
+  size_t begin = std::max(worker->prefetch_end_, worker->page_pos_ + 1);
+  size_t end = std::min(worker->morsel_.size(), worker->page_pos_ + 1 + worker->read_ahead_);
+  if (begin >= end) {
+    return;
+  }
+  worker->prefetch_.assign(worker->morsel_.begin() + begin, worker->morsel_.begin() + end);
+  worker->prefetch_end_ = begin + table->PrefetchPages(worker->prefetch_);
+}
+
+void SeqScanExecutor::RunWorker(ScanWorker *worker) {
+  // At most two batches per worker wait in the queue, so that the workers do not run far ahead of the reader.
+  const size_t capacity = 2 * workers_.size();
+  try {
+    while (true) {
+      std::unique_ptr<TupleBatch> output;
+      {
+        std::lock_guard<std::mutex> guard(queue_latch_);
+        if (!free_batches_.empty()) {
+          output = std::move(free_batches_.back());
+          free_batches_.pop_back();
+        }
+      }
+      if (output == nullptr) {
+        output = std::make_unique<TupleBatch>();
+      }
+      if (!ScanBatch(worker, output.get())) {
+        break;
+      }
+      std::unique_lock<std::mutex> lock(queue_latch_);
+      queue_cv_.wait(lock, [this, capacity] { return stopping_ || queue_.size() < capacity; });
+      if (stopping_) {
+        break;
+      }
+      queue_.push_back(std::move(output));
+      queue_cv_.notify_all();
+    }
+  } catch (...) {
+    std::lock_guard<std::mutex> guard(queue_latch_);
+    if (error_ == nullptr) {
+      error_ = std::current_exception();
+    }
+  }
+  std::lock_guard<std::mutex> guard(queue_latch_);
+  running_workers_--;
+  queue_cv_.notify_all();
+}
+
+void SeqScanExecutor::StopWorkers() {
+  {
+    std::lock_guard<std::mutex> guard(queue_latch_);
+    stopping_ = true;
+  }
+  queue_cv_.notify_all();
+  for (auto &thread : threads_) {
+    thread.join();
+  }
+  threads_.clear();
+  while (!queue_.empty()) {
+    free_batches_.push_back(std::move(queue_.front()));
+    queue_.pop_front();
+  }
+}
+
 }  // namespace bustub
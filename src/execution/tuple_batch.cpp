@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+ColumnVector::ColumnVector(TypeId type_id)
+    : type_id_(type_id), width_(static_cast<uint32_t>(Type::GetTypeSize(type_id))) {}
+
+Value ColumnVector::GetValue(uint32_t row) const {
+  BUSTUB_ASSERT(row < size_, "Position out of the column.");
+  if (width_ == 0) {
+    return varlen_[row];
+  }
+  return Value::DeserializeFrom(data_.data() + static_cast<size_t>(row) * width_, type_id_);
+}
+
+void ColumnVector::Append(const Value &value) {
+  if (width_ == 0) {
+    varlen_.push_back(value.GetTypeId() == type_id_ ? value : value.CastAs(type_id_));
+    ++size_;
+    return;
+  }
+  if ((size_ + 1) * width_ > data_.size()) {
+    data_.resize(std::max<size_t>(2 * data_.size(), EXECUTION_BATCH_SIZE * width_));
+  }
+  char *storage = data_.data() + size_ * width_;
+  if (value.GetTypeId() == type_id_) {
+    value.SerializeTo(storage);
+  } else {
+    value.CastAs(type_id_).SerializeTo(storage);
+  }
+  ++size_;
+}
+
+void ColumnVector::AppendRaw(const char *storage) {
+  BUSTUB_ASSERT(width_ > 0, "Only fixed-size values are appended raw.");
+  if ((size_ + 1) * width_ > data_.size()) {
+    data_.resize(std::max<size_t>(2 * data_.size(), EXECUTION_BATCH_SIZE * width_));
+  }
+  memcpy(data_.data() + size_ * width_, storage, width_);
+  ++size_;
+}
+
+void ColumnVector::Clear() {
+  size_ = 0;
+  varlen_.clear();
+}
+
+void TupleBatch::Init(const Schema *schema) {
+  if (schema != schema_) {
+    schema_ = schema;
+    columns_.clear();
+    columns_.reserve(schema->GetColumnCount());
+    for (const auto &col : schema->GetColumns()) {
+      columns_.emplace_back(col.GetType());
+    }
+  }
+  Clear();
+}
+
+Tuple TupleBatch::GetTuple(uint32_t row) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column.GetValue(row));
+  }
+  return Tuple(values, schema_);
+}
+
+void TupleBatch::FinishRow(const RID &rid) {
+  BUSTUB_ASSERT(!has_selection_, "Rows cannot be appended to a batch with a selection.");
+  rids_.push_back(rid);
+  BUSTUB_ASSERT(std::all_of(columns_.begin(), columns_.end(),
+                            [&](const ColumnVector &column) { return column.Size() == rids_.size(); }),
+                "Every column needs a value for the row.");
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const RID &rid) {
+  for (uint32_t i = 0; i < columns_.size(); ++i) {
+    // Fixed-size values are copied as they are, without going through a Value.
+    const Column &col = schema_->GetColumn(i);
+    if (col.IsInlined()) {
+      columns_[i].AppendRaw(tuple.GetData() + col.GetOffset());
+    } else {
+      columns_[i].Append(tuple.GetValue(schema_, i));
+    }
+  }
+  FinishRow(rid);
+}
+
+void TupleBatch::Select(const std::vector<uint32_t> &rows) {
+  BUSTUB_ASSERT(std::is_sorted(rows.begin(), rows.end()), "The selected positions are in increasing order.");
+  BUSTUB_ASSERT(rows.empty() || rows.back() < rids_.size(), "The selected positions are in the batch.");
+  has_selection_ = true;
+  selection_ = rows;
+}
+
+void TupleBatch::Clear() {
+  for (auto &column : columns_) {
+    column.Clear();
+  }
+  rids_.clear();
+  has_selection_ = false;
+  selection_.clear();
+}
+
+}  // namespace bustub
@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer.h
+//
+// Identification: src/include/buffer/arc_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <list>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ARCReplacer implements the Adaptive Replacement Cache policy. Resident pages are split between T1, the pages
+ * referenced once since they were loaded, and T2, the pages referenced again. Ghost lists B1 and B2 remember the ids of
+ * pages recently evicted from T1 and T2. A miss on a page in B1 means T1 was too small, a miss on a page in B2 means T2
+ * was, and the target size of T1 moves accordingly. The policy thus leans towards recency during scans and towards
+ * frequency under repeated point lookups, without tuning.
+ *
+ * A reference that follows the load of a page by at most correlated_period ticks does not move it to T2, so a scan
+ * reading a page tuple by tuple does not make it look frequent. Time is counted in Pin calls.
+ */
+class ARCReplacer : public Replacer {
+ public:
+  /**
+   * Create a new ARCReplacer.
+   * @param num_pages the maximum number of pages the ARCReplacer will be required to store
+   * @param correlated_period the number of ticks after a page is loaded during which references to it are correlated
+   */
+  explicit ARCReplacer(size_t num_pages, size_t correlated_period = CORRELATED_REFERENCE_PERIOD);
+
+  /**
+   * Destroys the ARCReplacer.
+   */
+  ~ARCReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) override;
+
+  void SetFramePage(frame_id_t frame_id, page_id_t page_id) override;
+
+  size_t Size() override;
+
+  /** @return the current target size of T1 */
+  size_t GetTargetRecentSize();
+
+ private:
+  enum class ListType { NONE, T1, T2 };
+
+  /** Book-keeping of a frame. */
+  struct FrameInfo {
+    /** The page the frame holds. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** The list the page belongs to. */
+    ListType list_{ListType::NONE};
+    /** Time the page was loaded. */
+    size_t load_time_{0};
+    /** True if the frame is in the replacer. */
+    bool evictable_{false};
+    /** Position in t1_ or t2_, if the frame is in the replacer. */
+    std::list<frame_id_t>::iterator iter_;
+  };
+
+  /** A ghost list: evicted page ids, most recently evicted first, with an index for lookups. */
+  struct GhostList {
+    std::list<page_id_t> pages_;
+    std::unordered_map<page_id_t, std::list<page_id_t>::iterator> index_;
+  };
+
+  /** @return the evictable frames of the given list, least recently unpinned last */
+  std::list<frame_id_t> *Evictable(ListType list) { return list == ListType::T1 ? &t1_ : &t2_; }
+
+  /** @return the list Victim should take from first */
+  ListType PreferredList() const;
+
+  /** Take the frame out of its evictable list. */
+  void Erase(frame_id_t frame_id);
+
+  /** Move a page to the front of a ghost list. */
+  static void PushGhost(GhostList *ghost, page_id_t page_id);
+
+  /** Drop the least recently evicted page of a ghost list. */
+  static void PopGhost(GhostList *ghost);
+
+  /** Remove a page from a ghost list. @return true if it was there */
+  static bool RemoveGhost(GhostList *ghost, page_id_t page_id);
+
+  /** Number of frames, c in the ARC paper. */
+  const size_t num_pages_;
+  const size_t correlated_period_;
+  /** Logical clock, advanced on every Pin. */
+  size_t current_time_{0};
+  /** Target size of T1, p in the ARC paper. */
+  size_t target_t1_{0};
+  std::vector<FrameInfo> frames_;
+  /** Number of resident pages in T1 and T2, pinned or not. */
+  size_t t1_size_{0};
+  size_t t2_size_{0};
+  /** Evictable frames of T1 and T2, most recently unpinned first. */
+  std::list<frame_id_t> t1_;
+  std::list<frame_id_t> t2_;
+  GhostList b1_;
+  GhostList b2_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -16,6 +16,7 @@
 #include <mutex>  // NOLINT
 #include <unordered_map>
 
+#include "buffer/buffer_pool_stats.h"
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
@@ -87,6 +88,16 @@ class BufferPoolManager {
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
+  /**
+   * Hint that the page will be fetched soon. The buffer pool may start reading it in the background so that the
+   * FetchPage that follows does not wait for the whole read. The page is not pinned by this call.
+   * @param page_id id of the page to prefetch
+   */
+  virtual void PrefetchPage(page_id_t page_id) {}
+
+  /** @return a snapshot of the buffer pool's counters, summed over its instances */
+  virtual BufferPoolStats GetStats() { return {}; }
+
  protected:
   /**
    * Grading function. Do not modify!
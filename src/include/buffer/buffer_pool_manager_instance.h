@@ -12,12 +12,20 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
 #include <list>
 #include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
+#include "buffer/arc_replacer.h"
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/frame_arena.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -34,8 +42,13 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param numa_node the NUMA node to allocate the frames on, or NO_NUMA_NODE
+   * @param max_pool_size the size the buffer pool can grow to with Resize, no less than pool_size
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU, int numa_node = NO_NUMA_NODE,
+                            size_t max_pool_size = 0);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -43,9 +56,14 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param numa_node the NUMA node to allocate the frames on, or NO_NUMA_NODE
+   * @param max_pool_size the size the buffer pool can grow to with Resize, no less than pool_size
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU, int numa_node = NO_NUMA_NODE,
+                            size_t max_pool_size = 0);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -55,9 +73,60 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override { return pool_size_; }
 
+  /**
+   * Create a new page unless doing so would mean waiting: for latch_, because another thread holds it, or for a pinned
+   * page to be unpinned, because the last attempt found every frame pinned.
+   * @param[out] page_id id of created page, or INVALID_PAGE_ID
+   * @return nullptr if the page was not created, otherwise pointer to new page
+   */
+  Page *TryNewPage(page_id_t *page_id);
+
+  /** @return the size the buffer pool can grow to */
+  size_t GetMaxPoolSize() const { return max_pool_size_; }
+
+  /**
+   * Grow or shrink the buffer pool while it keeps serving requests. Frames added by growing are free. Shrinking
+   * removes the frames at the end of the pool: their pages are written back if dirty and evicted, waiting for those
+   * that are pinned to be unpinned, and their memory is returned to the operating system.
+   * @param pool_size the new number of frames
+   * @return false if pool_size is 0 or larger than the maximum pool size, true once the pool has the new size
+   */
+  bool Resize(size_t pool_size);
+
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /** @return the arena holding the data of the frames */
+  const FrameArena &GetFrameArena() const { return frame_arena_; }
+
+  /**
+   * Start reading the page into a free or evictable frame without waiting for the read. Nothing happens if the page
+   * is already in the pool, if every frame is pinned, if the victim frame holds a prefetched page that has not been
+   * fetched yet, or if a quarter of the pool already holds such pages.
+   * @param page_id id of the page to prefetch
+   */
+  void PrefetchPage(page_id_t page_id) override;
+
+  /**
+   * Start the background writer thread. Every background_writer_interval, and whenever an eviction had to write back
+   * a dirty page, it writes back the dirty unpinned pages among the next clean_target eviction candidates, so that
+   * foreground misses find clean victims.
+   * @param clean_target number of frames at the head of the eviction order the writer tries to keep clean
+   */
+  void RunBackgroundWriter(size_t clean_target);
+
+  /** Stop the background writer thread, if it is running. */
+  void StopBackgroundWriter();
+
+  /** @return the number of evictions whose victim was clean */
+  uint64_t GetCleanEvictions() const { return stats_.GetCleanEvictions(); }
+
+  /** @return the number of evictions whose victim was dirty and had to be written back first */
+  uint64_t GetDirtyEvictions() const { return stats_.GetDirtyEvictions(); }
+
+  /** @return a snapshot of this instance's counters */
+  BufferPoolStats GetStats() override { return stats_.Snapshot(); }
+
  protected:
   /**
    * Fetch the requested page from the buffer pool.
@@ -110,10 +179,129 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * Deallocate a page on disk.
    * @param page_id id of the page to deallocate
    */
-  void DeallocatePage(__attribute__((unused)) page_id_t page_id) {
-    // This is a no-nop right now without a more complex data structure to track deallocated pages
+  void DeallocatePage(page_id_t page_id) { disk_manager_->DeallocatePage(page_id); }
+
+  /**
+   * Pin a frame found by a lookup that did not hold latch_. The lookup may be stale, so the pin only sticks if the
+   * frame still holds the page.
+   * @param frame_id id of the frame
+   * @param page_id id of the page the frame was found for
+   * @return true if the frame was pinned and holds the page
+   */
+  bool TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Drop a pin on a frame. The frame becomes evictable when its last pin is dropped.
+   * @param frame_id id of the frame
+   */
+  void UnpinFrame(frame_id_t frame_id);
+
+  /**
+   * Make a frame evictable after its last pin has been dropped.
+   * @param frame_id id of the frame
+   */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /**
+   * Find a frame to hold a page that is not in the buffer pool. Frames are always taken from the free list first.
+   * @param[out] frame_id id of the frame that was found
+   * @return false if every frame is pinned, true otherwise
+   */
+  bool FindFreeFrame(frame_id_t *frame_id);
+
+  /** Body of NewPgImp and TryNewPage once latch_ is held, which lock does. */
+  Page *NewPageLocked(std::unique_lock<std::mutex> *lock, page_id_t *page_id);
+
+  /** Note that a frame may have become available, after out_of_frames_ was set. */
+  void ClearOutOfFrames() {
+    if (out_of_frames_.load(std::memory_order_relaxed)) {
+      out_of_frames_.store(false, std::memory_order_relaxed);
+    }
   }
 
+  /**
+   * Install page_id in the given frame, writing back the frame's previous page if it is dirty. The frame is
+   * reserved and marked as doing I/O while latch_ is held, then latch_ is dropped for the disk I/O itself so that
+   * other threads can keep using the pool. Threads fetching page_id in the meantime wait on this frame only.
+   * @param lock the held lock on latch_, released during the I/O and held again on return
+   * @param frame_id id of the frame to load the page into
+   * @param page_id id of the page to load
+   * @param read_page true to read the page from disk, false to zero it out (for a newly allocated page)
+   * @return the loaded page, pinned once
+   */
+  Page *LoadPage(std::unique_lock<std::mutex> *lock, frame_id_t frame_id, page_id_t page_id, bool read_page);
+
+  /**
+   * Reassign the frame to page_id: move the frame's previous page to the write-back table if it is dirty, install
+   * page_id in the page table, and pin the frame and mark it as doing I/O. latch_ must be held.
+   * @param frame_id id of the frame, taken from FindFreeFrame
+   * @param page_id id of the page that will be loaded into the frame
+   * @param[out] victim_page_id id of the page the frame held before, or INVALID_PAGE_ID
+   * @return true if the previous page is dirty and must be written back before the frame is reused
+   */
+  bool ReserveFrame(frame_id_t frame_id, page_id_t page_id, page_id_t *victim_page_id);
+
+  /**
+   * Mark I/O on a frame set up by ReserveFrame as complete and wake up the threads waiting on it. latch_ must be held.
+   * @param frame_id id of the frame
+   * @param victim_page_id the previous page, as returned by ReserveFrame
+   * @param write_back the return value of ReserveFrame
+   */
+  void FinishPageIO(frame_id_t frame_id, page_id_t victim_page_id, bool write_back);
+
+  /**
+   * Write back the pages held in the given frames, issuing all the writes before waiting for any of them. The frames
+   * are pinned for the duration of the writes, and latch_ is dropped while waiting. Each page is copied under its read
+   * latch, so the caller must not hold the latch of any of them.
+   * @param lock the held lock on latch_, released while writing and held again on return
+   * @param frames ids of the frames to write back
+   * @param skip_latched whether to leave pages whose latch is taken dirty instead of waiting for it
+   */
+  void WriteBackFrames(std::unique_lock<std::mutex> *lock, const std::vector<frame_id_t> &frames,
+                       bool skip_latched = false);
+
+  /**
+   * Lock latch_, recording in the latch wait histogram how long that took. Only contended acquisitions read the clock.
+   * @return the held lock
+   */
+  std::unique_lock<std::mutex> LockLatch();
+
+  /** Start timing a pin interval on a frame whose pin count just went from 0 to 1. */
+  void StartPinInterval(frame_id_t frame_id) {
+    if (enable_pin_timing) {
+      pinned_since_[frame_id].store(BufferPoolCounters::Now(), std::memory_order_relaxed);
+    }
+  }
+
+  /** Stop timing a pin interval on a frame whose pin count just went from 1 to 0. */
+  void EndPinInterval(frame_id_t frame_id) {
+    if (enable_pin_timing) {
+      uint64_t pinned_since = pinned_since_[frame_id].exchange(0, std::memory_order_relaxed);
+      // The interval started before timing was turned on.
+      if (pinned_since != 0) {
+        stats_.RecordPinDuration(BufferPoolCounters::Now() - pinned_since);
+      }
+    }
+  }
+
+  /** Note that the page in a frame is no longer waiting to be fetched, if it was prefetched. */
+  void ClearPrefetched(frame_id_t frame_id) {
+    if (prefetched_[frame_id].load(std::memory_order_relaxed) && prefetched_[frame_id].exchange(false)) {
+      unfetched_prefetches_--;
+    }
+  }
+
+  /**
+   * Evict the page in a frame that is being removed by Resize, waiting for the unpin that drops its last pin, and leave
+   * the frame free but out of the free list. latch_ must be held.
+   * @param lock the held lock on latch_, released while waiting or writing back and held again on return
+   * @param frame_id id of the frame
+   */
+  void RetireFrame(std::unique_lock<std::mutex> *lock, frame_id_t frame_id);
+
+  /** Body of the background writer thread. */
+  void BackgroundWriterLoop();
+
   /**
    * Validate that the page_id being used is accessible to this BPI. This can be used in all of the functions to
    * validate input data and ensure that a parallel BPM is routing requests to the correct BPI
@@ -121,28 +309,66 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
+  /** Number of pages in the buffer pool. Frames from pool_size_ on are unused. Changed under latch_. */
+  std::atomic<size_t> pool_size_;
+  /** Number of frames allocated, which the buffer pool can grow to. */
+  const size_t max_pool_size_;
   /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
   const uint32_t num_instances_ = 1;
   /** Index of this BPI in the parallel BPM (if present, otherwise just 0) */
   const uint32_t instance_index_ = 0;
-  /** Each BPI maintains its own counter for page_ids to hand out, must ensure they mod back to its instance_index_ */
-  std::atomic<page_id_t> next_page_id_ = instance_index_;
 
-  /** Array of buffer pool pages. */
+  /** Array of buffer pool pages, holding the book-keeping of each frame and pointing to its data in frame_arena_. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
+  /** Data of the frames. */
+  FrameArena frame_arena_;
+  /** Page table for keeping track of buffer pool pages. Modified under latch_, but looked up without it on hits. */
+  PageTable page_table_;
   /** Replacer to find unpinned pages for replacement. */
   Replacer *replacer_;
+  /** Pages evicted from the pool whose dirty contents are still being written back, mapped to their old frame. */
+  std::unordered_map<page_id_t, frame_id_t> write_back_table_;
+  /** One condition variable per frame, signalled when I/O on that frame completes. Used together with latch_. */
+  std::condition_variable *io_cv_;
+  /** Number of prefetch reads that have not completed yet. */
+  size_t prefetches_in_flight_{0};
+  /** Signalled when prefetches_in_flight_ drops to zero. Used together with latch_. */
+  std::condition_variable prefetch_cv_;
+  /** Per frame, true if its page was prefetched and has not been fetched since. Set under latch_. */
+  std::atomic<bool> *prefetched_;
+  /** Number of frames whose prefetched_ flag is set. */
+  std::atomic<size_t> unfetched_prefetches_{0};
+  /** Counters reported by GetStats. */
+  BufferPoolCounters stats_;
+  /** Per frame, the time its current pin interval started, or 0. Only maintained while enable_pin_timing is set. */
+  std::atomic<uint64_t> *pinned_since_;
+  /** Hint set when FindFreeFrame fails and cleared when a frame may have become available, for TryNewPage. */
+  std::atomic<bool> out_of_frames_{false};
+  /** Serializes calls to Resize. */
+  std::mutex resize_latch_;
+  /** The frame Resize is waiting to be unpinned, or -1, and what it waits on. */
+  std::atomic<frame_id_t> retiring_frame_{-1};
+  std::mutex retire_latch_;
+  std::condition_variable retire_cv_;
+  /** The background writer thread, or nullptr if it is not running. */
+  std::thread *writer_thread_{nullptr};
+  /** True while the background writer should keep running. Protected by latch_. */
+  bool writer_running_{false};
+  /** Number of eviction candidates the background writer keeps clean. Protected by latch_. */
+  size_t writer_clean_target_{0};
+  /** Wakes up the background writer early. Used together with latch_. */
+  std::condition_variable writer_cv_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /**
+   * This latch serializes changes to the page table and protects the write-back table and the free list. A page's
+   * book-keeping fields are only reassigned under it, but pages in the pool are pinned and unpinned without it. It is
+   * never held across disk I/O.
+   */
   std::mutex latch_;
 };
 }  // namespace bustub
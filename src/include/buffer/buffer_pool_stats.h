@@ -0,0 +1,127 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_stats.h
+//
+// Identification: src/include/buffer/buffer_pool_stats.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdint>
+#include <string>
+
+namespace bustub {
+
+/**
+ * BufferPoolStats is a snapshot of the counters of one buffer pool instance, or the sum of the snapshots of several.
+ *
+ * Latch waits are bucketed by duration: bucket 0 counts acquisitions of the instance latch that did not have to wait,
+ * bucket 1 waits under a microsecond, bucket i > 1 waits of [2^(i-2), 2^(i-1)) microseconds, and the last bucket also
+ * every longer wait.
+ */
+struct BufferPoolStats {
+  static constexpr size_t LATCH_WAIT_BUCKETS = 16;
+
+  /** Fetches of a page that was already in the pool. */
+  uint64_t hits_{0};
+  /** Fetches that had to read the page from disk. */
+  uint64_t misses_{0};
+  /** Pages created by NewPage. */
+  uint64_t new_pages_{0};
+  /** Pages read ahead by PrefetchPage. */
+  uint64_t prefetches_{0};
+  /** Evictions whose victim was clean. */
+  uint64_t clean_evictions_{0};
+  /** Evictions whose victim was dirty and was written back first. */
+  uint64_t dirty_evictions_{0};
+  /** Dirty pages written back by flushes and the background writer, outside of evictions. */
+  uint64_t write_backs_{0};
+  /** Fetches that had to wait for I/O started by another thread on the page. */
+  uint64_t pin_waits_{0};
+  /** Histogram of waits for the instance latch. */
+  std::array<uint64_t, LATCH_WAIT_BUCKETS> latch_waits_{};
+  /** Total time spent waiting for the instance latch. */
+  uint64_t latch_wait_ns_{0};
+  /**
+   * Number of intervals a frame stayed pinned, from its first pin to its last unpin, and their total duration. Pins
+   * taken internally, by flushes for instance, count too. Only maintained while enable_pin_timing is set.
+   */
+  uint64_t pin_intervals_{0};
+  uint64_t pin_duration_ns_{0};
+
+  /** @return the fraction of fetches that were hits, or 0 if there were none */
+  double HitRatio() const;
+
+  /** @return the average time a frame stayed pinned, in microseconds, or 0 if no interval was timed */
+  double AveragePinDuration() const;
+
+  /** Add the counters of another snapshot to this one. */
+  BufferPoolStats &operator+=(const BufferPoolStats &other);
+
+  /** @return a human readable summary of the counters */
+  std::string ToString() const;
+};
+
+/**
+ * BufferPoolCounters are the live counters behind BufferPoolStats. They are relaxed atomics owned by a single buffer
+ * pool instance, so recording an event costs one uncontended atomic add and never synchronizes with anything else.
+ */
+class BufferPoolCounters {
+ public:
+  /** @return the current time in nanoseconds, for the timings passed to the Record functions */
+  static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  void RecordHit() { Add(&hits_, 1); }
+  void RecordMiss() { Add(&misses_, 1); }
+  void RecordNewPage() { Add(&new_pages_, 1); }
+  void RecordPrefetch() { Add(&prefetches_, 1); }
+  void RecordEviction(bool dirty) { Add(dirty ? &dirty_evictions_ : &clean_evictions_, 1); }
+  void RecordWriteBacks(uint64_t count) { Add(&write_backs_, count); }
+  void RecordPinWait() { Add(&pin_waits_, 1); }
+
+  /** Record an acquisition of the instance latch that waited for wait_ns nanoseconds, 0 if it did not wait. */
+  void RecordLatchWait(uint64_t wait_ns);
+
+  /** Record that a frame stayed pinned for duration_ns nanoseconds. */
+  void RecordPinDuration(uint64_t duration_ns) {
+    Add(&pin_intervals_, 1);
+    Add(&pin_duration_ns_, duration_ns);
+  }
+
+  uint64_t GetCleanEvictions() const { return clean_evictions_.load(std::memory_order_relaxed); }
+  uint64_t GetDirtyEvictions() const { return dirty_evictions_.load(std::memory_order_relaxed); }
+
+  /** @return a copy of the counters. Counters are read one by one, so the snapshot is not atomic as a whole. */
+  BufferPoolStats Snapshot() const;
+
+ private:
+  static void Add(std::atomic<uint64_t> *counter, uint64_t value) {
+    counter->fetch_add(value, std::memory_order_relaxed);
+  }
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
+  std::atomic<uint64_t> new_pages_{0};
+  std::atomic<uint64_t> prefetches_{0};
+  std::atomic<uint64_t> clean_evictions_{0};
+  std::atomic<uint64_t> dirty_evictions_{0};
+  std::atomic<uint64_t> write_backs_{0};
+  std::atomic<uint64_t> pin_waits_{0};
+  std::array<std::atomic<uint64_t>, BufferPoolStats::LATCH_WAIT_BUCKETS> latch_waits_{};
+  std::atomic<uint64_t> latch_wait_ns_{0};
+  std::atomic<uint64_t> pin_intervals_{0};
+  std::atomic<uint64_t> pin_duration_ns_{0};
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <list>
 #include <mutex>  // NOLINT
 #include <vector>
@@ -23,6 +24,9 @@ namespace bustub {
 
 /**
  * ClockReplacer implements the clock replacement policy, which approximates the Least Recently Used policy.
+ *
+ * Whether a frame is in the replacer and its reference bit are kept in per-frame atomic flags, so Pin and Unpin never
+ * take a latch. Only the clock hand is protected by a latch, taken by Victim and PeekVictims.
  */
 class ClockReplacer : public Replacer {
  public:
@@ -43,10 +47,25 @@ class ClockReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) override;
+
+  /** Takes the frame out of the replacer; the policy keeps no history to tell pages apart. */
+  void SetFramePage(frame_id_t frame_id, page_id_t page_id) override;
+
   size_t Size() override;
 
  private:
-  // TODO(student): implement me!
+  /** Number of frames the replacer tracks. */
+  const size_t num_pages_;
+  /** True for the frames that are in the replacer. */
+  std::atomic<bool> *in_replacer_;
+  /** Reference bits. Set when a frame is unpinned, cleared when the clock hand passes over it. */
+  std::atomic<bool> *referenced_;
+  /** Number of frames in the replacer. */
+  std::atomic<size_t> size_{0};
+  /** The frame the clock hand points to. Protected by latch_. */
+  size_t hand_{0};
+  std::mutex latch_;
 };
 
 }  // namespace bustub
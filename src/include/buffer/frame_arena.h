@@ -0,0 +1,80 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena.h
+//
+// Identification: src/include/buffer/frame_arena.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/** A NUMA node that stands for "no particular node". */
+static constexpr int NO_NUMA_NODE = -1;
+
+/**
+ * FrameArena holds the page data of every frame of a buffer pool instance in a single anonymous mapping, aligned to
+ * and padded to a multiple of the huge page size, so that large pools are covered by few TLB entries.
+ *
+ * The mapping is backed by explicit huge pages when the system has some reserved, and is otherwise advised to use
+ * transparent huge pages. If a NUMA node is given, the mapping is bound to that node before any of it is touched.
+ * Every frame starts out zeroed.
+ */
+class FrameArena {
+ public:
+  /** Size of a huge page on x86-64. */
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  /**
+   * Map the frames of a buffer pool instance.
+   * @param num_frames number of frames
+   * @param numa_node the node to allocate the frames on, or NO_NUMA_NODE to use the default policy
+   */
+  explicit FrameArena(size_t num_frames, int numa_node = NO_NUMA_NODE);
+
+  ~FrameArena();
+
+  FrameArena(const FrameArena &) = delete;
+  FrameArena &operator=(const FrameArena &) = delete;
+
+  /** @return the data of the frame */
+  char *GetFrame(frame_id_t frame_id) const { return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /**
+   * Return the memory of a range of frames to the operating system. The frames stay mapped and read as zeroes when
+   * next touched. With explicit huge pages, only the huge pages entirely within the range are returned.
+   * @param first_frame id of the first frame
+   * @param num_frames number of frames
+   */
+  void Release(frame_id_t first_frame, size_t num_frames);
+
+  /** @return true if the arena is backed by explicit huge pages rather than transparent ones */
+  bool IsUsingHugeTLB() const { return huge_tlb_; }
+
+  /** @return true if the arena is bound to its NUMA node */
+  bool IsBoundToNode() const { return bound_to_node_; }
+
+  /** @return the number of NUMA nodes of the machine, at least 1 */
+  static int NumNumaNodes();
+
+  /** @return the NUMA node of the CPU the calling thread is running on */
+  static int CurrentNumaNode();
+
+ private:
+  /** Size of the mapping. */
+  size_t size_;
+  char *data_;
+  bool huge_tlb_{false};
+  bool bound_to_node_{false};
+};
+
+}  // namespace bustub
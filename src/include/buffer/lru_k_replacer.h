@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy. The victim is the frame whose K-th most recent reference is
+ * the oldest. Frames with fewer than K references have an infinite backward K-distance and are victimized first, in
+ * LRU order, so a page touched once by a sequential scan never pushes out a page that is referenced repeatedly.
+ *
+ * References to a page that follow the first reference of a burst by at most correlated_period ticks are treated as
+ * the same reference, so that a scan reading a page tuple by tuple does not make it look hot. Time is counted in Pin
+ * calls. The history of evicted pages is kept for the last num_pages evictions, so a hot page that is evicted and
+ * read back in gets its history back.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of references to track per page
+   * @param correlated_period the number of ticks after the first reference of a burst during which references to the
+   * same page are considered correlated
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K,
+                        size_t correlated_period = CORRELATED_REFERENCE_PERIOD);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  bool Victim(frame_id_t *frame_id) override;
+
+  void Pin(frame_id_t frame_id) override;
+
+  void Unpin(frame_id_t frame_id) override;
+
+  void PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) override;
+
+  void SetFramePage(frame_id_t frame_id, page_id_t page_id) override;
+
+  size_t Size() override;
+
+ private:
+  /** Reference history of a frame. */
+  struct FrameInfo {
+    /** The page the frame holds. */
+    page_id_t page_id_{INVALID_PAGE_ID};
+    /** Times of the last (up to) K uncorrelated references, most recent first. */
+    std::deque<size_t> history_;
+    /** Time of the most recent reference. */
+    size_t last_access_{0};
+    /** True if the frame is in the replacer. */
+    bool evictable_{false};
+  };
+
+  /** @return the key that orders the frame among the evictable frames with the same number of references */
+  std::pair<size_t, frame_id_t> Key(frame_id_t frame_id) const;
+
+  /** Add the frame to the evictable frames. */
+  void Insert(frame_id_t frame_id);
+
+  /** Remove the frame from the evictable frames. */
+  void Erase(frame_id_t frame_id);
+
+  const size_t k_;
+  const size_t correlated_period_;
+  /** Logical clock, advanced on every Pin. */
+  size_t current_time_{0};
+  std::vector<FrameInfo> frames_;
+  /** Evictable frames with fewer than K references, ordered by most recent reference. */
+  std::set<std::pair<size_t, frame_id_t>> cold_frames_;
+  /** Evictable frames with K references, ordered by K-th most recent reference. */
+  std::set<std::pair<size_t, frame_id_t>> hot_frames_;
+  /** Reference histories of recently evicted pages, and their position in evicted_order_. */
+  std::unordered_map<page_id_t, std::pair<std::deque<size_t>, std::list<page_id_t>::iterator>> evicted_history_;
+  /** Pages in evicted_history_, oldest eviction first. */
+  std::list<page_id_t> evicted_order_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
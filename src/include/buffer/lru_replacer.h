@@ -43,6 +43,11 @@ class LRUReplacer : public Replacer {
 
   void Unpin(frame_id_t frame_id) override;
 
+  void PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) override;
+
+  /** Takes the frame out of the replacer; the policy keeps no history to tell pages apart. */
+  void SetFramePage(frame_id_t frame_id, page_id_t page_id) override;
+
   size_t Size() override;
 
  private:
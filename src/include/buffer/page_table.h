@@ -0,0 +1,83 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of the pages held by a buffer pool instance to their frames. It is an open addressing hash
+ * table with linear probing, sized to stay at most half full, whose slots each pack a (page id, frame id) pair into a
+ * single atomic word. Find takes no latch; Insert and Remove must be serialized by the caller.
+ *
+ * Remove closes the hole it leaves by shifting later entries of the probe sequence back, so a Find racing with it may
+ * miss an entry that is present, and any Find may return an entry that has just been removed. Callers that do not hold
+ * the latch serializing writers must validate a hit against the frame and retry a miss under that latch.
+ */
+class PageTable {
+ public:
+  /**
+   * Create a new PageTable.
+   * @param num_frames the maximum number of entries the table will hold at once
+   */
+  explicit PageTable(size_t num_frames);
+
+  ~PageTable();
+
+  /**
+   * Look up the frame holding a page.
+   * @param page_id id of the page
+   * @param[out] frame_id id of the frame holding the page
+   * @return true if an entry for the page was found
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Map a page to a frame, replacing the existing entry for the page if there is one.
+   * @param page_id id of the page
+   * @param frame_id id of the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Remove the entry for a page.
+   * @param page_id id of the page
+   * @return true if the page had an entry
+   */
+  bool Remove(page_id_t page_id);
+
+ private:
+  /** A slot that holds no entry. Page ids and frame ids are never -1 in a stored entry. */
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+
+  static uint64_t MakeEntry(page_id_t page_id, frame_id_t frame_id) {
+    return static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32 | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t EntryPageId(uint64_t entry) { return static_cast<page_id_t>(entry >> 32); }
+  static frame_id_t EntryFrameId(uint64_t entry) { return static_cast<frame_id_t>(entry & 0xFFFFFFFF); }
+
+  /** @return the first slot of the probe sequence of the page */
+  size_t Home(page_id_t page_id) const;
+
+  /** Number of slots, a power of two. */
+  size_t num_slots_;
+  /** Number of low bits of a slot index. */
+  int slot_bits_;
+  std::atomic<uint64_t> *slots_;
+};
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include "buffer/buffer_pool_manager.h"
 #include "buffer/buffer_pool_manager_instance.h"
@@ -29,9 +30,14 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every BufferPoolManagerInstance
+   * @param numa_aware true to spread the instances' frames over the NUMA nodes, and to create new pages in an
+   * instance on the node of the calling thread when one has room
+   * @param max_pool_size the size each BufferPoolManagerInstance can grow to with Resize, no less than pool_size
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU,
+                            bool numa_aware = false, size_t max_pool_size = 0);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -41,6 +47,28 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override;
 
+  /**
+   * Grow or shrink every instance while the buffer pool keeps serving requests. The number of instances is fixed.
+   * @param pool_size the new pool size of each BufferPoolManagerInstance
+   * @return false if pool_size is 0 or larger than the maximum pool size, true once every instance has the new size
+   */
+  bool Resize(size_t pool_size);
+
+  /** Forward the prefetch hint to the instance responsible for the page. */
+  void PrefetchPage(page_id_t page_id) override;
+
+  /**
+   * Start the background writer of every instance.
+   * @param clean_target number of frames at the head of each instance's eviction order that its writer keeps clean
+   */
+  void RunBackgroundWriter(size_t clean_target);
+
+  /** Stop the background writer of every instance. */
+  void StopBackgroundWriter();
+
+  /** @return the sum of the counters of every instance */
+  BufferPoolStats GetStats() override;
+
  protected:
   /**
    * @param page_id id of page
@@ -90,9 +118,10 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   void FlushAllPgsImp() override;
 
   size_t num_instances_;
-  size_t pool_size_;
-  unsigned int current_index_;
+  /** Cursor that spreads the starting instance of NewPgImp over the instances. */
+  std::atomic<size_t> next_instance_;
   std::vector<BufferPoolManagerInstance *> instances_;
-  std::mutex latch_;
+  /** The NUMA node of each instance's frames, or empty if the pool is not NUMA aware. */
+  std::vector<int> instance_nodes_;
 };
 }  // namespace bustub
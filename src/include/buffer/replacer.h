@@ -12,10 +12,15 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be created with. */
+enum class ReplacerType { LRU, CLOCK, LRU_K, ARC };
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,6 +48,23 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Look at the frames that would be victimized next, without removing them from the replacer.
+   * @param count the maximum number of frames to return
+   * @param[out] frame_ids the frames, in the order Victim would return them
+   */
+  virtual void PeekVictims(size_t count, std::vector<frame_id_t> *frame_ids) = 0;
+
+  /**
+   * Tell the replacer which page a frame holds from now on. The buffer pool calls this when it loads a page into a
+   * frame it has claimed, and with INVALID_PAGE_ID when the frame is freed. Policies that keep history across
+   * evictions use it to tell pages apart. Every policy takes the frame out of the replacer if it is still there: an
+   * unpin that dropped the last pin just before the frame was claimed may put it back late.
+   * @param frame_id the id of the frame
+   * @param page_id the id of the page the frame now holds, or INVALID_PAGE_ID
+   */
+  virtual void SetFramePage(frame_id_t frame_id, page_id_t page_id) = 0;
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
 };
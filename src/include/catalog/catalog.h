@@ -217,11 +217,19 @@ class Catalog {
     auto index = std::make_unique<ExtendibleHashTableIndex<KeyType, ValueType, KeyComparator>>(std::move(meta), bpm_,
                                                                                                hash_function);
 
-    // Populate the index with all tuples in table heap
+    // Populate the index with all tuples in table heap, a batch at a time
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
+    std::vector<std::pair<Tuple, RID>> entries;
     for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
+      entries.emplace_back(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid());
+      if (entries.size() == INDEX_BUILD_BATCH_SIZE) {
+        index->BulkInsertEntries(entries, txn);
+        entries.clear();
+      }
+    }
+    if (!entries.empty()) {
+      index->BulkInsertEntries(entries, txn);
     }
 
     // Get the next OID for the new index
@@ -323,6 +331,9 @@ class Catalog {
   }
 
  private:
+  /** The maximum number of entries inserted into a new index at once while it is populated from its table */
+  static constexpr size_t INDEX_BUILD_BATCH_SIZE = 1024;
+
   [[maybe_unused]] BufferPoolManager *bpm_;
   [[maybe_unused]] LockManager *lock_manager_;
   [[maybe_unused]] LogManager *log_manager_;
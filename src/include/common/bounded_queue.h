@@ -0,0 +1,237 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bounded_queue.h
+//
+// Identification: src/include/common/bounded_queue.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * BoundedQueue is a fixed-capacity FIFO queue that any number of threads push to and pop from without taking a lock.
+ *
+ * The queue is a ring of cells, each with a sequence number telling whether it is ready to be written or read in the
+ * current lap around the ring. A thread claims a position by advancing the enqueue or dequeue counter with a
+ * compare-and-swap and then owns the cell at that position, so that pushes and pops of different cells do not contend.
+ *
+ * TryPush() and TryPop() never block. Push() and Pop() wait while the queue is full or empty: only a thread that has to
+ * wait takes the mutex, and a push or pop takes it only when some thread waits for it. Close() ends the queue, after
+ * which pushes fail and pops fail once the queue is drained.
+ */
+template <typename T>
+class BoundedQueue {
+ public:
+  /**
+   * Create an empty queue.
+   * @param capacity the number of items the queue holds at least; rounded up to a power of two
+   */
+  explicit BoundedQueue(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+      size <<= 1;
+    }
+    mask_ = size - 1;
+    cells_ = std::make_unique<Cell[]>(size);
+    for (size_t i = 0; i < size; i++) {
+      cells_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(BoundedQueue);
+
+  /** @return the number of items the queue holds */
+  size_t GetCapacity() const { return mask_ + 1; }
+
+  /**
+   * Push an item if the queue has room for it.
+   * @param item the item, moved from if it was pushed
+   * @return false if the queue is full
+   */
+  bool TryPush(T *item) {
+    if (!Enqueue(item)) {
+      return false;
+    }
+    Wake(&pop_waiters_, &not_empty_);
+    return true;
+  }
+
+  /**
+   * Pop the oldest item if there is one.
+   * @param[out] item the item
+   * @return false if the queue is empty
+   */
+  bool TryPop(T *item) {
+    if (!Dequeue(item)) {
+      return false;
+    }
+    Wake(&push_waiters_, &not_full_);
+    return true;
+  }
+
+  /**
+   * Push an item, waiting while the queue is full.
+   * @param item the item, moved from if it was pushed
+   * @return false if the queue is closed
+   */
+  bool Push(T *item) {
+    if (closed_.load(std::memory_order_acquire)) {
+      return false;
+    }
+    if (TryPush(item)) {
+      return true;
+    }
+    bool pushed = false;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      push_waiters_.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      while (!closed_.load(std::memory_order_acquire) && !(pushed = Enqueue(item))) {
+        not_full_.wait(lock);
+      }
+      push_waiters_.fetch_sub(1);
+    }
+    if (pushed) {
+      Wake(&pop_waiters_, &not_empty_);
+    }
+    return pushed;
+  }
+
+  /**
+   * Pop the oldest item, waiting while the queue is empty.
+   * @param[out] item the item
+   * @return false if the queue is closed and empty
+   */
+  bool Pop(T *item) {
+    if (TryPop(item)) {
+      return true;
+    }
+    bool popped = false;
+    {
+      std::unique_lock<std::mutex> lock(latch_);
+      pop_waiters_.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      // The queue is checked once more after it is seen closed, for the items pushed before it was.
+      while (!(popped = Dequeue(item)) && !closed_.load(std::memory_order_acquire)) {
+        not_empty_.wait(lock);
+      }
+      if (!popped) {
+        popped = Dequeue(item);
+      }
+      pop_waiters_.fetch_sub(1);
+    }
+    if (popped) {
+      Wake(&push_waiters_, &not_full_);
+    }
+    return popped;
+  }
+
+  /** Close the queue, and wake every thread waiting on it. */
+  void Close() {
+    closed_.store(true, std::memory_order_release);
+    { std::lock_guard<std::mutex> guard(latch_); }
+    not_full_.notify_all();
+    not_empty_.notify_all();
+  }
+
+  /** @return true if the queue is closed */
+  bool IsClosed() const { return closed_.load(std::memory_order_acquire); }
+
+ private:
+  struct Cell {
+    /** The position this cell is next written at, or that plus one once it has been written for it. */
+    std::atomic<size_t> sequence_;
+    T item_;
+  };
+
+  bool Enqueue(T *item) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The cell still holds the item of the previous lap: the queue is full.
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->item_ = std::move(*item);
+    cell->sequence_.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool Dequeue(T *item) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell *cell;
+    while (true) {
+      cell = &cells_[pos & mask_];
+      size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+      auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The cell has not been written in this lap: the queue is empty.
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *item = std::move(cell->item_);
+    cell->sequence_.store(pos + mask_ + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * Wake the threads waiting on a condition if there are any. A waiter counts itself before it checks the queue under
+   * the mutex, and the fences order that against the change just made, so that either the waiter sees the change or
+   * it is counted here; the mutex is then taken so that the notification cannot come before the waiter sleeps.
+   */
+  void Wake(std::atomic<size_t> *waiters, std::condition_variable *cv) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters->load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    { std::lock_guard<std::mutex> guard(latch_); }
+    cv->notify_all();
+  }
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  alignas(64) std::atomic<size_t> enqueue_pos_{0};
+  alignas(64) std::atomic<size_t> dequeue_pos_{0};
+  alignas(64) std::atomic<bool> closed_{false};
+  /** The number of threads waiting in Push() and in Pop(). */
+  std::atomic<size_t> push_waiters_{0};
+  std::atomic<size_t> pop_waiters_{0};
+  /** Only taken to wait, and to wake those who wait. */
+  std::mutex latch_;
+  std::condition_variable not_full_;
+  std::condition_variable not_empty_;
+};
+
+}  // namespace bustub
@@ -13,26 +13,48 @@
 #include <string>
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include "buffer/parallel_buffer_pool_manager.h"
 #include "common/config.h"
+#include "common/exception.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/checkpoint_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
+#include "storage/page/header_page.h"
 
 namespace bustub {
 
 class BustubInstance {
  public:
-  explicit BustubInstance(const std::string &db_file_name) {
+  /**
+   * Open the database in the given file, creating it if it does not exist.
+   * @param db_file_name the file name of the database file
+   * @param pool_size the number of frames of each buffer pool instance
+   * @param num_instances the number of buffer pool instances
+   * @throws Exception if the database was created with a different page size
+   */
+  explicit BustubInstance(const std::string &db_file_name, size_t pool_size = BUFFER_POOL_SIZE,
+                          size_t num_instances = 1) {
     enable_logging = false;
 
     // storage related
     disk_manager_ = new DiskManager(db_file_name);
+    bool new_database = disk_manager_->GetNumPages() == 0;
+    if (!new_database) {
+      CheckPageSize();
+    }
 
     // log related
     log_manager_ = new LogManager(disk_manager_);
 
-    buffer_pool_manager_ = new BufferPoolManagerInstance(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
+    if (num_instances > 1) {
+      buffer_pool_manager_ = new ParallelBufferPoolManager(num_instances, pool_size, disk_manager_, log_manager_);
+    } else {
+      buffer_pool_manager_ = new BufferPoolManagerInstance(pool_size, disk_manager_, log_manager_);
+    }
+    if (new_database) {
+      CreateHeaderPage();
+    }
 
     // txn related
     lock_manager_ = new LockManager();
@@ -60,6 +82,31 @@ class BustubInstance {
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
   CheckpointManager *checkpoint_manager_;
+
+ private:
+  /** Refuse to open a database whose pages are not PAGE_SIZE long, before anything else reads it. */
+  void CheckPageSize() {
+    char *data = new char[PAGE_SIZE]();
+    disk_manager_->ReadPage(HEADER_PAGE_ID, data);
+    uint32_t page_size = HeaderPage::ReadPageSize(data);
+    delete[] data;
+    if (page_size != PAGE_SIZE) {
+      disk_manager_->ShutDown();
+      delete disk_manager_;
+      throw Exception("the database was created with " + std::to_string(page_size) +
+                      " byte pages, but this build uses " + std::to_string(PAGE_SIZE) + " byte pages");
+    }
+  }
+
+  /** Allocate the header page of a new database and record the page size in it. */
+  void CreateHeaderPage() {
+    page_id_t header_page_id;
+    auto *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->NewPage(&header_page_id));
+    BUSTUB_ASSERT(header_page_id == HEADER_PAGE_ID, "The header page must be the first page of the database.");
+    header_page->Init();
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+    buffer_pool_manager_->FlushPage(header_page_id);
+  }
 };
 
 }  // namespace bustub
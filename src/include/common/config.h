@@ -16,6 +16,14 @@
 #include <chrono>  // NOLINT
 #include <cstdint>
 
+// The page size is chosen when building, with -DBUSTUB_PAGE_SIZE=4096, 8192, 16384 or 32768.
+#ifndef BUSTUB_PAGE_SIZE
+#define BUSTUB_PAGE_SIZE 4096
+#endif
+static_assert(BUSTUB_PAGE_SIZE == 4096 || BUSTUB_PAGE_SIZE == 8192 || BUSTUB_PAGE_SIZE == 16384 ||
+                  BUSTUB_PAGE_SIZE == 32768,
+              "BUSTUB_PAGE_SIZE must be 4096, 8192, 16384 or 32768");
+
 namespace bustub {
 
 /** Cycle detection is performed every CYCLE_DETECTION_INTERVAL milliseconds. */
@@ -27,14 +35,29 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/** True if buffer pools should time how long frames stay pinned. Off by default, as it reads the clock on every pin. */
+extern std::atomic<bool> enable_pin_timing;
+
+/** A running background writer looks for dirty victims to write back every BACKGROUND_WRITER_INTERVAL. */
+extern std::chrono::milliseconds background_writer_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
 static constexpr int HEADER_PAGE_ID = 0;                                      // the header page id
-static constexpr int PAGE_SIZE = 4096;                                        // size of a data page in byte
+static constexpr int PAGE_SIZE = BUSTUB_PAGE_SIZE;                            // size of a data page in byte
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int DISK_QUEUE_DEPTH = 64;                                   // max page I/Os in flight per disk
+static constexpr int TABLE_READ_AHEAD_WINDOW = 8;                             // max table pages read ahead of a scan
+static constexpr int LRUK_REPLACER_K = 2;                                     // references tracked by LRU-K
+static constexpr int CORRELATED_REFERENCE_PERIOD = 256;                       // replacer ticks per correlated burst
+static constexpr size_t DEFAULT_QUERY_MEMORY_BUDGET = 64 << 20;               // bytes an operator may hold in memory
+static constexpr size_t EXECUTION_BATCH_SIZE = 1024;                          // rows an executor passes on at once
+static constexpr size_t TABLE_MORSEL_SIZE = 16;                               // table pages a scan claims at once
+static constexpr size_t DEFAULT_QUERY_PARALLELISM = 1;                        // threads a parallel operator runs on
+static constexpr size_t EXCHANGE_QUEUE_CAPACITY = 8;                          // batches an exchange partition holds
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool.h
+//
+// Identification: src/include/common/thread_pool.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <functional>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * ThreadPool runs tasks on worker threads that it keeps from one task to the next, so that a query running in parallel
+ * does not start threads of its own.
+ *
+ * A task may block for as long as it likes, e.g. on a full queue that another task drains: a task is handed to an
+ * idle thread if there is one, and to a new thread otherwise, so that every task submitted runs at once. A thread that
+ * finishes its task waits for the next one.
+ */
+class ThreadPool {
+ public:
+  ThreadPool() = default;
+
+  /** Wait for the tasks submitted to finish, and stop the threads. */
+  ~ThreadPool();
+
+  DISALLOW_COPY_AND_MOVE(ThreadPool);
+
+  /**
+   * Run a task on a thread of the pool.
+   * @param task the task
+   */
+  void Submit(std::function<void()> task);
+
+  /** @return the number of threads of the pool */
+  size_t GetNumThreads();
+
+ private:
+  /** The loop of a thread of the pool. */
+  void Work();
+
+  /** Protects the members below. */
+  std::mutex latch_;
+  /** Signalled when a task is submitted, or when the pool stops. */
+  std::condition_variable cv_;
+  /** The tasks no thread has picked up yet. */
+  std::deque<std::function<void()>> tasks_;
+  std::vector<std::thread> threads_;
+  /** The number of threads waiting for a task. */
+  size_t num_idle_{0};
+  bool shutdown_{false};
+};
+
+}  // namespace bustub
@@ -13,6 +13,7 @@
 #pragma once
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdlib>
 #include <iostream>
 #include <string>
@@ -45,6 +46,20 @@ class HashUtil {
     return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
   }
 
+  /**
+   * The hashes above leave their low bits nearly constant for small integers. Mix every bit of a hash into every other
+   * one, with the finalizer of MurmurHash3, before taking a power of two modulo of it.
+   */
+  static inline hash_t MixHash(hash_t hash) {
+    uint64_t k = hash;
+    k ^= k >> 33;
+    k *= 0xFF51AFD7ED558CCDULL;
+    k ^= k >> 33;
+    k *= 0xC4CEB9FE1A85EC53ULL;
+    k ^= k >> 33;
+    return k;
+  }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR; }
 
   template <typename T>
@@ -14,6 +14,7 @@
 
 #include <queue>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager.h"
@@ -54,6 +55,17 @@ class ExtendibleHashTable {
    */
   bool Insert(Transaction *transaction, const KeyType &key, const ValueType &value);
 
+  /**
+   * Inserts a batch of key-value pairs into the hash table. If the table is empty, the directory is sized for the
+   * whole batch up front and every bucket page is filled once, instead of growing the table through repeated splits.
+   * Otherwise the pairs are inserted one by one.
+   *
+   * @param transaction the current transaction
+   * @param entries the key-value pairs to insert
+   * @return the number of pairs inserted; duplicated pairs are not
+   */
+  size_t BulkInsert(Transaction *transaction, const std::vector<std::pair<KeyType, ValueType>> &entries);
+
   /**
    * Deletes the associated value for the given key.
    *
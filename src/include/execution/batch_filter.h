@@ -0,0 +1,76 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_filter.h
+//
+// Identification: src/include/execution/batch_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+
+#include "catalog/schema.h"
+#include "execution/compiled_expression.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/filter_kernels.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * BatchFilter evaluates a predicate on a whole batch into a SelectionBitmap.
+ *
+ * The predicate is broken down once, when the filter is created. Comparisons between a column and a constant, or
+ * between two columns of the same type, run as FilterKernels when the column type is supported, and AND and OR combine
+ * the bitmaps of their operands. Any other part of the predicate is compiled into a CompiledExpression and evaluated row
+ * by row. A row is selected if the predicate is true for it; false and null both drop it.
+ */
+class BatchFilter {
+ public:
+  /** Create a filter for a predicate on the rows of batches of a schema. */
+  BatchFilter(const AbstractExpression *predicate, const Schema *schema);
+
+  /**
+   * Evaluate the predicate on every row of a batch.
+   * @param batch the batch, of the schema of the filter, without a selection
+   * @param[out] out a bit per row of the batch, set if the row satisfies the predicate
+   */
+  void Evaluate(const TupleBatch &batch, SelectionBitmap *out);
+
+ private:
+  enum class NodeType { ColumnConstant, ColumnColumn, And, Or, Row };
+
+  /** A part of the predicate. */
+  struct Node {
+    NodeType type_;
+    /** The expression of a Row node, compiled. */
+    std::unique_ptr<CompiledExpression> compiled_;
+    /** The comparison of a ColumnColumn or ColumnConstant node, with the left column on the left. */
+    ComparisonType comp_type_{ComparisonType::Equal};
+    uint32_t left_col_idx_{0};
+    uint32_t right_col_idx_{0};
+    /** The constant of a ColumnConstant node, of the type of the column. */
+    Value constant_;
+    /** The operands of an And or Or node. */
+    std::unique_ptr<Node> left_;
+    std::unique_ptr<Node> right_;
+    /** The bitmap of the right operand of an And or Or node. */
+    SelectionBitmap right_bitmap_;
+  };
+
+  /** @return the node evaluating an expression on batches of a schema */
+  static std::unique_ptr<Node> Compile(const AbstractExpression *expr, const Schema *schema);
+
+  /** Evaluate a node on every row of a batch. */
+  static void Evaluate(Node *node, const TupleBatch &batch, SelectionBitmap *out);
+
+  std::unique_ptr<Node> root_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression.h
+//
+// Identification: src/include/execution/compiled_expression.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/**
+ * CompiledExpression is a boolean expression flattened, once per query, into a program of instructions over unboxed
+ * registers, so that evaluating it on a row neither walks the tree through virtual calls nor creates a Value per node.
+ *
+ * Each node of the tree writes one register, holding an integer, a decimal or a timestamp and whether it is null.
+ * Constants are loaded into their registers when the expression is compiled. Columns are read from the arrays of the
+ * batch, and group-by and aggregate terms from their values. The types of the operands of a comparison pick one of
+ * integer, decimal or timestamp instructions; an integer compared with a decimal is converted first, as Value does.
+ * AND and OR follow the three-valued logic of LogicExpression. A node the program does not cover, such as a comparison
+ * of VARCHARs, is evaluated by its expression, and only its result is unboxed.
+ *
+ * The program writes to its registers, so a CompiledExpression may only be evaluated by one thread at a time.
+ */
+class CompiledExpression {
+ public:
+  /**
+   * Compile a boolean expression.
+   * @param expr the expression
+   * @param left_schema the schema of the batch, or of the left batch of a join; nullptr for a HAVING clause
+   * @param right_schema the schema of the right batch of a join, or nullptr
+   */
+  explicit CompiledExpression(const AbstractExpression *expr, const Schema *left_schema = nullptr,
+                              const Schema *right_schema = nullptr);
+
+  /** @return the expression on a row of a batch of the left schema */
+  CmpBool EvaluateInBatch(const TupleBatch *batch, uint32_t row);
+
+  /** @return the expression on a row of a batch of each schema */
+  CmpBool EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                              uint32_t right_row);
+
+  /** @return the expression on the group-by and aggregate values of a group */
+  CmpBool EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates);
+
+  /** @return the number of instructions of the program */
+  size_t GetNumInstructions() const { return program_.size(); }
+
+ private:
+  enum class OpCode : uint8_t {
+    /** Read a column of a batch, stored as the type in the name. */
+    LoadBoolean,
+    LoadTinyint,
+    LoadSmallint,
+    LoadInteger,
+    LoadBigint,
+    LoadDecimal,
+    LoadTimestamp,
+    /** Read a group-by (left_ is 1) or aggregate (left_ is 0) term as the type of type_id_. */
+    LoadTerm,
+    /** Convert the integer of register left_ to a decimal. */
+    IntegerToDecimal,
+    /** Compare registers left_ and right_ as integers, decimals or timestamps. */
+    CompareInteger,
+    CompareDecimal,
+    CompareTimestamp,
+    /** Combine registers left_ and right_, holding booleans. */
+    And,
+    Or,
+    /** Evaluate expr_ as an AbstractExpression. */
+    Interpret,
+  };
+
+  struct Instruction {
+    OpCode op_{OpCode::Interpret};
+    /** The comparison of a Compare instruction. */
+    ComparisonType comp_type_{ComparisonType::Equal};
+    /** The type a LoadTerm or Interpret instruction unboxes its value as. */
+    TypeId type_id_{TypeId::INVALID};
+    /** The register written. */
+    uint32_t out_{0};
+    /** The operand registers; the tuple and column of a column, or the kind and index of a term. */
+    uint32_t left_{0};
+    uint32_t right_{0};
+    /** The expression of an Interpret instruction. */
+    const AbstractExpression *expr_{nullptr};
+  };
+
+  /** The kind of value a register holds, which decides the instructions that read it. */
+  enum class RegisterClass { Boolean, Integer, Decimal, Timestamp };
+
+  struct Register {
+    union {
+      int64_t integer_;
+      double decimal_;
+      uint64_t timestamp_;
+    };
+    bool is_null_;
+  };
+
+  /**
+   * Add the instructions computing a node.
+   * @return the register holding the node, or -1 if the node's value cannot be held in a register
+   */
+  int64_t Compile(const AbstractExpression *expr);
+
+  /** @return a new register of a class */
+  uint32_t NewRegister(RegisterClass register_class);
+
+  /** @return the register holding an integer register as a decimal */
+  uint32_t ToDecimal(uint32_t reg);
+
+  /** Add an instruction evaluating a node as an AbstractExpression. @return its register, or -1 */
+  int64_t CompileInterpret(const AbstractExpression *expr);
+
+  /** @return the class of the registers holding values of a type, or false if they cannot be held in one */
+  static bool GetRegisterClass(TypeId type_id, RegisterClass *register_class);
+
+  /** Store a value, of a type held in a register, in a register. */
+  static void Unbox(const Value &value, Register *reg);
+
+  /** Store a value in a register, cast to the type the register was compiled for if it has another. */
+  static void UnboxAs(const Value &value, TypeId type_id, Register *reg);
+
+  /** Run the program on the rows a source reads its columns, terms and expressions from. */
+  template <typename Source>
+  CmpBool Run(const Source &source);
+
+  const Schema *left_schema_;
+  const Schema *right_schema_;
+  std::vector<Instruction> program_;
+  std::vector<Register> registers_;
+  std::vector<RegisterClass> register_classes_;
+  /** The register holding the expression. */
+  uint32_t result_{0};
+};
+
+}  // namespace bustub
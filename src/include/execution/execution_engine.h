@@ -16,15 +16,20 @@
 
 #include "buffer/buffer_pool_manager.h"
 #include "catalog/catalog.h"
+#include "common/thread_pool.h"
 #include "concurrency/transaction_manager.h"
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 
 /**
  * The ExecutionEngine class executes query plans.
+ *
+ * The root executor is drained on the calling thread. The exchanges of a plan run copies of its pipelines in parallel,
+ * on a thread pool that the engine keeps across queries.
  */
 class ExecutionEngine {
  public:
@@ -49,24 +54,32 @@ class ExecutionEngine {
    */
   bool Execute(const AbstractPlanNode *plan, std::vector<Tuple> *result_set, Transaction *txn,
                ExecutorContext *exec_ctx) {
-    // Construct and executor for the plan
-    auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
+    // The copies of the pipelines that the exchanges of the plan run in parallel run on the engine's threads
+    exec_ctx->SetThreadPool(&thread_pool_);
+    {
+      // Construct and executor for the plan
+      auto executor = ExecutorFactory::CreateExecutor(exec_ctx, plan);
 
-    // Prepare the root executor
-    executor->Init();
+      // Prepare the root executor
+      executor->Init();
 
-    // Execute the query plan
-    try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+      // Execute the query plan, a batch at a time
+      try {
+        TupleBatch batch;
+        while (executor->NextBatch(&batch)) {
+          if (result_set == nullptr) {
+            continue;
+          }
+          for (size_t i = 0; i < batch.Size(); i++) {
+            result_set->push_back(batch.GetTuple(batch.GetRow(i)));
+          }
         }
+      } catch (Exception &e) {
+        // TODO(student): handle exceptions
       }
-    } catch (Exception &e) {
-      // TODO(student): handle exceptions
     }
+    // The executor, destroyed above, has stopped its threads
+    exec_ctx->SetThreadPool(nullptr);
 
     return true;
   }
@@ -78,6 +91,8 @@ class ExecutionEngine {
   [[maybe_unused]] TransactionManager *txn_mgr_;
   /** The catalog used during query execution */
   [[maybe_unused]] Catalog *catalog_;
+  /** The threads the parallel parts of queries run on, kept from one query to the next */
+  ThreadPool thread_pool_;
 };
 
 }  // namespace bustub
@@ -12,15 +12,23 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
 #include "catalog/catalog.h"
+#include "common/thread_pool.h"
 #include "concurrency/transaction.h"
 #include "storage/page/tmp_tuple_page.h"
 
 namespace bustub {
+
+class AbstractPlanNode;
+
 /**
  * ExecutorContext stores all the context necessary to run an executor.
  */
@@ -60,6 +68,98 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /** @return the number of bytes an operator may hold in memory before it spills to temporary pages */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
+  /** Set the number of bytes an operator may hold in memory before it spills to temporary pages. */
+  void SetMemoryBudget(size_t memory_budget) { memory_budget_ = memory_budget; }
+
+  /** @return the number of threads an operator of the query that can run in parallel runs on */
+  size_t GetParallelism() const { return parallelism_; }
+
+  /** Set the number of threads an operator of the query that can run in parallel runs on. */
+  void SetParallelism(size_t parallelism) { parallelism_ = parallelism; }
+
+  /** @return the thread pool the copies of the query's pipelines run on, one of the context's own if none was set */
+  ThreadPool *GetThreadPool() {
+    std::lock_guard<std::mutex> guard(latch_);
+    if (thread_pool_ == nullptr) {
+      if (own_thread_pool_ == nullptr) {
+        own_thread_pool_ = std::make_unique<ThreadPool>();
+      }
+      return own_thread_pool_.get();
+    }
+    return thread_pool_;
+  }
+
+  /** Set the thread pool the copies of the query's pipelines run on, or nullptr for one of the context's own. */
+  void SetThreadPool(ThreadPool *thread_pool) {
+    std::lock_guard<std::mutex> guard(latch_);
+    thread_pool_ = thread_pool;
+  }
+
+  /**
+   * Make the context of the copies of a pipeline that an exchange runs in parallel. The copies run on one thread each,
+   * and split the memory budget between them; executors of the same plan node in them share their state through
+   * GetPipelineState().
+   * @param num_copies the number of copies of the pipeline
+   * @return the context
+   */
+  std::unique_ptr<ExecutorContext> MakePipelineContext(size_t num_copies) {
+    auto exec_ctx = std::make_unique<ExecutorContext>(transaction_, catalog_, bpm_, txn_mgr_, lock_mgr_);
+    exec_ctx->memory_budget_ = memory_budget_ / num_copies;
+    exec_ctx->parallelism_ = parallelism_;
+    exec_ctx->thread_pool_ = GetThreadPool();
+    exec_ctx->num_pipeline_copies_ = num_copies;
+    return exec_ctx;
+  }
+
+  /** @return the number of copies of the pipeline this context runs, 1 if it is not a context of pipeline copies */
+  size_t GetNumPipelineCopies() const { return num_pipeline_copies_; }
+
+  /**
+   * Get the state the copies of a pipeline share for a plan node, such as the pages of a table left to scan.
+   * @param plan the plan node
+   * @param make called to create the state, by the first executor of the plan node to ask for it
+   * @return the state
+   */
+  template <typename T, typename Make>
+  std::shared_ptr<T> GetPipelineState(const AbstractPlanNode *plan, Make &&make) {
+    std::lock_guard<std::mutex> guard(pipeline_latch_);
+    std::shared_ptr<void> &state = pipeline_states_[plan];
+    if (state == nullptr) {
+      state = make();
+    }
+    return std::static_pointer_cast<T>(state);
+  }
+
+  /**
+   * Register a callback that stops what the pipelines of this context wait on; it is called by Cancel(), or at once if
+   * the context is already cancelled.
+   */
+  void OnCancel(std::function<void()> callback) {
+    std::unique_lock<std::mutex> lock(latch_);
+    if (!cancelled_) {
+      cancel_callbacks_.push_back(std::move(callback));
+      return;
+    }
+    lock.unlock();
+    callback();
+  }
+
+  /** Cancel the pipelines of this context, waking those that wait on an exchange so that they stop. */
+  void Cancel() {
+    std::vector<std::function<void()>> callbacks;
+    {
+      std::lock_guard<std::mutex> guard(latch_);
+      cancelled_ = true;
+      callbacks.swap(cancel_callbacks_);
+    }
+    for (auto &callback : callbacks) {
+      callback();
+    }
+  }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +171,24 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The memory budget of each operator of the query */
+  size_t memory_budget_{DEFAULT_QUERY_MEMORY_BUDGET};
+  /** The number of threads of each parallel operator of the query */
+  size_t parallelism_{DEFAULT_QUERY_PARALLELISM};
+  /** The thread pool set for the query, and the context's own, made if none is set */
+  ThreadPool *thread_pool_{nullptr};
+  std::unique_ptr<ThreadPool> own_thread_pool_;
+  /** The number of copies of the pipeline the context runs */
+  size_t num_pipeline_copies_{1};
+  /** The state the copies of the pipeline share, by plan node */
+  std::unordered_map<const AbstractPlanNode *, std::shared_ptr<void>> pipeline_states_;
+  /** Protects the pipeline states, and is held while one is made */
+  std::mutex pipeline_latch_;
+  /** The callbacks Cancel() calls, and whether it was called */
+  std::vector<std::function<void()>> cancel_callbacks_;
+  bool cancelled_{false};
+  /** Protects the thread pool and the cancellation */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -27,8 +27,10 @@ class ExecutorFactory {
    * Creates a new executor given the executor context and plan node.
    * @param exec_ctx The executor context for the created executor
    * @param plan The plan node that needs to be executed
+   * @param rescanned Whether the executor is read again after each Init(), as the inner side of a nested loop join is
    * @return An executor for the given plan in the provided context
    */
-  static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan);
+  static std::unique_ptr<AbstractExecutor> CreateExecutor(ExecutorContext *exec_ctx, const AbstractPlanNode *plan,
+                                                          bool rescanned = false);
 };
 }  // namespace bustub
@@ -13,13 +13,16 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 /**
- * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
- * This is the base class from which all executors in the BustTub execution
- * engine inherit, and defines the minimal interface that all executors support.
+ * The AbstractExecutor implements the Volcano iterator model, producing tuples one at a time with Next() or a batch at
+ * a time with NextBatch(). This is the base class from which all executors in the BustTub execution engine inherit,
+ * and defines the minimal interface that all executors support.
+ *
+ * Between two calls to Init(), an executor is read either with Next() or with NextBatch(), not both.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +49,24 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor.
+   *
+   * By default the batch is filled by calling Next(), so that any executor can be read a batch at a time. Executors
+   * that produce batches natively override this, and implement Next() with NextFromBatch().
+   * @param[out] batch The batch of tuples produced by this executor, in the output schema
+   * @return `true` if the batch has at least one tuple, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    batch->Init(GetOutputSchema());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, rid);
+    }
+    return !batch->IsEmpty();
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
@@ -53,7 +74,37 @@ class AbstractExecutor {
   ExecutorContext *GetExecutorContext() { return exec_ctx_; }
 
  protected:
+  /**
+   * Yield the next tuple of the batches produced by NextBatch().
+   * @param[out] tuple The next tuple
+   * @param[out] rid The next tuple RID
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextFromBatch(Tuple *tuple, RID *rid) {
+    while (batch_pos_ >= batch_.Size()) {
+      if (!NextBatch(&batch_)) {
+        return false;
+      }
+      batch_pos_ = 0;
+    }
+    uint32_t row = batch_.GetRow(batch_pos_++);
+    *tuple = batch_.GetTuple(row);
+    *rid = batch_.GetRid(row);
+    return true;
+  }
+
+  /** Drop the tuples NextFromBatch() has yet to yield; called by Init(). */
+  void ResetBatch() {
+    batch_.Clear();
+    batch_pos_ = 0;
+  }
+
   /** The executor context in which the executor runs */
   ExecutorContext *exec_ctx_;
+
+ private:
+  /** The batch NextFromBatch() yields tuples from, and the position of the next one. */
+  TupleBatch batch_;
+  size_t batch_pos_{0};
 };
 }  // namespace bustub
@@ -19,6 +19,7 @@
 
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -178,6 +179,13 @@ class AggregationExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of tuples from the aggregation.
+   * @param[out] batch The next batch of tuples produced by the aggregation
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the aggregation */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
@@ -185,20 +193,20 @@ class AggregationExecutor : public AbstractExecutor {
   const AbstractExecutor *GetChildExecutor() const;
 
  private:
-  /** @return The tuple as an AggregateKey */
-  AggregateKey MakeAggregateKey(const Tuple *tuple) {
+  /** @return The row of a batch as an AggregateKey */
+  AggregateKey MakeAggregateKey(const TupleBatch *batch, uint32_t row) {
     std::vector<Value> keys;
     for (const auto &expr : plan_->GetGroupBys()) {
-      keys.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+      keys.emplace_back(expr->EvaluateInBatch(batch, row));
     }
     return {keys};
   }
 
-  /** @return The tuple as an AggregateValue */
-  AggregateValue MakeAggregateValue(const Tuple *tuple) {
+  /** @return The row of a batch as an AggregateValue */
+  AggregateValue MakeAggregateValue(const TupleBatch *batch, uint32_t row) {
     std::vector<Value> vals;
     for (const auto &expr : plan_->GetAggregates()) {
-      vals.emplace_back(expr->Evaluate(tuple, child_->GetOutputSchema()));
+      vals.emplace_back(expr->EvaluateInBatch(batch, row));
     }
     return {vals};
   }
@@ -212,5 +220,7 @@ class AggregationExecutor : public AbstractExecutor {
   SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
   SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The HAVING clause, compiled, or nullptr if every group is output */
+  std::unique_ptr<CompiledExpression> having_;
 };
 }  // namespace bustub
@@ -0,0 +1,167 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_executor.h
+//
+// Identification: src/include/execution/executors/exchange_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <exception>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/bounded_queue.h"
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/exchange_plan.h"
+#include "storage/table/tmp_tuple_store.h"
+
+namespace bustub {
+
+/**
+ * Exchange runs the copies of the child pipeline of an exchange plan node on the thread pool of the query, and routes
+ * the batches they produce to the queues of its partitions, one per reader.
+ *
+ * The copies run in a pipeline context of their own. Cancelling the context the exchange is read in closes its queues,
+ * and closing them cancels the pipeline context, so that stopping a parallel query reaches every exchange in it.
+ */
+class Exchange : public std::enable_shared_from_this<Exchange> {
+ public:
+  /**
+   * Create an exchange; Start() runs it.
+   * @param exec_ctx the context the exchange is read in
+   * @param plan the exchange plan node
+   * @param num_partitions the number of readers of the exchange
+   */
+  Exchange(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, size_t num_partitions);
+
+  /** Stop the copies of the pipeline, and wait for them. */
+  ~Exchange();
+
+  DISALLOW_COPY_AND_MOVE(Exchange);
+
+  /** Create the copies of the child pipeline, and start them on the thread pool. */
+  void Start();
+
+  /** @return the partition of a new reader */
+  size_t AddReader();
+
+  /**
+   * Pop the next batch of a partition, waiting for it.
+   * @param partition the partition
+   * @param[out] batch the batch
+   * @return false if every copy of the pipeline is done, and the partition is drained
+   */
+  bool Pop(size_t partition, TupleBatch *batch);
+
+ private:
+  using BatchQueue = BoundedQueue<std::unique_ptr<TupleBatch>>;
+
+  /** Run a copy of the pipeline, pushing its batches to the partitions. */
+  void Produce(AbstractExecutor *copy);
+
+  /**
+   * Send the rows of a batch to the partitions their keys hash to, through a partly filled batch per partition.
+   * @return false if the exchange is closed
+   */
+  bool Repartition(const TupleBatch &batch, std::vector<std::unique_ptr<TupleBatch>> *partials);
+
+  /** @return a batch from those the readers are done with, or a new one */
+  std::unique_ptr<TupleBatch> NewBatch();
+
+  /** Close the queues of the partitions, and cancel the copies of the pipeline. */
+  void Close();
+
+  ExecutorContext *exec_ctx_;
+  const ExchangePlanNode *plan_;
+  /** The context of the copies of the pipeline; declared before them, so that it outlives them. */
+  std::unique_ptr<ExecutorContext> pipeline_ctx_;
+  std::vector<std::unique_ptr<AbstractExecutor>> copies_;
+  /** The queue of each partition. */
+  std::vector<std::unique_ptr<BatchQueue>> partitions_;
+  /** The batches the readers are done with, reused by the copies. */
+  BatchQueue free_batches_;
+  std::atomic<size_t> num_readers_{0};
+  /** The number of copies still pushing batches. */
+  std::atomic<size_t> producing_{0};
+  /** The number of copies still running, and the first error one of them threw. */
+  size_t running_{0};
+  std::exception_ptr error_;
+  std::mutex latch_;
+  /** Signalled when the last copy is done. */
+  std::condition_variable done_cv_;
+};
+
+/**
+ * ExchangeExecutor reads one partition of an exchange.
+ *
+ * A Gather exchange, or any exchange that is not in a copy of a pipeline, has one partition and belongs to its
+ * executor, which starts it afresh on every Init(). The other exchanges have a partition for each copy of the pipeline
+ * they are in, and are shared by the executors of the copies: the first to be initialized starts it, and each reads the
+ * partition it is given. A shared exchange runs once. If its consumer reads it again after each Init(), as the inner
+ * side of a nested loop join is read, its executor spills the tuples it reads to temporary pages, and a later Init()
+ * replays them, without their RIDs, before reading on. Any other shared exchange cannot be read twice: Init() throws
+ * once it has been read.
+ *
+ * With logging enabled, or a parallelism of one, the executor runs its child on the calling thread and passes on its
+ * batches.
+ */
+class ExchangeExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new ExchangeExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The exchange plan to be executed
+   * @param rescanned Whether the exchange is read again after each Init()
+   */
+  ExchangeExecutor(ExecutorContext *exec_ctx, const ExchangePlanNode *plan, bool rescanned = false);
+
+  /** Initialize the exchange */
+  void Init() override;
+
+  /**
+   * Yield the next tuple from the exchange.
+   * @param[out] tuple The next tuple produced by the exchange
+   * @param[out] rid The next tuple RID produced by the exchange
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /**
+   * Yield the next batch of the partition of the exchange.
+   * @param[out] batch The next batch produced by the exchange
+   * @return `true` if the batch has at least one tuple, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
+  /** @return The output schema for the exchange */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
+
+ private:
+  /** The exchange plan node to be executed */
+  const ExchangePlanNode *plan_;
+  /** The child executor, when the exchange runs on the calling thread */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The exchange read, and the partition read */
+  std::shared_ptr<Exchange> exchange_;
+  size_t partition_{0};
+  /** Whether the exchange is shared by the executors of the copies of a pipeline */
+  bool shared_{false};
+  /** Whether the exchange is read again after each Init(), and whether a shared exchange has been read */
+  bool rescanned_;
+  bool read_{false};
+  /** The tuples read from a shared exchange that is rescanned, and the next one to replay while replaying */
+  std::unique_ptr<TmpTupleStore> read_tuples_;
+  std::unique_ptr<TmpTupleIterator> replay_iter_;
+};
+
+}  // namespace bustub
@@ -13,52 +13,32 @@
 #pragma once
 
 #include <memory>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/join_hash_table.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/table/tmp_tuple_store.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-/** HashKey represents a key in the hash table. */
-struct HashJoinKey {
-  /** The key. */
-  Value key_;
-
-  /** The constructor. */
-  HashJoinKey() = default;
-  explicit HashJoinKey(const Value &k) : key_(k) {}
-
-  /**
-   * Compares two aggregate keys for equality.
-   * @param other the other aggregate key to be compared with
-   * @return `true` if both aggregate keys have equivalent group-by expressions, `false` otherwise
-   */
-  bool operator==(const HashJoinKey &other) const { return key_.CompareEquals(other.key_) == CmpBool::CmpTrue; }
-};
-}  // namespace bustub
-
-namespace std {
 /**
- * A hash function for HashJoinKey.
- * @param key the key to be hashed
- * @return the hash value of the key
- */
-template <>
-struct hash<bustub::HashJoinKey> {
-  size_t operator()(const bustub::HashJoinKey &key) const { return bustub::HashUtil::HashValue(&key.key_); }
-};
-}  // namespace std
-
-namespace bustub {
-
-/**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes a hybrid hash JOIN on two tables, building on the left child and probing with the right.
+ *
+ * The build tuples are split by hash into partitions held in memory. Whenever they take more than the query's memory
+ * budget, the largest partition in memory is spilled to temporary pages, and the build and probe tuples that fall in
+ * it later are written out as well. The partitions left in memory are joined as the right child is read; the spilled
+ * ones are then joined one at a time, split again with another hash if they still do not fit. A partition that cannot
+ * be split further, e.g. because its tuples share a single key, is joined by building on one budget-sized chunk of it
+ * at a time and scanning its probe tuples once per chunk.
+ *
+ * Probe tuples are read in batches: their keys are evaluated and hashed once, and the hash table slots of the whole
+ * batch are prefetched before any of them is looked up. The children are read, and the output produced, a batch at a
+ * time.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -83,24 +63,103 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next batch of tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the join */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** The number of partitions the build input is split into, at most. */
+  static constexpr size_t MAX_FANOUT = 8;
+  /** The number of times a partition is split before it is joined in chunks instead. */
+  static constexpr uint32_t MAX_LEVEL = 4;
+  /** The estimated memory taken by a build tuple in a hash table besides its data. */
+  static constexpr size_t TUPLE_OVERHEAD = 64;
+  /** The number of probe tuples looked up together. */
+  static constexpr size_t PROBE_BATCH_SIZE = 64;
+
+  /** A partition of the join inputs. */
+  struct Partition {
+    /** The build tuples held in memory. */
+    JoinHashTable table_;
+    /** The build tuples of the partition once it is spilled; nullptr while it is in memory. */
+    std::unique_ptr<TmpTupleStore> left_;
+    /** The probe tuples of the partition once it is spilled. */
+    std::unique_ptr<TmpTupleStore> right_;
+    /** The number of times the tuples of the partition have been split. */
+    uint32_t level_{0};
+  };
+
+  /** @return the partition of the current pass a join key with the given hash falls in */
+  size_t PartitionOf(hash_t hash) const;
+
+  /** Read the next build tuple of the current pass. @return false if there is none */
+  bool NextLeft(Tuple *tuple);
+
+  /** Read the next probe tuple of the current pass. @return false if there is none */
+  bool NextRight(Tuple *tuple);
+
+  /** Read the build input of the current pass into its partitions, or its next chunk if the pass is chunked. */
+  void Build();
+
+  /** Write the largest partition held in memory out to temporary pages. */
+  void SpillLargest();
+
+  /** Read the next batch of probe tuples and look up their matches. @return false if the probe input is exhausted */
+  bool ProbeBatch();
+
+  /** Move on to the next chunk or spilled partition once the probe input of a pass is exhausted. */
+  bool NextPass();
+
+  /** Append the output row that joins a build tuple with a probe tuple to a batch. */
+  void AppendJoinedRow(TupleBatch *batch, const Tuple &left_tuple, const Tuple &right_tuple);
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
   /** The left child executor that produces tuples for the left side of join. */
   std::unique_ptr<AbstractExecutor> left_child_;
   /** The right child executor that produces tuples for the right side of join. */
   std::unique_ptr<AbstractExecutor> right_child_;
-  /** The hash table for the left child. */
-  std::unordered_map<HashJoinKey, std::vector<std::vector<Value>>> left_ht_;
-  /** The current position in the left child hash table bucket. */
-  int32_t pos_;
-  /** The current tuple of right child. */
-  Tuple right_tuple_;
-  /** The current RID of right child. */
-  RID right_rid_;
+  /** The current batches of the children, and the positions of their next tuples. */
+  TupleBatch left_batch_;
+  size_t left_batch_pos_{0};
+  TupleBatch right_batch_;
+  size_t right_batch_pos_{0};
+  /** The memory the build side may take. */
+  size_t memory_budget_{0};
+  /** The memory the build side currently takes. */
+  size_t memory_used_{0};
+  /** The number of partitions a pass splits its build input into. */
+  size_t fanout_{1};
+  /** The partitions of the current pass; a single one if the pass is chunked. */
+  std::vector<Partition> partitions_;
+  /** The number of times the inputs of the current pass have been split. */
+  uint32_t level_{0};
+  /** The spilled partition joined by the current pass, or nullptr for the first pass, which reads the children. */
+  std::unique_ptr<Partition> source_;
+  /** The positions of the current pass in the tuples of source_. */
+  std::unique_ptr<TmpTupleIterator> left_iter_;
+  std::unique_ptr<TmpTupleIterator> right_iter_;
+  /** True if the current pass builds on source_ one chunk at a time, without splitting it. */
+  bool chunked_{false};
+  /** The spilled partitions still to be joined. */
+  std::vector<std::unique_ptr<Partition>> spilled_;
+  /** The current batch of probe tuples, with the first build row each matches, and their keys and hashes. */
+  std::vector<std::pair<Tuple, const char *>> probes_;
+  std::vector<Value> probe_keys_;
+  std::vector<hash_t> probe_hashes_;
+  std::vector<size_t> probe_partitions_;
+  /** The position of the next probe tuple of the batch. */
+  size_t probe_pos_{0};
+  /** The next build row to join with the current probe tuple. */
+  const char *row_{nullptr};
+  /** The build tuple read from row_. */
+  Tuple left_tuple_;
 };
 
 }  // namespace bustub
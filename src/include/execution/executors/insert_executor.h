@@ -58,6 +58,23 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
  private:
+  /**
+   * Insert a batch of tuples into the table.
+   * @param batch the tuples
+   * @param[out] rids the RIDs of the tuples, in the order of the batch
+   * @return false if the insert failed
+   */
+  bool InsertBatch(const std::vector<Tuple> &batch, std::vector<RID> *rids);
+
+  /** The maximum number of tuples inserted into the table and its indexes at once */
+  static constexpr size_t INSERT_BATCH_SIZE = 1024;
+
+  /**
+   * The number of tuples from which a batch is appended to the end of the table with TableHeap::BulkInsert. Smaller
+   * batches are inserted one tuple at a time, into pages with room found in the table's free space map.
+   */
+  static constexpr size_t BULK_INSERT_THRESHOLD = 256;
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
 
@@ -15,6 +15,7 @@
 #include <memory>
 #include <utility>
 
+#include "execution/compiled_expression.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/nested_loop_join_plan.h"
@@ -24,6 +25,10 @@ namespace bustub {
 
 /**
  * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ *
+ * The join works a batch at a time: each batch of the outer executor is joined with every batch of the inner
+ * executor, so that the inner executor is scanned once per outer batch rather than once per outer tuple. The predicate
+ * is compiled once, and a pair of tuples is joined if it is true for them.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -49,6 +54,13 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of tuples from the join.
+   * @param[out] batch The next batch of tuples produced by the join
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the insert */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
@@ -59,12 +71,17 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
   std::unique_ptr<AbstractExecutor> left_executor_;
   /** The inner executor */
   std::unique_ptr<AbstractExecutor> right_executor_;
-  /** The current tuple from the outer executor */
-  Tuple left_tuple_;
-  /** The current rid from the outer executor */
-  RID left_rid_;
-  /** If left_tuple_ is valid */
-  bool left_valid_;
+  /** The current batch from the outer executor */
+  TupleBatch left_batch_;
+  /** The current batch from the inner executor */
+  TupleBatch right_batch_;
+  /** The rows of the current batches to join next */
+  size_t left_pos_{0};
+  size_t right_pos_{0};
+  /** The predicate of the join, compiled, or nullptr if every pair is joined */
+  std::unique_ptr<CompiledExpression> predicate_;
+  /** If left_batch_ is valid */
+  bool left_valid_{false};
 };
 
 }  // namespace bustub
@@ -12,17 +12,40 @@
 
 #pragma once
 
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
 #include <vector>
 
+#include "execution/batch_filter.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/table/morsel_dispenser.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * The scan is vectorized: it reads a batch of tuples of the table at a time, evaluates the predicate on the batch to
+ * select the rows that satisfy it, and evaluates the output columns on the selected rows. The predicate is evaluated
+ * by a BatchFilter, which compares fixed-size columns with filter kernels.
+ *
+ * The table is read a morsel of pages at a time, claimed from a MorselDispenser, and each worker reads ahead within
+ * its morsel. When the executor context allows more
+ * than one thread, the scan is parallel: Init() starts that many workers, each of which claims morsels, filters and
+ * projects their tuples on its own, and hands its output batches over through a bounded queue that NextBatch() reads
+ * from. The tuples of a parallel scan come out in no particular order. A scan that takes tuple locks, when logging is
+ * enabled, runs on the calling thread, since the lock sets of a transaction are not shared between threads.
+ *
+ * In a copy of a pipeline run by an exchange, the scan runs on the copy's thread, and shares its dispenser with the
+ * scans of the other copies, which split the table between them. Such a scan cannot be read again: Init() throws once
+ * it has been read.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -33,6 +56,9 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /** Stop the workers of a parallel scan. */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -44,17 +70,91 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of tuples from the sequential scan.
+   * @param[out] batch The next batch of tuples produced by the scan
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /** What a thread reading the table needs of its own. */
+  struct ScanWorker {
+    /** The tuples of the table read by the current batch. */
+    TupleBatch scan_batch_;
+    /** The filter evaluating the predicate, or nullptr if there is none. */
+    std::unique_ptr<BatchFilter> filter_;
+    /** The tuples of scan_batch_ that satisfy the predicate, as a bitmap and as positions. */
+    SelectionBitmap bitmap_;
+    std::vector<uint32_t> selection_;
+    /** The pages of the morsel being read, the one being read, and the slot to read next in it. */
+    std::vector<page_id_t> morsel_;
+    size_t page_pos_{0};
+    uint32_t next_slot_{0};
+    /** The read-ahead window, and the position in the morsel up to which pages have been prefetched. */
+    size_t read_ahead_{0};
+    size_t prefetch_end_{0};
+    /** The pages being prefetched. */
+    std::vector<page_id_t> prefetch_;
+  };
+
+  /**
+   * Read tuples of the table until some of them satisfy the predicate, and output them.
+   * @param worker the worker reading
+   * @param[out] batch the output batch
+   * @return false if the worker's morsels and the dispenser are exhausted
+   */
+  bool ScanBatch(ScanWorker *worker, TupleBatch *batch);
+
+  /**
+   * Prefetch the pages of the worker's morsel that follow the page it is starting to read. The window starts at one
+   * page and doubles on every page, up to the read-ahead window of the table, as a TableIterator's does.
+   */
+  void ReadAhead(ScanWorker *worker);
+
+  /** Body of the thread of a worker of a parallel scan: scan batches into the queue until done or stopped. */
+  void RunWorker(ScanWorker *worker);
+
+  /** Stop and join the threads of a parallel scan, if any are running. */
+  void StopWorkers();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
 
   TableInfo *table_info_;
 
-  TableIterator cur_;
+  /** Hands the pages of the table out to the workers, and whether the scans of other pipeline copies share it. */
+  std::shared_ptr<MorselDispenser> dispenser_;
+  bool shared_dispenser_;
+  /** Whether a scan with a shared dispenser has been read. */
+  bool read_{false};
+
+  /** The workers; a serial scan uses the first one on the calling thread. */
+  std::vector<std::unique_ptr<ScanWorker>> workers_;
+
+  /** The threads of the workers of a parallel scan. */
+  std::vector<std::thread> threads_;
+
+  /** Output batches of a parallel scan waiting to be read, and emptied batches for the workers to reuse. */
+  std::deque<std::unique_ptr<TupleBatch>> queue_;
+  std::vector<std::unique_ptr<TupleBatch>> free_batches_;
+
+  /** The number of workers still scanning. */
+  size_t running_workers_{0};
+
+  /** Set to make the workers stop. */
+  bool stopping_{false};
+
+  /** The first exception thrown by a worker, rethrown to the reader. */
+  std::exception_ptr error_;
+
+  /** Protects the queue and the state of the workers. */
+  std::mutex queue_latch_;
 
-  TableIterator end_;
+  /** Signalled when a batch is added to or taken from the queue, or a worker finishes. */
+  std::condition_variable queue_cv_;
 };
 }  // namespace bustub
@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,25 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /**
+   * Returns the value obtained by evaluating a row of a batch.
+   * @param batch The batch
+   * @param row The position of the row in the batch's columns
+   * @return The value obtained by evaluating the row
+   */
+  virtual Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const = 0;
+
+  /**
+   * Returns the value obtained by evaluating a JOIN on rows of two batches.
+   * @param left_batch The left batch
+   * @param left_row The position of the left row in the left batch's columns
+   * @param right_batch The right batch
+   * @param right_row The position of the right row in the right batch's columns
+   * @return The value obtained by evaluating a JOIN on the left and right rows
+   */
+  virtual Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                                    uint32_t right_row) const = 0;
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
@@ -44,6 +44,17 @@ class AggregateValueExpression : public AbstractExpression {
     UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
   }
 
+  /** Invalid operation for `AggregateValueExpression` */
+  Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
+  /** Invalid operation for `AggregateValueExpression` */
+  Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                            uint32_t right_row) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
   /**
    * Returns the value obtained by evaluating the aggregates.
    * @param group_bys The group by values
@@ -54,6 +65,12 @@ class AggregateValueExpression : public AbstractExpression {
     return is_group_by_term_ ? group_bys[term_idx_] : aggregates[term_idx_];
   }
 
+  /** @return true if this expression is a group-by term, false if it is an aggregate */
+  bool IsGroupByTerm() const { return is_group_by_term_; }
+
+  /** @return the index of the term in the group-bys or the aggregates */
+  uint32_t GetTermIdx() const { return term_idx_; }
+
  private:
   /** The flag indicating if this expression is a group-by term */
   bool is_group_by_term_;
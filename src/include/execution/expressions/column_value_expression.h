@@ -45,6 +45,13 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const override { return batch->GetValue(col_idx_, row); }
+
+  Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                            uint32_t right_row) const override {
+    return tuple_idx_ == 0 ? left_batch->GetValue(col_idx_, left_row) : right_batch->GetValue(col_idx_, right_row);
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
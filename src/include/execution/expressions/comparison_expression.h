@@ -53,6 +53,22 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const override {
+    Value lhs = GetChildAt(0)->EvaluateInBatch(batch, row);
+    Value rhs = GetChildAt(1)->EvaluateInBatch(batch, row);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                            uint32_t right_row) const override {
+    Value lhs = GetChildAt(0)->EvaluateJoinInBatch(left_batch, left_row, right_batch, right_row);
+    Value rhs = GetChildAt(1)->EvaluateJoinInBatch(left_batch, left_row, right_batch, right_row);
+    return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
+  }
+
+  /** @return the type of comparison performed */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
@@ -36,6 +36,13 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const override { return val_; }
+
+  Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                            uint32_t right_row) const override {
+    return val_;
+  }
+
  private:
   Value val_;
 };
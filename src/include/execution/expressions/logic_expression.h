@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// logic_expression.h
+//
+// Identification: src/include/execution/expressions/logic_expression.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** LogicType represents the type of logical operation that we want to perform. */
+enum class LogicType { And, Or };
+
+/**
+ * LogicExpression represents two boolean expressions combined with AND or OR, with the three-valued logic of SQL: a
+ * null operand makes the result null unless the other operand decides it.
+ */
+class LogicExpression : public AbstractExpression {
+ public:
+  /** Creates a new logic expression representing (left logic_type right). */
+  LogicExpression(const AbstractExpression *left, const AbstractExpression *right, LogicType logic_type)
+      : AbstractExpression({left, right}, TypeId::BOOLEAN), logic_type_{logic_type} {}
+
+  Value Evaluate(const Tuple *tuple, const Schema *schema) const override {
+    Value lhs = GetChildAt(0)->Evaluate(tuple, schema);
+    Value rhs = GetChildAt(1)->Evaluate(tuple, schema);
+    return ValueFactory::GetBooleanValue(PerformLogic(lhs, rhs));
+  }
+
+  Value EvaluateJoin(const Tuple *left_tuple, const Schema *left_schema, const Tuple *right_tuple,
+                     const Schema *right_schema) const override {
+    Value lhs = GetChildAt(0)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    Value rhs = GetChildAt(1)->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema);
+    return ValueFactory::GetBooleanValue(PerformLogic(lhs, rhs));
+  }
+
+  Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const override {
+    Value lhs = GetChildAt(0)->EvaluateAggregate(group_bys, aggregates);
+    Value rhs = GetChildAt(1)->EvaluateAggregate(group_bys, aggregates);
+    return ValueFactory::GetBooleanValue(PerformLogic(lhs, rhs));
+  }
+
+  Value EvaluateInBatch(const TupleBatch *batch, uint32_t row) const override {
+    Value lhs = GetChildAt(0)->EvaluateInBatch(batch, row);
+    Value rhs = GetChildAt(1)->EvaluateInBatch(batch, row);
+    return ValueFactory::GetBooleanValue(PerformLogic(lhs, rhs));
+  }
+
+  Value EvaluateJoinInBatch(const TupleBatch *left_batch, uint32_t left_row, const TupleBatch *right_batch,
+                            uint32_t right_row) const override {
+    Value lhs = GetChildAt(0)->EvaluateJoinInBatch(left_batch, left_row, right_batch, right_row);
+    Value rhs = GetChildAt(1)->EvaluateJoinInBatch(left_batch, left_row, right_batch, right_row);
+    return ValueFactory::GetBooleanValue(PerformLogic(lhs, rhs));
+  }
+
+  /** @return the type of logical operation performed */
+  LogicType GetLogicType() const { return logic_type_; }
+
+ private:
+  static CmpBool ToCmpBool(const Value &value) {
+    if (value.IsNull()) {
+      return CmpBool::CmpNull;
+    }
+    return value.GetAs<bool>() ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+  }
+
+  CmpBool PerformLogic(const Value &lhs, const Value &rhs) const {
+    CmpBool left = ToCmpBool(lhs);
+    CmpBool right = ToCmpBool(rhs);
+    // The value that decides the result on its own: false for AND, true for OR.
+    CmpBool decisive = logic_type_ == LogicType::And ? CmpBool::CmpFalse : CmpBool::CmpTrue;
+    if (left == decisive || right == decisive) {
+      return decisive;
+    }
+    if (left == CmpBool::CmpNull || right == CmpBool::CmpNull) {
+      return CmpBool::CmpNull;
+    }
+    return logic_type_ == LogicType::And ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+  }
+
+  LogicType logic_type_;
+};
+}  // namespace bustub
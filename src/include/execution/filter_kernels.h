@@ -0,0 +1,96 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels.h
+//
+// Identification: src/include/execution/filter_kernels.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "execution/expressions/comparison_expression.h"
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+/** SelectionBitmap has one bit per row of a batch, set if the row is selected. */
+class SelectionBitmap {
+ public:
+  /** Size the bitmap for a number of rows, none of them selected. */
+  void Reset(size_t num_rows) {
+    num_rows_ = num_rows;
+    words_.assign((num_rows + 63) / 64, 0);
+  }
+
+  /** @return the number of rows the bitmap covers */
+  size_t NumRows() const { return num_rows_; }
+
+  /** @return the bits, 64 rows per word, row i being bit i % 64 of word i / 64 */
+  uint64_t *GetWords() { return words_.data(); }
+  const uint64_t *GetWords() const { return words_.data(); }
+
+  /** @return true if a row is selected */
+  bool IsSet(size_t row) const { return (words_[row / 64] >> (row % 64) & 1) != 0; }
+
+  /** Select a row. */
+  void Set(size_t row) { words_[row / 64] |= uint64_t{1} << (row % 64); }
+
+  /** Keep only the rows also selected by another bitmap of the same size. */
+  void And(const SelectionBitmap &other);
+
+  /** Add the rows selected by another bitmap of the same size. */
+  void Or(const SelectionBitmap &other);
+
+  /** @return the number of rows selected */
+  size_t Count() const;
+
+  /** Write the positions of the selected rows, in increasing order. */
+  void ToSelection(std::vector<uint32_t> *rows) const;
+
+ private:
+  size_t num_rows_{0};
+  std::vector<uint64_t> words_;
+};
+
+/**
+ * FilterKernels compare a whole column of a batch at once, with a constant or with another column, into a
+ * SelectionBitmap. They work on the fixed-size values of the column as an array, without building Values.
+ *
+ * Columns of type INTEGER, BIGINT, DECIMAL and TIMESTAMP are supported. A row whose value, or the constant, is null is
+ * not selected. When the build targets AVX2, a 256-bit register of values is compared per instruction; otherwise, and
+ * for the last rows of a column, values are compared one at a time.
+ */
+class FilterKernels {
+ public:
+  /** @return true if the kernels support columns of a type */
+  static bool IsSupported(TypeId type_id);
+
+  /**
+   * Compare every value of a column with a constant.
+   * @param comp_type the comparison, with the column on the left
+   * @param column the column, of a supported type
+   * @param constant the constant, of the type of the column
+   * @param[out] out a bit per value of the column, set if the comparison is true
+   */
+  static void CompareConstant(ComparisonType comp_type, const ColumnVector &column, const Value &constant,
+                              SelectionBitmap *out);
+
+  /**
+   * Compare the values of two columns of the same size and type, row by row.
+   * @param comp_type the comparison
+   * @param left the left column, of a supported type
+   * @param right the right column, of the type of the left one
+   * @param[out] out a bit per row, set if the comparison is true
+   */
+  static void CompareColumns(ComparisonType comp_type, const ColumnVector &left, const ColumnVector &right,
+                             SelectionBitmap *out);
+};
+
+}  // namespace bustub
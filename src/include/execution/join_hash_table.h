@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table.h
+//
+// Identification: src/include/execution/join_hash_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <vector>
+
+#include "common/util/hash_util.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * JoinHashTable holds the build tuples of a hash join, by join key.
+ *
+ * The tuples are stored serialized, as rows packed in chunks of memory that double in size up to MAX_CHUNK_SIZE, so
+ * that building takes no allocation per tuple. The rows of a key are chained from the table's slot for the key. The
+ * slots are kept in an open addressing table with linear probing, and store the full hash of their key, so that a
+ * probe compares keys only on a hash match. The keys themselves are kept aside, in an array parallel to the slots.
+ *
+ * Row format:
+ * | NextRow (8) | TupleSize (4) | TupleData | (padding to 8 bytes)
+ */
+class JoinHashTable {
+ public:
+  JoinHashTable() = default;
+
+  /**
+   * Add a build tuple.
+   * @param key the join key of the tuple, not null
+   * @param hash the hash of the key
+   * @param tuple the tuple
+   */
+  void Insert(const Value &key, hash_t hash, const Tuple &tuple);
+
+  /**
+   * Find the build tuples of a key.
+   * @param key the join key
+   * @param hash the hash of the key
+   * @return the first row of the key, or nullptr if there is none
+   */
+  const char *Find(const Value &key, hash_t hash) const;
+
+  /** Hint that the slot of a hash is about to be probed, so that the lookups of a batch of probes overlap. */
+  void Prefetch(hash_t hash) const {
+    if (!slots_.empty()) {
+      __builtin_prefetch(&slots_[HashUtil::MixHash(hash) & mask_]);
+    }
+  }
+
+  /** @return the row following a row of the same key, or nullptr if it is the last */
+  static const char *NextRow(const char *row) {
+    const char *next;
+    memcpy(&next, row, sizeof(next));
+    return next;
+  }
+
+  /** Read the tuple of a row. */
+  static void GetTuple(const char *row, Tuple *tuple) { tuple->DeserializeFrom(row + sizeof(char *)); }
+
+  /** Call f on every row of the table. */
+  template <typename F>
+  void ForEachRow(F f) const {
+    for (const Chunk &chunk : chunks_) {
+      for (size_t offset = 0; offset < chunk.used_;) {
+        const char *row = chunk.data_.get() + offset;
+        f(row);
+        uint32_t tuple_size;
+        memcpy(&tuple_size, row + sizeof(char *), sizeof(tuple_size));
+        offset += RowSize(tuple_size);
+      }
+    }
+  }
+
+  /** @return the number of tuples in the table */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+  /** @return the memory the table takes */
+  size_t GetMemory() const { return memory_; }
+
+  /** Remove every tuple and release the memory of the table. */
+  void Clear();
+
+ private:
+  /** The sizes of the first and the largest chunks of rows, unless a row needs a larger one. */
+  static constexpr size_t MIN_CHUNK_SIZE = 1024;
+  static constexpr size_t MAX_CHUNK_SIZE = 64 * 1024;
+
+  /** A slot of the open addressing table. A slot is empty if head_ is nullptr. */
+  struct Slot {
+    hash_t hash_;
+    char *head_;
+  };
+
+  /** A chunk of memory holding rows. */
+  struct Chunk {
+    std::unique_ptr<char[]> data_;
+    size_t size_;
+    size_t used_;
+  };
+
+  /** @return the space a row takes in a chunk */
+  static size_t RowSize(uint32_t tuple_size) {
+    return (sizeof(char *) + sizeof(uint32_t) + tuple_size + alignof(char *) - 1) & ~(alignof(char *) - 1);
+  }
+
+  /** @return space for a row of the given size */
+  char *AllocateRow(size_t row_size);
+
+  /** Double the number of slots. */
+  void Grow();
+
+  std::vector<Slot> slots_;
+  /** The key of each slot in use. */
+  std::vector<Value> keys_;
+  /** Number of slots minus one; the number of slots is a power of two. */
+  size_t mask_{0};
+  /** Number of slots in use, i.e. of distinct keys. */
+  size_t num_keys_{0};
+  size_t num_tuples_{0};
+  std::vector<Chunk> chunks_;
+  size_t next_chunk_size_{MIN_CHUNK_SIZE};
+  size_t memory_{0};
+};
+
+}  // namespace bustub
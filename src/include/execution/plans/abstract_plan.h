@@ -32,6 +32,7 @@ enum class PlanType {
   NestedLoopJoin,
   NestedIndexJoin,
   HashJoin,
+  Exchange,
   MockScan
 };
 
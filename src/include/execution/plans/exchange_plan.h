@@ -0,0 +1,79 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange_plan.h
+//
+// Identification: src/include/execution/plans/exchange_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** ExchangeType enumerates the ways an exchange routes the tuples of its child. */
+enum class ExchangeType {
+  /** Merge the tuples of every copy of the child into one stream. */
+  Gather,
+  /** Send each tuple to the copy of the parent pipeline that the hash of its partition keys selects. */
+  Repartition,
+  /** Send every tuple to every copy of the parent pipeline. */
+  Broadcast
+};
+
+/**
+ * An exchange runs copies of its child pipeline in parallel, as many as the parallelism of the query, and routes the
+ * tuples they produce, in no particular order.
+ *
+ * A Gather exchange makes a parallel pipeline's output one stream. Repartition and Broadcast exchanges feed a pipeline
+ * that is itself copied by a Gather above it, with one partition per copy. The copies of a pipeline split the pages of
+ * the tables they scan between them, so a side of a join that every copy needs whole is read through a Broadcast, and
+ * an aggregation needs the rows of each group in one copy, through a Repartition on its group-bys.
+ *
+ * The output schema of an exchange is that of its child.
+ */
+class ExchangePlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new ExchangePlanNode instance.
+   * @param output_schema the output schema of the exchange, that of its child
+   * @param child the child plan
+   * @param exchange_type how the tuples of the child are routed
+   * @param partition_keys the expressions, over the child's output, that a Repartition exchange hashes
+   */
+  ExchangePlanNode(const Schema *output_schema, const AbstractPlanNode *child, ExchangeType exchange_type,
+                   std::vector<const AbstractExpression *> &&partition_keys = {})
+      : AbstractPlanNode(output_schema, {child}),
+        exchange_type_(exchange_type),
+        partition_keys_(std::move(partition_keys)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Exchange; }
+
+  /** @return how the tuples of the child are routed */
+  ExchangeType GetExchangeType() const { return exchange_type_; }
+
+  /** @return the expressions a Repartition exchange hashes */
+  const std::vector<const AbstractExpression *> &GetPartitionKeys() const { return partition_keys_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Exchange should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  ExchangeType exchange_type_;
+  std::vector<const AbstractExpression *> partition_keys_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,140 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * ColumnVector holds the values of one column for the rows of a TupleBatch.
+ *
+ * Fixed-size values are stored back to back in the format they have in a tuple, a null being its type's null sentinel,
+ * so that the column can be read as a plain array. Variable-length values are kept as Values.
+ */
+class ColumnVector {
+ public:
+  /** Create an empty column of the given type. */
+  explicit ColumnVector(TypeId type_id);
+
+  /** @return the type of the values */
+  TypeId GetTypeId() const { return type_id_; }
+
+  /** @return the number of values */
+  size_t Size() const { return size_; }
+
+  /** @return the value at a position */
+  Value GetValue(uint32_t row) const;
+
+  /** Append a value, cast to the type of the column if it has another. */
+  void Append(const Value &value);
+
+  /** Append a fixed-size value from where it is stored in a tuple. */
+  void AppendRaw(const char *storage);
+
+  /** @return the fixed-size values as an array of T, the C++ type the column's type is stored as */
+  template <typename T>
+  const T *GetData() const {
+    return reinterpret_cast<const T *>(data_.data());
+  }
+
+  /** Remove every value, keeping the memory for the next ones. */
+  void Clear();
+
+ private:
+  TypeId type_id_;
+  /** The size of a value, or 0 if the values have variable length. */
+  uint32_t width_;
+  size_t size_{0};
+  /** The fixed-size values. */
+  std::vector<char> data_;
+  /** The variable-length values. */
+  std::vector<Value> varlen_;
+};
+
+/**
+ * TupleBatch is what an executor produces in one call to NextBatch(): up to EXECUTION_BATCH_SIZE rows of a schema,
+ * stored column by column, with the RID of each row.
+ *
+ * A batch may carry a selection vector, the positions of the rows that are part of it in increasing order, so that a
+ * filter can drop rows without moving the values of the others. The i-th row of a batch, for i < Size(), is at
+ * position GetRow(i) in the columns.
+ */
+class TupleBatch {
+ public:
+  TupleBatch() = default;
+
+  /** Prepare the batch for rows of a schema. The batch is emptied, and keeps its memory if the schema is the same. */
+  void Init(const Schema *schema);
+
+  /** @return the schema of the rows */
+  const Schema *GetSchema() const { return schema_; }
+
+  /** @return the number of rows of the batch */
+  size_t Size() const { return has_selection_ ? selection_.size() : rids_.size(); }
+
+  /** @return true if the batch has no row */
+  bool IsEmpty() const { return Size() == 0; }
+
+  /** @return true if the batch has a selection vector */
+  bool HasSelection() const { return has_selection_; }
+
+  /** @return true if no more rows can be appended */
+  bool IsFull() const { return rids_.size() >= EXECUTION_BATCH_SIZE; }
+
+  /** @return the position in the columns of the i-th row */
+  uint32_t GetRow(size_t i) const { return has_selection_ ? selection_[i] : static_cast<uint32_t>(i); }
+
+  /** @return the values of a column */
+  const ColumnVector &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the value of a column at a position */
+  Value GetValue(uint32_t col_idx, uint32_t row) const { return columns_[col_idx].GetValue(row); }
+
+  /** @return the RID of the row at a position */
+  RID GetRid(uint32_t row) const { return rids_[row]; }
+
+  /** @return the row at a position, as a tuple of the batch's schema */
+  Tuple GetTuple(uint32_t row) const;
+
+  /** Append the value of a column for the row being appended; every column gets one before FinishRow(). */
+  void AppendValue(uint32_t col_idx, const Value &value) { columns_[col_idx].Append(value); }
+
+  /** Complete the row whose values were appended. */
+  void FinishRow(const RID &rid);
+
+  /** Append a tuple of the batch's schema as a row. */
+  void AppendTuple(const Tuple &tuple, const RID &rid);
+
+  /** Keep only the rows at the given positions, in increasing order; no more rows can be appended afterwards. */
+  void Select(const std::vector<uint32_t> &rows);
+
+  /** Remove every row, keeping the memory of the columns. */
+  void Clear();
+
+ private:
+  const Schema *schema_{nullptr};
+  std::vector<ColumnVector> columns_;
+  /** The RID of each row, by position. */
+  std::vector<RID> rids_;
+  bool has_selection_{false};
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,156 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.h
+//
+// Identification: src/include/storage/disk/async_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace bustub {
+
+/**
+ * AsyncDiskManager is a DiskManager whose page reads and writes go through an io_uring instance opened on the database
+ * file with O_DIRECT. Requests from any thread are queued, and a single I/O thread submits everything that is queued
+ * in one batch, keeping up to queue_depth requests in flight. Buffers that are not aligned for O_DIRECT are staged
+ * through aligned bounce buffers.
+ *
+ * If io_uring is unavailable the I/O thread falls back to pread/pwrite, and if the file system rejects O_DIRECT the
+ * file is opened without it, so the async interface keeps working everywhere. The log file is still handled by
+ * DiskManager.
+ */
+class AsyncDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new async disk manager that writes to the specified database file.
+   * @param db_file the file name of the database file to write to
+   * @param queue_depth the maximum number of page requests in flight at once
+   * @param persist_free_map whether to keep the free page map in a .fsm file next to the database file
+   */
+  explicit AsyncDiskManager(const std::string &db_file, uint32_t queue_depth = DISK_QUEUE_DEPTH,
+                            bool persist_free_map = false);
+
+  ~AsyncDiskManager() override;
+
+  /** Drain all queued requests, stop the I/O thread and close all the file resources. */
+  void ShutDown() override;
+
+  /** Write a page to the database file, waiting for the write to complete. */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /** Read a page from the database file, waiting for the read to complete. */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  void WritePageAsync(page_id_t page_id, const char *page_data, DiskCallback callback) override;
+
+  void ReadPageAsync(page_id_t page_id, char *page_data, DiskCallback callback) override;
+
+  /** @return true if requests are submitted through io_uring, false if the pread/pwrite fallback is in use */
+  bool IsUsingIoUring() const { return ring_fd_ >= 0; }
+
+  /** @return true if the database file was opened with O_DIRECT */
+  bool IsUsingDirectIO() const { return direct_io_; }
+
+ private:
+  /** A page read or write waiting for, or undergoing, I/O. */
+  struct DiskRequest {
+    /** True for a write, false for a read. */
+    bool is_write_;
+    /** The page being read or written. */
+    page_id_t page_id_;
+    /** The caller's page buffer. */
+    char *data_;
+    /** Invoked once the request has completed. */
+    DiskCallback callback_;
+  };
+
+  /** Queue a request for the I/O thread. */
+  void Schedule(DiskRequest request);
+
+  /** Body of the I/O thread. */
+  void RunIOThread();
+
+  /** Set up the submission and completion rings. Leaves ring_fd_ negative on failure. */
+  void SetUpRing();
+
+  /** Fill in the submission queue entry for the request occupying the given slot. */
+  void PrepareRequest(uint32_t slot);
+
+  /** Reap every completion that is available, finishing the corresponding requests. */
+  void ReapCompletions();
+
+  /** Finish the request in the given slot whose I/O transferred res bytes (or failed with -errno). */
+  void CompleteRequest(uint32_t slot, int res);
+
+  /** Perform the request in the given slot with pread/pwrite. Used when io_uring is unavailable. */
+  void PerformRequestSync(uint32_t slot);
+
+  /** @return the buffer the kernel should use for the request in the given slot */
+  char *IOBuffer(uint32_t slot);
+
+  /** The maximum number of requests in flight. */
+  const uint32_t queue_depth_;
+  /** File descriptor of the database file used for page I/O. */
+  int db_fd_{-1};
+  /** True if db_fd_ was opened with O_DIRECT. */
+  bool direct_io_{false};
+
+  /** The io_uring file descriptor, or -1 if io_uring is unavailable. */
+  int ring_fd_{-1};
+  /** Submission ring mapping and its size. */
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  /** Completion ring mapping and its size. Equal to the submission ring on kernels with IORING_FEAT_SINGLE_MMAP. */
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  /** Submission queue entries mapping and its size. */
+  io_uring_sqe *sqes_{nullptr};
+  size_t sqes_size_{0};
+  /** Entries placed in the submission ring that the kernel has not consumed yet. */
+  unsigned unsubmitted_{0};
+  /** Pointers into the rings. */
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  io_uring_cqe *cqes_{nullptr};
+
+  /** Requests currently owned by the I/O thread, indexed by slot. */
+  std::vector<DiskRequest> slots_;
+  /** Slots that are not in use. Only touched by the I/O thread. */
+  std::vector<uint32_t> free_slots_;
+  /** Aligned bounce buffers, one page per slot. */
+  char *bounce_buffers_{nullptr};
+
+  /** Requests waiting to be picked up by the I/O thread. */
+  std::deque<DiskRequest> queue_;
+  /** True once ShutDown has been called. */
+  bool shutdown_{false};
+  /** Protects queue_ and shutdown_. */
+  std::mutex queue_latch_;
+  /** Signalled when a request is queued or shutdown is requested. */
+  std::condition_variable queue_cv_;
+  /** The I/O thread. */
+  std::thread *io_thread_{nullptr};
+};
+
+}  // namespace bustub
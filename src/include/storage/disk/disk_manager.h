@@ -14,9 +14,12 @@
 
 #include <atomic>
 #include <fstream>
+#include <functional>
 #include <future>  // NOLINT
 #include <mutex>   // NOLINT
+#include <set>
 #include <string>
+#include <vector>
 
 #include "common/config.h"
 
@@ -25,35 +28,62 @@ namespace bustub {
 /**
  * DiskManager takes care of the allocation and deallocation of pages within a database. It performs the reading and
  * writing of pages to and from disk, providing a logical file layer within the context of a database management system.
+ *
+ * Deallocated pages are recorded in a free page map and are handed out again before the database file grows. If asked
+ * to, the disk manager persists the map next to the database file in a file with the .fsm extension: the map is kept in
+ * memory and written to its file by FlushFreeMap and on shut down. A page is never handed out while the file still
+ * records it as free, so a crash at worst leaks the pages freed since the map was last written. Without the file, pages
+ * freed in an earlier run are not reused.
  */
 class DiskManager {
  public:
+  /** Callback invoked once an asynchronous page read or write has completed. */
+  using DiskCallback = std::function<void()>;
+
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param persist_free_map whether to keep the free page map in a .fsm file next to the database file
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, bool persist_free_map = false);
 
-  ~DiskManager() = default;
+  /** Write the free page map back, if it has not been. */
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual void WritePage(page_id_t page_id, const char *page_data);
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Start writing a page to the database file. The default implementation writes synchronously and then calls back.
+   * @param page_id id of the page
+   * @param page_data raw page data, which must stay valid and unmodified until the callback runs
+   * @param callback invoked, possibly on another thread, once the write has completed
+   */
+  virtual void WritePageAsync(page_id_t page_id, const char *page_data, DiskCallback callback);
+
+  /**
+   * Start reading a page from the database file. The default implementation reads synchronously and then calls back.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer, which must stay valid until the callback runs
+   * @param callback invoked, possibly on another thread, once the read has completed
+   */
+  virtual void ReadPageAsync(page_id_t page_id, char *page_data, DiskCallback callback);
 
   /**
    * Flush the entire log buffer into disk.
@@ -71,6 +101,36 @@ class DiskManager {
    */
   bool ReadLog(char *log_data, int size, int offset);
 
+  /**
+   * Allocate a page, reusing the lowest free page if there is one and growing the database file otherwise. Buffer pool
+   * instances sharing the disk manager each own the page ids congruent to their index, so allocation is striped: the
+   * page returned is congruent to offset modulo stride, and ids skipped to get there are left free for other stripes.
+   * @param stride number of buffer pool instances sharing the disk manager
+   * @param offset index of the calling instance
+   * @return the id of the allocated page
+   */
+  page_id_t AllocatePage(uint32_t stride = 1, uint32_t offset = 0);
+
+  /**
+   * Deallocate a page so that it can be allocated again. Free pages at the end of the database file are truncated
+   * away. The space of other free pages is released by punching holes in the file, if hole punching is enabled.
+   * Deallocating a page that is free or was never allocated does nothing.
+   * @param page_id id of the page
+   */
+  void DeallocatePage(page_id_t page_id);
+
+  /** Write the free page map to its file, if it changed since it was last written. */
+  void FlushFreeMap();
+
+  /** @return true if the page has been deallocated and not allocated again */
+  bool IsFreePage(page_id_t page_id);
+
+  /** @return the number of free pages */
+  size_t GetNumFreePages();
+
+  /** @param punch_holes true to release the disk space of deallocated pages that are not at the end of the file */
+  void SetPunchHoles(bool punch_holes) { punch_holes_ = punch_holes; }
+
   /** @return the number of disk flushes */
   int GetNumFlushes() const;
 
@@ -80,6 +140,12 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of page reads */
+  int GetNumReads() const;
+
+  /** @return the number of pages in the database file, counting a partial page at its end */
+  int GetNumPages();
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -89,8 +155,42 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
- private:
+ protected:
+  /** Creates a disk manager without a database file or log file, for subclasses that keep pages elsewhere. */
+  DiskManager();
+
   int GetFileSize(const std::string &file_name);
+
+  /**
+   * Open the free page map of the database file, or start an empty one.
+   * @param new_db true if the database file was just created, in which case any existing map is stale
+   */
+  void OpenFreeMap(bool new_db);
+
+  /** @return true if the page's bit is set in the bitmap. free_map_latch_ must be held. */
+  static bool TestFreeBit(const std::vector<uint8_t> &bitmap, page_id_t page_id) {
+    auto byte = static_cast<size_t>(page_id) / 8;
+    return page_id >= 0 && byte < bitmap.size() && (bitmap[byte] & (1 << (page_id % 8))) != 0;
+  }
+
+  /** @return true if the page's bit is set in the free page map. free_map_latch_ must be held. */
+  bool TestFreeBit(page_id_t page_id) const { return TestFreeBit(free_bitmap_, page_id); }
+
+  /** Mark a page as free or allocated in the free page map in memory. */
+  void SetFreePage(page_id_t page_id, bool free);
+
+  /** Before a page is handed out, clear its bit in the free page map file if the file still has it set. */
+  void PersistAllocation(page_id_t page_id);
+
+  /** Write the number of page ids in use and the whole bitmap to the free page map file. */
+  void WriteFreeMap();
+
+  /** Sort the free pages into stripes for a new number of buffer pool instances. */
+  void RestripeFreePages(uint32_t stride);
+
+  /** Release the disk space of a free page, truncating the file if the page is at its end. */
+  void ReleasePageSpace(page_id_t page_id);
+
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -99,10 +199,26 @@ class DiskManager {
   std::string file_name_;
   int num_flushes_;
   int num_writes_;
+  std::atomic<int> num_reads_;
   bool flush_log_;
   std::future<void> *flush_log_f_;
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  // stream to write the free page map: | NextPageId (4) | one bit per page id, set if the page is free |
+  std::fstream fsm_io_;
+  std::string fsm_name_;
+  /** Protects the free page map. Taken before db_io_latch_. */
+  std::mutex free_map_latch_;
+  /** One more than the highest page id in use: allocated, or free but not truncated away. */
+  page_id_t next_page_id_{0};
+  std::vector<uint8_t> free_bitmap_;
+  /** The bitmap as it is in the free page map file, and whether the map in memory differs from the file. */
+  std::vector<uint8_t> written_bitmap_;
+  bool free_map_dirty_{false};
+  /** The free pages, by stripe: free_pages_[i] holds the free page ids congruent to i modulo free_pages_.size(). */
+  std::vector<std::set<page_id_t>> free_pages_{1};
+  size_t num_free_pages_{0};
+  bool punch_holes_{false};
 };
 
 }  // namespace bustub
@@ -159,6 +159,18 @@ class Index {
    */
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
+  /**
+   * Insert a batch of entries into the index. Indexes that can build their structure for the whole batch at once
+   * override this; the default inserts the entries one by one.
+   * @param entries The index keys and the RIDs associated with them
+   * @param transaction The transaction context
+   */
+  virtual void BulkInsertEntries(const std::vector<std::pair<Tuple, RID>> &entries, Transaction *transaction) {
+    for (const auto &entry : entries) {
+      InsertEntry(entry.first, entry.second, transaction);
+    }
+  }
+
   /**
    * Delete an index entry by key.
    * @param key The index key
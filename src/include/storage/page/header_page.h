@@ -10,6 +10,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <cstdint>
 #include <cstring>
 #include <string>
 #include "storage/page/page.h"
@@ -19,16 +20,43 @@ namespace bustub {
 /**
  * Database use the first page (page_id = 0) as header page to store metadata, in
  * our case, we will contain information about table/index name (length less than
- * 32 bytes) and their corresponding root_id
+ * 32 bytes) and their corresponding root_id, and the page size the database was
+ * created with.
  *
  * Format (size in byte):
- *  -----------------------------------------------------------------
- * | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
- *  -----------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------------------
+ * | Magic (4) | PageSize (4) | RecordCount (4) | Entry_1 name (32) | Entry_1 root_id (4) | ... |
+ *  ------------------------------------------------------------------------------------------------
+ *
+ * Header pages written before the page size was recorded have no magic word. They start with the record count, the
+ * entries follow it at offset 4, and their pages are 4096 bytes long. They are read and updated in that layout.
  */
 class HeaderPage : public Page {
  public:
-  void Init() { SetRecordCount(0); }
+  void Init() {
+    uint32_t magic = MAGIC;
+    memcpy(GetData() + OFFSET_MAGIC, &magic, sizeof(magic));
+    SetPageSize(PAGE_SIZE);
+    SetRecordCount(0);
+  }
+
+  /** @return the page size the database was created with */
+  uint32_t GetPageSize() { return ReadPageSize(GetData()); }
+
+  /**
+   * Read the page size from the raw data of a header page. The page size is at the same offset whatever the page
+   * size, so a header page read with the wrong page size still tells which one is right.
+   * @param data the raw data of the header page
+   * @return the page size the database was created with
+   */
+  static uint32_t ReadPageSize(const char *data) {
+    if (!HasMagic(data)) {
+      return LEGACY_PAGE_SIZE;
+    }
+    uint32_t page_size;
+    memcpy(&page_size, data + OFFSET_PAGE_SIZE, sizeof(page_size));
+    return page_size;
+  }
   /**
    * Record related
    */
@@ -47,5 +75,34 @@ class HeaderPage : public Page {
   int FindRecord(const std::string &name);
 
   void SetRecordCount(int record_count);
+
+  void SetPageSize(uint32_t page_size) { memcpy(GetData() + OFFSET_PAGE_SIZE, &page_size, sizeof(page_size)); }
+
+  /** @return true if the header page starts with the magic word, false if it has the legacy layout */
+  static bool HasMagic(const char *data) {
+    uint32_t magic;
+    memcpy(&magic, data + OFFSET_MAGIC, sizeof(magic));
+    return magic == MAGIC;
+  }
+
+  /** @return the offset of the record count */
+  size_t RecordCountOffset() { return HasMagic(GetData()) ? OFFSET_RECORD_COUNT : 0; }
+
+  /** @return the offset of the first record */
+  size_t RecordsOffset() { return HasMagic(GetData()) ? OFFSET_RECORDS : LEGACY_OFFSET_RECORDS; }
+
+  /** Marks a header page that records its page size. No legacy header page has that many records. */
+  static constexpr uint32_t MAGIC = 0x42545548;
+  /** Page size of the databases whose header page has the legacy layout. */
+  static constexpr uint32_t LEGACY_PAGE_SIZE = 4096;
+  static constexpr size_t OFFSET_MAGIC = 0;
+  static constexpr size_t OFFSET_PAGE_SIZE = 4;
+  static constexpr size_t OFFSET_RECORD_COUNT = 8;
+  /** Offset of the first record. */
+  static constexpr size_t OFFSET_RECORDS = 12;
+  /** Offset of the first record in the legacy layout. */
+  static constexpr size_t LEGACY_OFFSET_RECORDS = 4;
+  /** Size of a record: name and root page id. */
+  static constexpr size_t RECORD_SIZE = 36;
 };
 }  // namespace bustub
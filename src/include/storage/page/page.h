@@ -12,6 +12,8 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
@@ -30,8 +32,8 @@ class Page {
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. The buffer pool points the page at its frame's data, which starts out zeroed. */
+  Page() = default;
 
   /** Default destructor. */
   ~Page() = default;
@@ -43,7 +45,7 @@ class Page {
   inline page_id_t GetPageId() { return page_id_; }
 
   /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  inline int GetPinCount() { return std::max(pin_count_.load(), 0); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
@@ -57,6 +59,9 @@ class Page {
   /** Acquire the page read latch. */
   inline void RLatch() { rwlatch_.RLock(); }
 
+  /** Acquire the page read latch if it is free of writers. @return true if it was acquired */
+  inline bool TryRLatch() { return rwlatch_.TryRLock(); }
+
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
@@ -78,14 +83,21 @@ class Page {
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /**
+   * The actual data that is stored within a page. It lives in the buffer pool's frame arena rather than next to the
+   * book-keeping fields, so that the data of all the frames is contiguous and can be backed by huge pages.
+   */
+  char *data_{nullptr};
+  // The book-keeping fields are atomic because the buffer pool pins and unpins pages that are already in the pool
+  // without taking its latch.
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_{INVALID_PAGE_ID};
+  /** The pin count of this page, or -1 while the frame holds no page or is being evicted. */
+  std::atomic<int> pin_count_{0};
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_{false};
+  /** True while the buffer pool is writing back the previous occupant of this frame or reading this page in. */
+  std::atomic<bool> io_in_progress_{false};
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
 };
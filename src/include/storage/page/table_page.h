@@ -137,6 +137,14 @@ class TablePage : public Page {
    */
   bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
 
+  /** @return the number of bytes left for new tuples and their slots */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the free space InsertTuple needs to insert the tuple */
+  static uint32_t SpaceNeeded(const Tuple &tuple) { return tuple.GetLength() + SIZE_TUPLE; }
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
@@ -166,10 +174,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
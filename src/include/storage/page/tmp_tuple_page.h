@@ -6,31 +6,77 @@
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds tuples that an operator writes out temporarily, e.g. to spill data that does not fit in memory.
+ * Tuples are only ever appended, from the end of the page towards its header, and are addressed by their offset.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
  * | PageId (4) | LSN (4) | FreeSpace (4) | (free space) | TupleSize2 | TupleData2 | TupleSize1 | TupleData1 |
  *
- * We choose this format because DeserializeExpression expects to read Size followed by Data.
+ * FreeSpace is the offset of the last tuple inserted, i.e. where the free space ends. We choose this format because
+ * DeserializeExpression expects to read Size followed by Data.
  */
 class TmpTuplePage : public Page {
  public:
+  /** Size of the page header. */
+  static constexpr uint32_t HEADER_SIZE = 12;
+
   void Init(page_id_t page_id, uint32_t page_size) {
     memcpy(GetData(), &page_id, sizeof(page_id_t));
-    memcpy(GetData() + sizeof(page_id_t), &page_size, sizeof(uint32_t));
+    memset(GetData() + OFFSET_LSN, 0, sizeof(lsn_t));
+    SetFreeSpacePointer(page_size);
+  }
+
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /** @return the offset of the last tuple inserted, or the page size if the page is empty */
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  /** @return the number of bytes a tuple takes in a TmpTuplePage */
+  static uint32_t SpaceNeeded(const Tuple &tuple) { return sizeof(uint32_t) + tuple.GetLength(); }
+
+  /**
+   * Append a tuple to the page.
+   * @param tuple the tuple to append
+   * @param[out] out the location of the appended tuple
+   * @return true if the tuple fit in the page
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out) {
+    uint32_t free_space_pointer = GetFreeSpacePointer();
+    uint32_t space_needed = SpaceNeeded(tuple);
+    if (free_space_pointer < HEADER_SIZE + space_needed) {
+      return false;
+    }
+    free_space_pointer -= space_needed;
+    tuple.SerializeTo(GetData() + free_space_pointer);
+    SetFreeSpacePointer(free_space_pointer);
+    *out = TmpTuple(GetTablePageId(), free_space_pointer);
+    return true;
   }
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /**
+   * Read the tuple at an offset.
+   * @param offset offset of the tuple, as returned by Insert or NextOffset
+   * @param[out] tuple the tuple read
+   */
+  void Get(size_t offset, Tuple *tuple) { tuple->DeserializeFrom(GetData() + offset); }
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /** @return the offset of the tuple inserted just before the one at offset; the page size if there is none */
+  size_t NextOffset(size_t offset) {
+    return offset + sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset);
+  }
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_LSN = 4;
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
@@ -0,0 +1,59 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.h
+//
+// Identification: src/include/storage/table/morsel_dispenser.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <mutex>  // NOLINT
+#include <vector>
+
+#include "common/config.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * MorselDispenser hands out the pages of a table heap to the threads of a parallel scan, a morsel at a time: each call
+ * to Next() claims the next few pages of the page chain, so that every page goes to exactly one thread and a thread
+ * that reads its pages faster simply claims more of them.
+ *
+ * The dispenser walks the page chain from the part the table heap already knows, and reads a page only to learn the
+ * page that follows it when it does not. Reading ahead within a morsel is left to the thread that claimed it.
+ */
+class MorselDispenser {
+ public:
+  /**
+   * Create a dispenser of the pages of a table heap, starting from its first page.
+   * @param table_heap the table heap
+   * @param morsel_size the number of pages of a morsel
+   */
+  explicit MorselDispenser(TableHeap *table_heap, size_t morsel_size = TABLE_MORSEL_SIZE);
+
+  /**
+   * Claim the next morsel.
+   * @param[out] page_ids the pages of the morsel, in the order of the page chain
+   * @return false if every page has been claimed
+   */
+  bool Next(std::vector<page_id_t> *page_ids);
+
+  /** Start handing out the pages again from the first page. */
+  void Reset();
+
+ private:
+  TableHeap *table_heap_;
+  size_t morsel_size_;
+  /** The first page of the next morsel, or INVALID_PAGE_ID if every page has been claimed. */
+  page_id_t next_page_id_;
+  /** Protects next_page_id_. */
+  std::mutex latch_;
+};
+
+}  // namespace bustub
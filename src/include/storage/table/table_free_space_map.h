@@ -0,0 +1,68 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_free_space_map.h
+//
+// Identification: src/include/storage/table/table_free_space_map.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <mutex>  // NOLINT
+#include <set>
+#include <unordered_map>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * TableFreeSpaceMap records roughly how much free space each page of a table heap has, so that an insert can go
+ * straight to a page with room instead of walking the page chain. The free space of a page is kept as one of
+ * NUM_CLASSES classes: a page of class c has at least c * PAGE_SIZE / NUM_CLASSES free bytes.
+ *
+ * The map lives in memory and only knows the pages the table heap has seen since it was opened. It is a hint: a page
+ * found in it must be checked under its latch, and its entry updated with what was found.
+ */
+class TableFreeSpaceMap {
+ public:
+  /** Number of free space classes, so that a class fits in 4 bits. */
+  static constexpr uint32_t NUM_CLASSES = 16;
+
+  /**
+   * Record the free space of a page.
+   * @param page_id id of the page
+   * @param free_space number of free bytes in the page
+   */
+  void Update(page_id_t page_id, uint32_t free_space);
+
+  /**
+   * Find a page that has at least free_space free bytes, among those of the smallest class that guarantees it.
+   * Callers that pass different hints tend to get different pages, so that concurrent inserts do not all go to the
+   * same page.
+   * @param free_space number of free bytes needed
+   * @param hint any value, for example derived from the calling thread
+   * @return id of the page, or INVALID_PAGE_ID if no page is known to have enough free space
+   */
+  page_id_t FindPage(uint32_t free_space, size_t hint);
+
+  /** @return the number of pages in the map */
+  size_t GetNumPages();
+
+ private:
+  /** Number of bytes each class stands for. */
+  static constexpr uint32_t CLASS_SIZE = PAGE_SIZE / NUM_CLASSES;
+
+  /** Class of every page in the map. */
+  std::unordered_map<page_id_t, uint32_t> page_classes_;
+  /** The pages of every class. */
+  std::array<std::set<page_id_t>, NUM_CLASSES> class_pages_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
@@ -12,9 +12,16 @@
 
 #pragma once
 
+#include <atomic>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/table/table_free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
 
@@ -26,6 +33,7 @@ namespace bustub {
  */
 class TableHeap {
   friend class TableIterator;
+  friend class MorselDispenser;
 
  public:
   ~TableHeap() = default;
@@ -59,6 +67,17 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Insert a batch of tuples, packing them in order into the last page of the table and then into new pages appended
+   * to it. Each page is fetched and latched once for all the tuples it takes. Calling this repeatedly loads a stream
+   * of tuples into densely packed pages.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples, in the order of tuples
+   * @param txn the transaction performing the insert
+   * @return true iff every tuple was inserted
+   */
+  bool BulkInsert(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -99,6 +118,40 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read the tuples of a page in slot order, fetching and latching the page once for all of them.
+   * @param page_id the page to read
+   * @param[in,out] next_slot the slot to start reading at; set past the last tuple read
+   * @param txn the transaction performing the read
+   * @param visit called with each tuple read, stops the read when it returns false
+   * @return true if every tuple of the page from next_slot on was read
+   */
+  template <typename Visitor>
+  bool ScanPage(page_id_t page_id, uint32_t *next_slot, Transaction *txn, Visitor &&visit) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame left to read a page of the table.");
+    }
+    page->RLatch();
+    RID rid;
+    bool valid = *next_slot == 0 ? page->GetFirstTupleRid(&rid)
+                                 : page->GetNextTupleRid(RID(page_id, *next_slot - 1), &rid);
+    Tuple tuple;
+    bool more = true;
+    while (valid && more) {
+      *next_slot = rid.GetSlotNum() + 1;
+      if (page->GetTuple(rid, &tuple, txn, lock_manager_)) {
+        more = visit(tuple);
+      }
+      RID next_rid;
+      valid = page->GetNextTupleRid(rid, &next_rid);
+      rid = next_rid;
+    }
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    return !valid;
+  }
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -108,11 +161,63 @@ class TableHeap {
   /** @return the id of the first page of this table */
   inline page_id_t GetFirstPageId() const { return first_page_id_; }
 
+  /** @return the maximum number of pages a sequential scan prefetches ahead of the page it is reading */
+  inline size_t GetReadAheadWindow() const { return read_ahead_window_; }
+
+  /** @param window the maximum number of pages a sequential scan prefetches ahead, 0 disables read-ahead */
+  inline void SetReadAheadWindow(size_t window) { read_ahead_window_ = window; }
+
+  /**
+   * Ask the buffer pool to prefetch pages a scan is about to read, no more than the quarter of the buffer pool it keeps
+   * for prefetched pages.
+   * @param page_ids the pages, in the order the scan reads them
+   * @return the number of pages, from the first, that were asked for
+   */
+  size_t PrefetchPages(const std::vector<page_id_t> &page_ids);
+
+  /** @return the free space map of this table */
+  TableFreeSpaceMap *GetFreeSpaceMap() { return &free_space_map_; }
+
  private:
+  /**
+   * Record that next_page_id follows page_id in the page chain. Only extends the known part of the chain, since
+   * pages are never unlinked.
+   */
+  void RecordNextPageId(page_id_t page_id, page_id_t next_page_id);
+
+  /**
+   * @return the page that follows a page in the page chain, from the known part of the chain if it is there, or
+   * INVALID_PAGE_ID if it is the last page
+   */
+  page_id_t GetNextPageId(page_id_t page_id);
+
+  /**
+   * Insert a tuple into a page with room for it found in the free space map.
+   * @return false if no page in the map took the tuple
+   */
+  bool InsertIntoFreePage(const Tuple &tuple, RID *rid, Transaction *txn);
+
+  /**
+   * Prefetch up to count pages that follow page_id in the known part of the page chain.
+   * @param page_id the page the scan is currently reading
+   * @param count number of pages to prefetch
+   */
+  void ReadAhead(page_id_t page_id, size_t count);
+
   BufferPoolManager *buffer_pool_manager_;
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  /** Maximum number of pages a sequential scan prefetches ahead. */
+  std::atomic<size_t> read_ahead_window_{TABLE_READ_AHEAD_WINDOW};
+  /** The page chain as far as it is known, in order, so that scans can look ahead without reading the pages. */
+  std::vector<page_id_t> page_ids_;
+  /** Position of every page in page_ids_. */
+  std::unordered_map<page_id_t, size_t> page_positions_;
+  /** Protects page_ids_ and page_positions_. */
+  std::mutex page_ids_latch_;
+  /** Free space of the pages seen since the table was opened. */
+  TableFreeSpaceMap free_space_map_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,123 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_store.h
+//
+// Identification: src/include/storage/table/tmp_tuple_store.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+class TmpTupleStore;
+
+/**
+ * TmpTupleIterator scans a TmpTupleStore in the order the tuples were appended. It reads the tuples of one page at a
+ * time, and holds no page pinned between calls.
+ */
+class TmpTupleIterator {
+ public:
+  TmpTupleIterator(TmpTupleStore *store, size_t page_index);
+
+  inline bool operator==(const TmpTupleIterator &itr) const {
+    return page_index_ == itr.page_index_ && tuple_index_ == itr.tuple_index_;
+  }
+
+  inline bool operator!=(const TmpTupleIterator &itr) const { return !(*this == itr); }
+
+  const Tuple &operator*() { return tuples_[tuple_index_]; }
+
+  Tuple *operator->() { return &tuples_[tuple_index_]; }
+
+  TmpTupleIterator &operator++();
+
+ private:
+  /** Read the tuples of the page at page_index_, or move to the end if there is none. */
+  void LoadPage();
+
+  TmpTupleStore *store_;
+  size_t page_index_;
+  /** Position of the current tuple in tuples_. */
+  size_t tuple_index_{0};
+  /** The tuples of the current page, in the order they were appended. */
+  std::vector<Tuple> tuples_;
+};
+
+/**
+ * TmpTupleStore is an append-only store of temporary tuples in TmpTuplePages, for operators whose intermediate
+ * results may not fit in memory. The pages come from the buffer pool and are evicted and written out like any other,
+ * except for the page being appended to, which stays pinned until it is full. The pages are deleted with the store.
+ *
+ * A store is not thread-safe; it is meant to be filled and read by a single operator.
+ */
+class TmpTupleStore {
+  friend class TmpTupleIterator;
+
+ public:
+  explicit TmpTupleStore(BufferPoolManager *buffer_pool_manager);
+
+  ~TmpTupleStore();
+
+  TmpTupleStore(const TmpTupleStore &) = delete;
+  TmpTupleStore &operator=(const TmpTupleStore &) = delete;
+
+  /**
+   * Append a tuple to the store.
+   * @param tuple the tuple to append
+   * @param[out] out the location of the appended tuple, if not nullptr
+   * @return false if the tuple is larger than a page or no page could be allocated
+   */
+  bool Append(const Tuple &tuple, TmpTuple *out = nullptr);
+
+  /**
+   * Read a tuple back.
+   * @param location the location returned by Append
+   * @param[out] tuple the tuple read
+   * @return false if the page could not be fetched
+   */
+  bool Get(const TmpTuple &location, Tuple *tuple);
+
+  /** Delete every page of the store. */
+  void Clear();
+
+  /** Unpin the page being appended to, once no more tuples are expected; a later Append starts a new page. */
+  void ReleaseTailPage();
+
+  /** @return an iterator on the first tuple appended */
+  TmpTupleIterator Begin() { return TmpTupleIterator(this, 0); }
+
+  /** @return the iterator past the last tuple appended */
+  TmpTupleIterator End() { return TmpTupleIterator(this, page_ids_.size()); }
+
+  /** @return the number of tuples in the store */
+  size_t GetNumTuples() const { return num_tuples_; }
+
+  /** @return the number of pages of the store */
+  size_t GetNumPages() const { return page_ids_.size(); }
+
+  /** @return the number of bytes the tuples take in the store's pages */
+  size_t GetSize() const { return size_; }
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  /** The pages of the store, in the order they were allocated. */
+  std::vector<page_id_t> page_ids_;
+  /** The last page, pinned while tuples are appended to it; nullptr once it is full. */
+  TmpTuplePage *tail_page_{nullptr};
+  size_t num_tuples_{0};
+  size_t size_{0};
+};
+
+}  // namespace bustub
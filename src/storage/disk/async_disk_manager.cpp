@@ -0,0 +1,308 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// async_disk_manager.cpp
+//
+// Identification: src/storage/disk/async_disk_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/async_disk_manager.h"
+
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/** O_DIRECT requires buffers, offsets and sizes aligned to the logical block size; a page boundary always is. */
+static constexpr size_t DIRECT_IO_ALIGNMENT = 4096;
+
+static int IoUringSetup(unsigned entries, io_uring_params *params) {
+  return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+static int IoUringEnter(int ring_fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+  return static_cast<int>(syscall(__NR_io_uring_enter, ring_fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+AsyncDiskManager::AsyncDiskManager(const std::string &db_file, uint32_t queue_depth, bool persist_free_map)
+    : DiskManager(db_file, persist_free_map), queue_depth_(queue_depth), slots_(queue_depth) {
+  db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT | O_DIRECT, 0644);
+  if (db_fd_ >= 0) {
+    direct_io_ = true;
+  } else {
+    // Some file systems (e.g. tmpfs) do not support O_DIRECT.
+    db_fd_ = open(db_file.c_str(), O_RDWR | O_CREAT, 0644);
+    if (db_fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+  }
+
+  void *buffers = nullptr;
+  if (posix_memalign(&buffers, DIRECT_IO_ALIGNMENT, static_cast<size_t>(queue_depth_) * PAGE_SIZE) != 0) {
+    close(db_fd_);
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "can't allocate disk bounce buffers");
+  }
+  bounce_buffers_ = static_cast<char *>(buffers);
+  for (uint32_t i = queue_depth_; i > 0; --i) {
+    free_slots_.push_back(i - 1);
+  }
+
+  SetUpRing();
+  io_thread_ = new std::thread(&AsyncDiskManager::RunIOThread, this);
+}
+
+AsyncDiskManager::~AsyncDiskManager() {
+  ShutDown();
+  if (ring_fd_ >= 0) {
+    munmap(sqes_, sqes_size_);
+    if (cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    close(ring_fd_);
+  }
+  free(bounce_buffers_);
+}
+
+void AsyncDiskManager::SetUpRing() {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  ring_fd_ = IoUringSetup(queue_depth_, &params);
+  if (ring_fd_ < 0) {
+    LOG_DEBUG("io_uring unavailable, falling back to pread/pwrite");
+    return;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                  IORING_OFF_SQ_RING);
+  cq_ring_ = single_mmap ? sq_ring_
+                         : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_,
+                                IORING_OFF_CQ_RING);
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  void *sqes = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd_, IORING_OFF_SQES);
+  if (sq_ring_ == MAP_FAILED || cq_ring_ == MAP_FAILED || sqes == MAP_FAILED) {
+    LOG_DEBUG("can't map io_uring rings, falling back to pread/pwrite");
+    if (sqes != MAP_FAILED) {
+      munmap(sqes, sqes_size_);
+    }
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+      munmap(sq_ring_, sq_ring_size_);
+    }
+    close(ring_fd_);
+    ring_fd_ = -1;
+    return;
+  }
+  sqes_ = static_cast<io_uring_sqe *>(sqes);
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+}
+
+void AsyncDiskManager::ShutDown() {
+  {
+    std::lock_guard<std::mutex> guard(queue_latch_);
+    if (shutdown_) {
+      return;
+    }
+    shutdown_ = true;
+  }
+  queue_cv_.notify_one();
+  io_thread_->join();
+  delete io_thread_;
+  io_thread_ = nullptr;
+  close(db_fd_);
+  DiskManager::ShutDown();
+}
+
+void AsyncDiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  std::promise<void> done;
+  WritePageAsync(page_id, page_data, [&done] { done.set_value(); });
+  done.get_future().wait();
+}
+
+void AsyncDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  std::promise<void> done;
+  ReadPageAsync(page_id, page_data, [&done] { done.set_value(); });
+  done.get_future().wait();
+}
+
+void AsyncDiskManager::WritePageAsync(page_id_t page_id, const char *page_data, DiskCallback callback) {
+  // The data is only ever read for a write request.
+  Schedule(DiskRequest{true, page_id, const_cast<char *>(page_data), std::move(callback)});
+}
+
+void AsyncDiskManager::ReadPageAsync(page_id_t page_id, char *page_data, DiskCallback callback) {
+  Schedule(DiskRequest{false, page_id, page_data, std::move(callback)});
+}
+
+void AsyncDiskManager::Schedule(DiskRequest request) {
+  {
+    std::lock_guard<std::mutex> guard(queue_latch_);
+    BUSTUB_ASSERT(!shutdown_, "Cannot schedule page I/O after shutdown.");
+    queue_.push_back(std::move(request));
+  }
+  queue_cv_.notify_one();
+}
+
+void AsyncDiskManager::RunIOThread() {
+  while (true) {
+    std::vector<uint32_t> batch;
+    {
+      std::unique_lock<std::mutex> lock(queue_latch_);
+      bool idle = free_slots_.size() == queue_depth_;
+      if (idle) {
+        queue_cv_.wait(lock, [&] { return shutdown_ || !queue_.empty(); });
+        if (queue_.empty()) {
+          return;
+        }
+      }
+      // Everything queued since the last round goes out in a single submission.
+      while (!queue_.empty() && !free_slots_.empty()) {
+        uint32_t slot = free_slots_.back();
+        free_slots_.pop_back();
+        slots_[slot] = std::move(queue_.front());
+        queue_.pop_front();
+        batch.push_back(slot);
+      }
+    }
+
+    if (ring_fd_ < 0) {
+      for (uint32_t slot : batch) {
+        PerformRequestSync(slot);
+      }
+      continue;
+    }
+
+    for (uint32_t slot : batch) {
+      PrepareRequest(slot);
+    }
+    // With nothing new to submit, block until at least one in-flight request completes.
+    unsubmitted_ += batch.size();
+    unsigned min_complete = batch.empty() ? 1 : 0;
+    int ret = IoUringEnter(ring_fd_, unsubmitted_, min_complete, IORING_ENTER_GETEVENTS);
+    if (ret >= 0) {
+      unsubmitted_ -= std::min(unsubmitted_, static_cast<unsigned>(ret));
+    } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      LOG_DEBUG("io_uring_enter failed: %s", strerror(errno));
+    }
+    ReapCompletions();
+  }
+}
+
+char *AsyncDiskManager::IOBuffer(uint32_t slot) {
+  char *data = slots_[slot].data_;
+  if (direct_io_ && reinterpret_cast<uintptr_t>(data) % DIRECT_IO_ALIGNMENT != 0) {
+    return bounce_buffers_ + static_cast<size_t>(slot) * PAGE_SIZE;
+  }
+  return data;
+}
+
+void AsyncDiskManager::PrepareRequest(uint32_t slot) {
+  DiskRequest &request = slots_[slot];
+  char *buffer = IOBuffer(slot);
+  if (request.is_write_ && buffer != request.data_) {
+    memcpy(buffer, request.data_, PAGE_SIZE);
+  }
+
+  // The I/O thread is the only producer, so the tail can be read without synchronization.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  io_uring_sqe *sqe = &sqes_[index];
+  memset(sqe, 0, sizeof(*sqe));
+  sqe->opcode = request.is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+  sqe->fd = db_fd_;
+  sqe->addr = reinterpret_cast<uint64_t>(buffer);
+  sqe->len = PAGE_SIZE;
+  sqe->off = static_cast<uint64_t>(request.page_id_) * PAGE_SIZE;
+  sqe->user_data = slot;
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+}
+
+void AsyncDiskManager::ReapCompletions() {
+  unsigned head = __atomic_load_n(cq_head_, __ATOMIC_RELAXED);
+  while (head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+    io_uring_cqe *cqe = &cqes_[head & *cq_mask_];
+    auto slot = static_cast<uint32_t>(cqe->user_data);
+    int res = cqe->res;
+    ++head;
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    CompleteRequest(slot, res);
+  }
+}
+
+void AsyncDiskManager::PerformRequestSync(uint32_t slot) {
+  DiskRequest &request = slots_[slot];
+  char *buffer = IOBuffer(slot);
+  auto offset = static_cast<off_t>(request.page_id_) * PAGE_SIZE;
+  ssize_t res;
+  if (request.is_write_) {
+    if (buffer != request.data_) {
+      memcpy(buffer, request.data_, PAGE_SIZE);
+    }
+    res = pwrite(db_fd_, buffer, PAGE_SIZE, offset);
+  } else {
+    res = pread(db_fd_, buffer, PAGE_SIZE, offset);
+  }
+  CompleteRequest(slot, res < 0 ? -errno : static_cast<int>(res));
+}
+
+void AsyncDiskManager::CompleteRequest(uint32_t slot, int res) {
+  DiskRequest request = std::move(slots_[slot]);
+  if (request.is_write_) {
+    num_writes_ += 1;
+    if (res != PAGE_SIZE) {
+      LOG_DEBUG("I/O error while writing");
+    }
+  } else {
+    num_reads_ += 1;
+    char *buffer = IOBuffer(slot);
+    int read_count = res < 0 ? 0 : res;
+    if (res < 0) {
+      LOG_DEBUG("I/O error while reading");
+    } else if (read_count < PAGE_SIZE) {
+      // Reading at or past the end of the file returns zeros, just like the synchronous path.
+      memset(buffer + read_count, 0, PAGE_SIZE - read_count);
+    }
+    if (buffer != request.data_) {
+      memcpy(request.data_, buffer, PAGE_SIZE);
+    }
+  }
+  free_slots_.push_back(slot);
+  request.callback_();
+}
+
+}  // namespace bustub
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -30,14 +33,15 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
+DiskManager::DiskManager(const std::string &db_file, bool persist_free_map)
+    : file_name_(db_file), num_flushes_(0), num_writes_(0), num_reads_(0), flush_log_(false), flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
     LOG_DEBUG("wrong file format");
     return;
   }
   log_name_ = file_name_.substr(0, n) + ".log";
+  fsm_name_ = file_name_.substr(0, n) + ".fsm";
 
   log_io_.open(log_name_, std::ios::binary | std::ios::in | std::ios::app | std::ios::out);
   // directory or file does not exist
@@ -56,7 +60,8 @@ DiskManager::DiskManager(const std::string &db_file)
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
   db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   // directory or file does not exist
-  if (!db_io_.is_open()) {
+  bool new_db = !db_io_.is_open();
+  if (new_db) {
     db_io_.clear();
     // create a new file
     db_io_.open(db_file, std::ios::binary | std::ios::trunc | std::ios::out);
@@ -67,9 +72,18 @@ DiskManager::DiskManager(const std::string &db_file)
       throw Exception("can't open db file");
     }
   }
+  if (persist_free_map) {
+    OpenFreeMap(new_db);
+  } else {
+    next_page_id_ = GetNumPages();
+  }
   buffer_used = nullptr;
 }
 
+DiskManager::DiskManager() : num_flushes_(0), num_writes_(0), num_reads_(0), flush_log_(false), flush_log_f_(nullptr) {}
+
+DiskManager::~DiskManager() { FlushFreeMap(); }
+
 /**
  * Close all file streams
  */
@@ -78,6 +92,13 @@ void DiskManager::ShutDown() {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
   }
+  {
+    std::scoped_lock scoped_free_map_latch(free_map_latch_);
+    if (free_map_dirty_) {
+      WriteFreeMap();
+    }
+    fsm_io_.close();
+  }
   log_io_.close();
 }
 
@@ -106,6 +127,7 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
   int offset = page_id * PAGE_SIZE;
+  num_reads_ += 1;
   // check if read beyond file length
   if (offset > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
@@ -129,6 +151,22 @@ void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
   }
 }
 
+/**
+ * Write the contents of the specified page into disk file, then call back
+ */
+void DiskManager::WritePageAsync(page_id_t page_id, const char *page_data, DiskCallback callback) {
+  WritePage(page_id, page_data);
+  callback();
+}
+
+/**
+ * Read the contents of the specified page into the given memory area, then call back
+ */
+void DiskManager::ReadPageAsync(page_id_t page_id, char *page_data, DiskCallback callback) {
+  ReadPage(page_id, page_data);
+  callback();
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -191,6 +229,60 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
   return true;
 }
 
+/**
+ * Allocate the lowest free page of the caller's stripe, or the next page id of the stripe past the end of the file
+ */
+page_id_t DiskManager::AllocatePage(uint32_t stride, uint32_t offset) {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  if (free_pages_.size() != stride) {
+    RestripeFreePages(stride);
+  }
+  std::set<page_id_t> &free_pages = free_pages_[offset];
+  if (!free_pages.empty()) {
+    page_id_t page_id = *free_pages.begin();
+    SetFreePage(page_id, false);
+    PersistAllocation(page_id);
+    return page_id;
+  }
+  page_id_t page_id = next_page_id_;
+  while (static_cast<uint32_t>(page_id) % stride != offset) {
+    SetFreePage(page_id++, true);
+  }
+  next_page_id_ = page_id + 1;
+  // A page truncated away may still be free in the file.
+  PersistAllocation(page_id);
+  return page_id;
+}
+
+/**
+ * Return a page to the free page map and release its disk space
+ */
+void DiskManager::DeallocatePage(page_id_t page_id) {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  if (page_id < 0 || page_id >= next_page_id_ || TestFreeBit(page_id)) {
+    return;
+  }
+  SetFreePage(page_id, true);
+  ReleasePageSpace(page_id);
+}
+
+bool DiskManager::IsFreePage(page_id_t page_id) {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  return TestFreeBit(page_id);
+}
+
+void DiskManager::FlushFreeMap() {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  if (free_map_dirty_) {
+    WriteFreeMap();
+  }
+}
+
+size_t DiskManager::GetNumFreePages() {
+  std::scoped_lock scoped_free_map_latch(free_map_latch_);
+  return num_free_pages_;
+}
+
 /**
  * Returns number of flushes made so far
  */
@@ -201,11 +293,161 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of page reads made so far
+ */
+int DiskManager::GetNumReads() const { return num_reads_; }
+
+/**
+ * Returns the number of pages in the database file
+ */
+int DiskManager::GetNumPages() {
+  int file_size = GetFileSize(file_name_);
+  return file_size <= 0 ? 0 : (file_size + PAGE_SIZE - 1) / PAGE_SIZE;
+}
+
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+/**
+ * Private helper function to load the free page map. A database file without one has every page allocated.
+ */
+void DiskManager::OpenFreeMap(bool new_db) {
+  fsm_io_.open(fsm_name_, std::ios::binary | std::ios::in | std::ios::out);
+  if (fsm_io_.is_open() && !new_db) {
+    page_id_t next_page_id = 0;
+    fsm_io_.read(reinterpret_cast<char *>(&next_page_id), sizeof(next_page_id));
+    if (fsm_io_.gcount() == sizeof(next_page_id)) {
+      free_bitmap_.resize((next_page_id + 7) / 8);
+      fsm_io_.read(reinterpret_cast<char *>(free_bitmap_.data()), free_bitmap_.size());
+      fsm_io_.clear();
+      next_page_id_ = std::max(next_page_id, GetNumPages());
+      for (page_id_t page_id = 0; page_id < next_page_id; ++page_id) {
+        if (TestFreeBit(page_id)) {
+          free_pages_[0].insert(page_id);
+          ++num_free_pages_;
+        }
+      }
+      written_bitmap_ = free_bitmap_;
+      return;
+    }
+  }
+
+  // A map left behind by an earlier database file of the same name does not apply.
+  fsm_io_.close();
+  fsm_io_.clear();
+  fsm_io_.open(fsm_name_, std::ios::binary | std::ios::trunc | std::ios::out);
+  fsm_io_.close();
+  fsm_io_.open(fsm_name_, std::ios::binary | std::ios::in | std::ios::out);
+  if (!fsm_io_.is_open()) {
+    throw Exception("can't open free page map file");
+  }
+  next_page_id_ = GetNumPages();
+  WriteFreeMap();
+}
+
+/**
+ * Private helper function to update the free page map in memory
+ */
+void DiskManager::SetFreePage(page_id_t page_id, bool free) {
+  auto byte = static_cast<size_t>(page_id) / 8;
+  if (byte >= free_bitmap_.size()) {
+    free_bitmap_.resize(byte + 1);
+  }
+  if (free) {
+    free_bitmap_[byte] |= 1 << (page_id % 8);
+    free_pages_[page_id % free_pages_.size()].insert(page_id);
+    ++num_free_pages_;
+  } else {
+    free_bitmap_[byte] &= ~(1 << (page_id % 8));
+    free_pages_[page_id % free_pages_.size()].erase(page_id);
+    --num_free_pages_;
+  }
+  free_map_dirty_ = true;
+}
+
+/**
+ * Private helper function to keep the free page map file from recording an allocated page as free. Only pages freed
+ * before the map was last written cost a write here; the bits of the other pages in the byte are written along, and
+ * they are correct in memory.
+ */
+void DiskManager::PersistAllocation(page_id_t page_id) {
+  if (!TestFreeBit(written_bitmap_, page_id) || !fsm_io_.is_open()) {
+    return;
+  }
+  auto byte = static_cast<size_t>(page_id) / 8;
+  uint8_t bits = byte < free_bitmap_.size() ? free_bitmap_[byte] : 0;
+  fsm_io_.seekp(sizeof(page_id_t) + byte);
+  fsm_io_.write(reinterpret_cast<char *>(&bits), 1);
+  fsm_io_.flush();
+  written_bitmap_[byte] = bits;
+}
+
+/**
+ * Private helper function to sort the free pages by the stripe they belong to
+ */
+void DiskManager::RestripeFreePages(uint32_t stride) {
+  std::vector<std::set<page_id_t>> free_pages(stride);
+  for (auto &stripe : free_pages_) {
+    for (page_id_t page_id : stripe) {
+      free_pages[page_id % stride].insert(page_id);
+    }
+  }
+  free_pages_ = std::move(free_pages);
+}
+
+/**
+ * Private helper function to persist the number of page ids in use and the bitmap
+ */
+void DiskManager::WriteFreeMap() {
+  if (!fsm_io_.is_open()) {
+    return;
+  }
+  free_bitmap_.resize(std::max(free_bitmap_.size(), (static_cast<size_t>(next_page_id_) + 7) / 8));
+  fsm_io_.seekp(0);
+  fsm_io_.write(reinterpret_cast<char *>(&next_page_id_), sizeof(next_page_id_));
+  fsm_io_.write(reinterpret_cast<char *>(free_bitmap_.data()), free_bitmap_.size());
+  fsm_io_.flush();
+  written_bitmap_ = free_bitmap_;
+  free_map_dirty_ = false;
+}
+
+/**
+ * Private helper function to give the space of a free page back to the file system
+ */
+void DiskManager::ReleasePageSpace(page_id_t page_id) {
+  if (page_id + 1 == next_page_id_) {
+    // Drop the run of free pages at the end of the file.
+    while (next_page_id_ > 0 && TestFreeBit(next_page_id_ - 1)) {
+      SetFreePage(--next_page_id_, false);
+    }
+    if (!file_name_.empty()) {
+      std::scoped_lock scoped_db_io_latch(db_io_latch_);
+      auto size = static_cast<off_t>(next_page_id_) * PAGE_SIZE;
+      if (GetFileSize(file_name_) > size && truncate(file_name_.c_str(), size) != 0) {
+        LOG_DEBUG("can't truncate the db file");
+      }
+    }
+    return;
+  }
+  if (!punch_holes_ || file_name_.empty()) {
+    return;
+  }
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  int fd = open(file_name_.c_str(), O_WRONLY);
+  if (fd < 0) {
+    return;
+  }
+  // Not every file system supports hole punching. The page is free either way.
+  if (fallocate(fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, static_cast<off_t>(page_id) * PAGE_SIZE, PAGE_SIZE) !=
+      0) {
+    LOG_DEBUG("can't punch a hole in the db file");
+  }
+  close(fd);
+}
+
 /**
  * Private helper function to get disk file size
  */
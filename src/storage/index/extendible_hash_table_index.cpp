@@ -23,6 +23,19 @@ void HASH_TABLE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *
   container_.Insert(transaction, index_key, rid);
 }
 
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_INDEX_TYPE::BulkInsertEntries(const std::vector<std::pair<Tuple, RID>> &entries,
+                                              Transaction *transaction) {
+  // construct insert index keys
+  std::vector<std::pair<KeyType, ValueType>> index_entries(entries.size());
+  for (size_t i = 0; i < entries.size(); ++i) {
+    index_entries[i].first.SetFromKey(entries[i].first);
+    index_entries[i].second = entries[i].second;
+  }
+
+  container_.BulkInsert(transaction, index_entries);
+}
+
 template <typename KeyType, typename ValueType, typename KeyComparator>
 void HASH_TABLE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
@@ -24,7 +24,7 @@ bool HeaderPage::InsertRecord(const std::string &name, const page_id_t root_id)
   assert(root_id > INVALID_PAGE_ID);
 
   int record_num = GetRecordCount();
-  int offset = 4 + record_num * 36;
+  int offset = RecordsOffset() + record_num * RECORD_SIZE;
   // check for duplicate name
   if (FindRecord(name) != -1) {
     return false;
@@ -46,8 +46,8 @@ bool HeaderPage::DeleteRecord(const std::string &name) {
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
-  memmove(GetData() + offset, GetData() + offset + 36, (record_num - index - 1) * 36);
+  int offset = RecordsOffset() + index * RECORD_SIZE;
+  memmove(GetData() + offset, GetData() + offset + RECORD_SIZE, (record_num - index - 1) * RECORD_SIZE);
 
   SetRecordCount(record_num - 1);
   return true;
@@ -61,7 +61,7 @@ bool HeaderPage::UpdateRecord(const std::string &name, const page_id_t root_id)
   if (index == -1) {
     return false;
   }
-  int offset = index * 36 + 4;
+  int offset = RecordsOffset() + index * RECORD_SIZE;
   // update record content, only root_id
   memcpy((GetData() + offset + 32), &root_id, 4);
 
@@ -76,7 +76,7 @@ bool HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) {
   if (index == -1) {
     return false;
   }
-  int offset = (index + 1) * 36;
+  int offset = RecordsOffset() + index * RECORD_SIZE + 32;
   *root_id = *reinterpret_cast<page_id_t *>(GetData() + offset);
 
   return true;
@@ -86,15 +86,15 @@ bool HeaderPage::GetRootId(const std::string &name, page_id_t *root_id) {
  * helper functions
  */
 // record count
-int HeaderPage::GetRecordCount() { return *reinterpret_cast<int *>(GetData()); }
+int HeaderPage::GetRecordCount() { return *reinterpret_cast<int *>(GetData() + RecordCountOffset()); }
 
-void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData(), &record_count, 4); }
+void HeaderPage::SetRecordCount(int record_count) { memcpy(GetData() + RecordCountOffset(), &record_count, 4); }
 
 int HeaderPage::FindRecord(const std::string &name) {
   int record_num = GetRecordCount();
 
   for (int i = 0; i < record_num; i++) {
-    char *raw_name = reinterpret_cast<char *>(GetData() + (4 + i * 36));
+    char *raw_name = reinterpret_cast<char *>(GetData() + (RecordsOffset() + i * RECORD_SIZE));
     if (strcmp(raw_name, name.c_str()) == 0) {
       return i;
     }
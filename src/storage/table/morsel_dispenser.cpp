@@ -0,0 +1,35 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_dispenser.cpp
+//
+// Identification: src/storage/table/morsel_dispenser.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/morsel_dispenser.h"
+
+namespace bustub {
+
+MorselDispenser::MorselDispenser(TableHeap *table_heap, size_t morsel_size)
+    : table_heap_(table_heap), morsel_size_(morsel_size), next_page_id_(table_heap->GetFirstPageId()) {}
+
+bool MorselDispenser::Next(std::vector<page_id_t> *page_ids) {
+  page_ids->clear();
+  std::lock_guard<std::mutex> guard(latch_);
+  while (page_ids->size() < morsel_size_ && next_page_id_ != INVALID_PAGE_ID) {
+    page_ids->push_back(next_page_id_);
+    next_page_id_ = table_heap_->GetNextPageId(next_page_id_);
+  }
+  return !page_ids->empty();
+}
+
+void MorselDispenser::Reset() {
+  std::lock_guard<std::mutex> guard(latch_);
+  next_page_id_ = table_heap_->GetFirstPageId();
+}
+
+}  // namespace bustub
@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_free_space_map.cpp
+//
+// Identification: src/storage/table/table_free_space_map.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/table_free_space_map.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void TableFreeSpaceMap::Update(page_id_t page_id, uint32_t free_space) {
+  uint32_t space_class = std::min(free_space / CLASS_SIZE, NUM_CLASSES - 1);
+  std::lock_guard<std::mutex> guard(latch_);
+  auto iter = page_classes_.find(page_id);
+  if (iter != page_classes_.end()) {
+    if (iter->second == space_class) {
+      return;
+    }
+    class_pages_[iter->second].erase(page_id);
+    iter->second = space_class;
+  } else {
+    page_classes_.emplace(page_id, space_class);
+  }
+  class_pages_[space_class].insert(page_id);
+}
+
+page_id_t TableFreeSpaceMap::FindPage(uint32_t free_space, size_t hint) {
+  // Round up: a page of a class has at least the class's lower bound free.
+  uint32_t min_class = (free_space + CLASS_SIZE - 1) / CLASS_SIZE;
+  std::lock_guard<std::mutex> guard(latch_);
+  for (uint32_t space_class = min_class; space_class < NUM_CLASSES; ++space_class) {
+    const std::set<page_id_t> &pages = class_pages_[space_class];
+    if (pages.empty()) {
+      continue;
+    }
+    // Start from a point between the lowest and highest page id picked by the hint.
+    page_id_t first = *pages.begin();
+    auto span = static_cast<size_t>(*pages.rbegin() - first) + 1;
+    auto iter = pages.lower_bound(first + static_cast<page_id_t>(hint % span));
+    return iter == pages.end() ? first : *iter;
+  }
+  return INVALID_PAGE_ID;
+}
+
+size_t TableFreeSpaceMap::GetNumPages() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return page_classes_.size();
+}
+
+}  // namespace bustub
@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <thread>  // NOLINT
 
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
@@ -22,7 +25,10 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  page_ids_.push_back(first_page_id_);
+  page_positions_[first_page_id_] = 0;
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -32,8 +38,11 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  free_space_map_.Update(first_page_id_, first_page->GetFreeSpaceRemaining());
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  page_ids_.push_back(first_page_id_);
+  page_positions_[first_page_id_] = 0;
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
@@ -42,7 +51,21 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  if (InsertIntoFreePage(tuple, rid, txn)) {
+    return true;
+  }
+  if (txn->GetState() == TransactionState::ABORTED) {
+    return false;
+  }
+
+  // No page known to the free space map has room, so walk the chain from the last page known to it. Pages past that
+  // one are either unknown since the table was opened, or appended by concurrent inserts.
+  page_id_t last_page_id;
+  {
+    std::lock_guard<std::mutex> guard(page_ids_latch_);
+    last_page_id = page_ids_.back();
+  }
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
   if (cur_page == nullptr) {
     txn->SetState(TransactionState::ABORTED);
     return false;
@@ -52,9 +75,11 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
   // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
   // INVARIANT: cur_page is WLatched if you leave the loop normally.
   while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
+    free_space_map_.Update(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
     auto next_page_id = cur_page->GetNextPageId();
     // If the next page is a valid page,
     if (next_page_id != INVALID_PAGE_ID) {
+      RecordNextPageId(cur_page->GetTablePageId(), next_page_id);
       // Unlatch and unpin the current page.
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
@@ -76,11 +101,13 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
       new_page->WLatch();
       cur_page->SetNextPageId(next_page_id);
       new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+      RecordNextPageId(cur_page->GetTablePageId(), next_page_id);
       cur_page->WUnlatch();
       buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
       cur_page = new_page;
     }
   }
+  free_space_map_.Update(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
   // This line has caused most of us to double-take and "whoa double unlatch".
   // We are not, in fact, double unlatching. See the invariant above.
   cur_page->WUnlatch();
@@ -90,6 +117,102 @@ bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
   return true;
 }
 
+bool TableHeap::BulkInsert(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) {
+  rids->clear();
+  for (const Tuple &tuple : tuples) {
+    if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+  if (tuples.empty()) {
+    return true;
+  }
+  rids->reserve(tuples.size());
+
+  // Go to the end of the chain, from the last page known.
+  page_id_t page_id;
+  {
+    std::lock_guard<std::mutex> guard(page_ids_latch_);
+    page_id = page_ids_.back();
+  }
+  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (cur_page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return false;
+  }
+  cur_page->WLatch();
+  for (page_id_t next_page_id = cur_page->GetNextPageId(); next_page_id != INVALID_PAGE_ID;
+       next_page_id = cur_page->GetNextPageId()) {
+    RecordNextPageId(cur_page->GetTablePageId(), next_page_id);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
+    cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+    cur_page->WLatch();
+  }
+
+  // Fill the last page, then append new ones. The last page stays latched until it is no longer the last, so other
+  // inserts that reach the end of the chain wait for it rather than append pages of their own.
+  // INVARIANT: cur_page is the last page of the chain and is WLatched.
+  size_t next_tuple = 0;
+  while (true) {
+    RID rid;
+    while (next_tuple < tuples.size() &&
+           cur_page->InsertTuple(tuples[next_tuple], &rid, txn, lock_manager_, log_manager_)) {
+      rids->push_back(rid);
+      txn->GetWriteSet()->emplace_back(rid, WType::INSERT, Tuple{}, this);
+      ++next_tuple;
+    }
+    free_space_map_.Update(cur_page->GetTablePageId(), cur_page->GetFreeSpaceRemaining());
+    if (next_tuple == tuples.size()) {
+      break;
+    }
+    page_id_t new_page_id;
+    auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&new_page_id));
+    if (new_page == nullptr) {
+      cur_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    new_page->WLatch();
+    cur_page->SetNextPageId(new_page_id);
+    new_page->Init(new_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
+    RecordNextPageId(cur_page->GetTablePageId(), new_page_id);
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+    cur_page = new_page;
+  }
+  cur_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
+  return true;
+}
+
+bool TableHeap::InsertIntoFreePage(const Tuple &tuple, RID *rid, Transaction *txn) {
+  // Threads start their search at different pages, so concurrent inserts rarely wait on each other's page latches.
+  size_t hint = std::hash<std::thread::id>()(std::this_thread::get_id());
+  uint32_t space_needed = TablePage::SpaceNeeded(tuple);
+  page_id_t page_id;
+  while ((page_id = free_space_map_.FindPage(space_needed, hint)) != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    page->WLatch();
+    bool inserted = page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    // Either way the page's entry is now accurate, so a failed attempt is not repeated.
+    free_space_map_.Update(page_id, page->GetFreeSpaceRemaining());
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    if (inserted) {
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+  }
+  return false;
+}
+
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
   // TODO(Amadou): remove empty page
   // Find the page which contains the tuple.
@@ -121,6 +244,7 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   Tuple old_tuple;
   page->WLatch();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpaceRemaining());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
   // Update the transaction's write set.
@@ -138,6 +262,7 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
   lock_manager_->Unlock(txn, rid);
+  free_space_map_.Update(rid.GetPageId(), page->GetFreeSpaceRemaining());
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
 }
@@ -179,16 +304,73 @@ TableIterator TableHeap::Begin(Transaction *txn) {
     page->RLatch();
     // If this fails because there is no tuple, then RID will be the default-constructed value, which means EOF.
     auto found_tuple = page->GetFirstTupleRid(&rid);
+    auto next_page_id = page->GetNextPageId();
     page->RUnlatch();
     buffer_pool_manager_->UnpinPage(page_id, false);
     if (found_tuple) {
       break;
     }
-    page_id = page->GetNextPageId();
+    if (next_page_id != INVALID_PAGE_ID) {
+      RecordNextPageId(page_id, next_page_id);
+    }
+    page_id = next_page_id;
   }
   return TableIterator(this, rid, txn);
 }
 
+void TableHeap::RecordNextPageId(page_id_t page_id, page_id_t next_page_id) {
+  std::lock_guard<std::mutex> guard(page_ids_latch_);
+  if (page_ids_.back() == page_id && page_positions_.count(next_page_id) == 0) {
+    page_positions_[next_page_id] = page_ids_.size();
+    page_ids_.push_back(next_page_id);
+  }
+}
+
+page_id_t TableHeap::GetNextPageId(page_id_t page_id) {
+  {
+    std::lock_guard<std::mutex> guard(page_ids_latch_);
+    auto iter = page_positions_.find(page_id);
+    if (iter != page_positions_.end() && iter->second + 1 < page_ids_.size()) {
+      return page_ids_[iter->second + 1];
+    }
+  }
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "No frame left to read a page of the table.");
+  }
+  page->RLatch();
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  if (next_page_id != INVALID_PAGE_ID) {
+    RecordNextPageId(page_id, next_page_id);
+  }
+  return next_page_id;
+}
+
+void TableHeap::ReadAhead(page_id_t page_id, size_t count) {
+  std::vector<page_id_t> prefetch;
+  {
+    std::lock_guard<std::mutex> guard(page_ids_latch_);
+    auto iter = page_positions_.find(page_id);
+    if (iter == page_positions_.end()) {
+      return;
+    }
+    size_t end = std::min(page_ids_.size(), iter->second + 1 + count);
+    prefetch.assign(page_ids_.begin() + iter->second + 1, page_ids_.begin() + end);
+  }
+  PrefetchPages(prefetch);
+}
+
+size_t TableHeap::PrefetchPages(const std::vector<page_id_t> &page_ids) {
+  // The buffer pool keeps at most a quarter of its frames for pages prefetched and not yet fetched.
+  size_t count = std::min(page_ids.size(), buffer_pool_manager_->GetPoolSize() / 4);
+  for (size_t i = 0; i < count; i++) {
+    buffer_pool_manager_->PrefetchPage(page_ids[i]);
+  }
+  return count;
+}
+
 TableIterator TableHeap::End() { return TableIterator(this, RID(INVALID_PAGE_ID, 0), nullptr); }
 
 }  // namespace bustub
@@ -10,6 +10,7 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <cassert>
 
 #include "storage/table/table_heap.h"
@@ -43,7 +44,13 @@ TableIterator &TableIterator::operator++() {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
-      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
+      auto next_page_id = cur_page->GetNextPageId();
+      table_heap_->RecordNextPageId(cur_page->GetTablePageId(), next_page_id);
+      // The scan is following the page chain, so widen the read-ahead window and get the pages after this one in
+      // flight before blocking on the next one.
+      read_ahead_ = std::min(std::max<size_t>(2 * read_ahead_, 1), table_heap_->GetReadAheadWindow());
+      table_heap_->ReadAhead(cur_page->GetTablePageId(), read_ahead_);
+      auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(next_page_id));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
       cur_page = next_page;
@@ -0,0 +1,111 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_store.cpp
+//
+// Identification: src/storage/table/tmp_tuple_store.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/tmp_tuple_store.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+TmpTupleIterator::TmpTupleIterator(TmpTupleStore *store, size_t page_index) : store_(store), page_index_(page_index) {
+  LoadPage();
+}
+
+TmpTupleIterator &TmpTupleIterator::operator++() {
+  if (++tuple_index_ == tuples_.size()) {
+    ++page_index_;
+    LoadPage();
+  }
+  return *this;
+}
+
+void TmpTupleIterator::LoadPage() {
+  tuple_index_ = 0;
+  tuples_.clear();
+  for (; page_index_ < store_->page_ids_.size(); ++page_index_) {
+    page_id_t page_id = store_->page_ids_[page_index_];
+    auto page = static_cast<TmpTuplePage *>(store_->buffer_pool_manager_->FetchPage(page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "Cannot fetch a page of a temporary tuple store.");
+    }
+    // The page holds its tuples newest first.
+    for (size_t offset = page->GetFreeSpacePointer(); offset < PAGE_SIZE; offset = page->NextOffset(offset)) {
+      tuples_.emplace_back();
+      page->Get(offset, &tuples_.back());
+    }
+    store_->buffer_pool_manager_->UnpinPage(page_id, false);
+    if (!tuples_.empty()) {
+      std::reverse(tuples_.begin(), tuples_.end());
+      return;
+    }
+  }
+}
+
+TmpTupleStore::TmpTupleStore(BufferPoolManager *buffer_pool_manager) : buffer_pool_manager_(buffer_pool_manager) {}
+
+TmpTupleStore::~TmpTupleStore() { Clear(); }
+
+bool TmpTupleStore::Append(const Tuple &tuple, TmpTuple *out) {
+  if (TmpTuplePage::HEADER_SIZE + TmpTuplePage::SpaceNeeded(tuple) > PAGE_SIZE) {
+    return false;
+  }
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (tail_page_ == nullptr || !tail_page_->Insert(tuple, &location)) {
+    ReleaseTailPage();
+    page_id_t page_id;
+    auto page = static_cast<TmpTuplePage *>(buffer_pool_manager_->NewPage(&page_id));
+    if (page == nullptr) {
+      return false;
+    }
+    page->Init(page_id, PAGE_SIZE);
+    page_ids_.push_back(page_id);
+    tail_page_ = page;
+    tail_page_->Insert(tuple, &location);
+  }
+  if (out != nullptr) {
+    *out = location;
+  }
+  ++num_tuples_;
+  size_ += TmpTuplePage::SpaceNeeded(tuple);
+  return true;
+}
+
+bool TmpTupleStore::Get(const TmpTuple &location, Tuple *tuple) {
+  auto page = static_cast<TmpTuplePage *>(buffer_pool_manager_->FetchPage(location.GetPageId()));
+  if (page == nullptr) {
+    return false;
+  }
+  page->Get(location.GetOffset(), tuple);
+  buffer_pool_manager_->UnpinPage(location.GetPageId(), false);
+  return true;
+}
+
+void TmpTupleStore::Clear() {
+  ReleaseTailPage();
+  for (page_id_t page_id : page_ids_) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  page_ids_.clear();
+  num_tuples_ = 0;
+  size_ = 0;
+}
+
+void TmpTupleStore::ReleaseTailPage() {
+  if (tail_page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(tail_page_->GetPageId(), true);
+    tail_page_ = nullptr;
+  }
+}
+
+}  // namespace bustub
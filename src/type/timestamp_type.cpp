@@ -31,7 +31,7 @@ CmpBool TimestampType::CompareEquals(const Value &left, const Value &right) cons
 
 CmpBool TimestampType::CompareNotEquals(const Value &left, const Value &right) const {
   assert(left.CheckComparable(right));
-  if (right.IsNull()) {
+  if (left.IsNull() || right.IsNull()) {
     return CmpBool::CmpNull;
   }
   return GetCmpBool(left.GetAs<uint64_t>() != right.GetAs<uint64_t>());
@@ -58,7 +58,7 @@ CmpBool TimestampType::CompareGreaterThan(const Value &left, const Value &right)
   if (left.IsNull() || right.IsNull()) {
     return CmpBool::CmpNull;
   }
-  return GetCmpBool(left.GetAs<int64_t>() > right.GetAs<int64_t>());
+  return GetCmpBool(left.GetAs<uint64_t>() > right.GetAs<uint64_t>());
 }
 
 CmpBool TimestampType::CompareGreaterThanEquals(const Value &left, const Value &right) const {
@@ -292,6 +292,9 @@ bool Value::CheckComparable(const Value &o) const {
       // Anything can be cast to a string!
       return true;
       break;
+    case TypeId::TIMESTAMP:
+      // TimestampType reads the other value as a timestamp, so a string must be cast first.
+      return o.GetTypeId() == TypeId::TIMESTAMP;
     default:
       break;
   }  // END OF SWITCH
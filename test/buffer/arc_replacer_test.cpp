@@ -0,0 +1,135 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// arc_replacer_test.cpp
+//
+// Identification: test/buffer/arc_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/arc_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Simulate the buffer pool loading a page into a frame and releasing it. */
+static void Load(ARCReplacer *replacer, frame_id_t frame_id, page_id_t page_id) {
+  replacer->SetFramePage(frame_id, page_id);
+  replacer->Pin(frame_id);
+  replacer->Unpin(frame_id);
+}
+
+/** Simulate a hit on a frame. */
+static void Access(ARCReplacer *replacer, frame_id_t frame_id) {
+  replacer->Pin(frame_id);
+  replacer->Unpin(frame_id);
+}
+
+TEST(ARCReplacerTest, SampleTest) {
+  ARCReplacer arc_replacer(4, 0);
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    Load(&arc_replacer, frame_id, 100 + frame_id);
+  }
+  // A second reference moves page 100 to T2.
+  Access(&arc_replacer, 0);
+  EXPECT_EQ(4, arc_replacer.Size());
+
+  // T1 is over its target, so it gives up its pages first, least recently used first.
+  std::vector<frame_id_t> frame_ids;
+  arc_replacer.PeekVictims(10, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 2, 3, 0}), frame_ids);
+
+  int value;
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  arc_replacer.Pin(2);
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  // Every page left in T1 is pinned, so T2 has to give one up.
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  EXPECT_FALSE(arc_replacer.Victim(&value));
+  EXPECT_EQ(0, arc_replacer.Size());
+}
+
+TEST(ARCReplacerTest, AdaptationTest) {
+  ARCReplacer arc_replacer(4, 0);
+  for (frame_id_t frame_id = 0; frame_id < 4; ++frame_id) {
+    Load(&arc_replacer, frame_id, 100 + frame_id);
+  }
+  Access(&arc_replacer, 2);
+  Access(&arc_replacer, 3);
+  EXPECT_EQ(0, arc_replacer.GetTargetRecentSize());
+
+  // Page 100 is evicted from T1 and comes right back: T1 should have been bigger.
+  int value;
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  Load(&arc_replacer, 0, 104);
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  Load(&arc_replacer, 1, 100);
+  EXPECT_EQ(1, arc_replacer.GetTargetRecentSize());
+
+  // Page 102 is evicted from T2 and comes right back: now T2 should have been bigger.
+  arc_replacer.Pin(0);
+  arc_replacer.Pin(1);
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  Load(&arc_replacer, 2, 105);
+  arc_replacer.Pin(2);
+  arc_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  Load(&arc_replacer, 3, 102);
+  EXPECT_EQ(0, arc_replacer.GetTargetRecentSize());
+}
+
+TEST(ARCReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 8;
+  ARCReplacer arc_replacer(num_frames, 4);
+
+  // Two hot pages referenced repeatedly, far enough apart to be uncorrelated.
+  Load(&arc_replacer, 0, 1000);
+  Load(&arc_replacer, 1, 1001);
+  for (int tick = 0; tick < 5; ++tick) {
+    arc_replacer.Pin(7);
+  }
+  Access(&arc_replacer, 0);
+  Access(&arc_replacer, 1);
+
+  // A scan touches each page several times in a row. It stays in T1 and only ever replaces its own pages.
+  page_id_t next_page_id = 0;
+  for (frame_id_t frame_id = 2; frame_id < static_cast<frame_id_t>(num_frames) - 1; ++frame_id) {
+    Load(&arc_replacer, frame_id, next_page_id++);
+    Access(&arc_replacer, frame_id);
+  }
+  int value;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(arc_replacer.Victim(&value));
+    EXPECT_NE(0, value);
+    EXPECT_NE(1, value);
+    Load(&arc_replacer, value, next_page_id++);
+    Access(&arc_replacer, value);
+  }
+}
+
+TEST(ARCReplacerTest, LateUnpinTest) {
+  ARCReplacer arc_replacer(2, 0);
+  Load(&arc_replacer, 0, 10);
+
+  // Frame 0 is freed by a delete, and the unpin that dropped its last pin comes in just before the frame is cleared.
+  arc_replacer.Pin(0);
+  arc_replacer.Unpin(0);
+  arc_replacer.SetFramePage(0, INVALID_PAGE_ID);
+  EXPECT_EQ(0, arc_replacer.Size());
+  int value;
+  EXPECT_FALSE(arc_replacer.Victim(&value));
+}
+
+}  // namespace bustub
@@ -11,11 +11,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "buffer/buffer_pool_manager_instance.h"
+#include <chrono>  // NOLINT
 #include <cstdio>
+#include <cstring>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
 
 namespace bustub {
 
@@ -141,4 +146,431 @@ TEST(BufferPoolManagerInstanceTest, SampleTest) {
   delete disk_manager;
 }
 
+// NOLINTNEXTLINE
+// Concurrent misses on a small pool must never observe a page before its contents are read in or after they are lost
+TEST(BufferPoolManagerInstanceTest, ConcurrentMissTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  const int num_pages = 32;
+  const int num_threads = 4;
+  const int num_rounds = 200;
+
+  // Run the whole scenario once per replacement policy.
+  for (auto replacer_type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K, ReplacerType::ARC}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, replacer_type);
+
+    // Every page starts out holding its own page id followed by a per-page counter.
+    for (int i = 0; i < num_pages; ++i) {
+      page_id_t page_id_temp;
+      auto *page = bpm->NewPage(&page_id_temp);
+      ASSERT_NE(nullptr, page);
+      EXPECT_EQ(i, page_id_temp);
+      reinterpret_cast<int *>(page->GetData())[0] = page_id_temp;
+      reinterpret_cast<int *>(page->GetData())[1] = 0;
+      EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    }
+
+    // Each thread owns the pages congruent to its index, so the counters it sees must be exactly the ones it wrote.
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; ++tid) {
+      threads.emplace_back([bpm, tid] {
+        std::vector<int> expected(num_pages, 0);
+        std::default_random_engine rng(tid);
+        std::uniform_int_distribution<int> uniform_dist(0, num_pages / num_threads - 1);
+        for (int round = 0; round < num_rounds; ++round) {
+          page_id_t page_id = uniform_dist(rng) * num_threads + tid;
+          Page *page = nullptr;
+          while (page == nullptr) {
+            page = bpm->FetchPage(page_id);
+          }
+          auto *data = reinterpret_cast<int *>(page->GetData());
+          EXPECT_EQ(page_id, data[0]);
+          EXPECT_EQ(expected[page_id], data[1]);
+          data[1] = ++expected[page_id];
+          EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+        }
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+
+    disk_manager->ShutDown();
+    remove("test.db");
+
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+// NOLINTNEXTLINE
+// Prefetched pages must hold the right contents once fetched and must not stay pinned
+TEST(BufferPoolManagerInstanceTest, PrefetchTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const int num_pages = 30;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  for (int i = 0; i < num_pages; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "Page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // The early pages have been evicted by now. Prefetching one that is still in the pool is a no-op.
+  for (int i = 0; i < num_pages; ++i) {
+    bpm->PrefetchPage(i);
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("Page " + std::to_string(i)).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+
+  // Prefetch pages that are never fetched. Once the reads complete, every frame must be usable again.
+  for (int i = 0; i < static_cast<int>(buffer_pool_size); ++i) {
+    bpm->PrefetchPage(i);
+  }
+  std::vector<Page *> pages;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    Page *page = nullptr;
+    while (page == nullptr) {
+      page = bpm->NewPage(&page_id_temp);
+    }
+    pages.push_back(page);
+  }
+  for (auto *page : pages) {
+    EXPECT_EQ(true, bpm->UnpinPage(page->GetPageId(), false));
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// With the background writer running, evictions should find the victims already written back
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "Page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  bpm->RunBackgroundWriter(buffer_pool_size);
+  for (int i = 0; i < 1000 && disk_manager->GetNumWrites() < static_cast<int>(buffer_pool_size); ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+
+  // Every victim is clean now, so the new pages evict without writing anything.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  EXPECT_EQ(buffer_pool_size, bpm->GetCleanEvictions());
+  EXPECT_EQ(0, bpm->GetDirtyEvictions());
+  EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+
+  // The written pages read back intact.
+  for (page_id_t page_id = 0; page_id < static_cast<page_id_t>(buffer_pool_size); ++page_id) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("Page " + std::to_string(page_id)).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// The background writer skips a page that is latched instead of waiting for it
+TEST(BufferPoolManagerInstanceTest, BackgroundWriterSkipLatchedTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new AsyncDiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  Page *latched = nullptr;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    latched = latched == nullptr ? page : latched;
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  // A writer that got hold of the first page after the background writer found it unpinned.
+  latched->WLatch();
+  bpm->RunBackgroundWriter(buffer_pool_size);
+  for (int i = 0; i < 1000 && disk_manager->GetNumWrites() < static_cast<int>(buffer_pool_size) - 1; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  bpm->StopBackgroundWriter();
+  EXPECT_EQ(buffer_pool_size - 1, disk_manager->GetNumWrites());
+  EXPECT_EQ(true, latched->IsDirty());
+  latched->WUnlatch();
+
+  bpm->FlushAllPages();
+  EXPECT_EQ(buffer_pool_size, disk_manager->GetNumWrites());
+
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, DeletePageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  // Page 1 is evicted dirty before it is deleted, page 2 is deleted while in the pool.
+  page_id_t page_id_temp;
+  for (page_id_t page_id = 0; page_id < 3; ++page_id) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(page_id, page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  EXPECT_EQ(true, bpm->DeletePage(0));
+  EXPECT_EQ(true, bpm->DeletePage(2));
+  EXPECT_EQ(true, disk_manager->IsFreePage(0));
+
+  // Deleted pages are allocated again before the file grows.
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(0, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(2, page_id_temp);
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  EXPECT_EQ(0, disk_manager->GetNumFreePages());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceTest, StatsTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  enable_pin_timing = true;
+
+  page_id_t page_id_temp;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  ASSERT_NE(nullptr, bpm->FetchPage(page_id_temp));
+  EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  bpm->FlushAllPages();
+
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(1, stats.new_pages_);
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(0, stats.misses_);
+  EXPECT_EQ(1, stats.write_backs_);
+  EXPECT_EQ(0, stats.clean_evictions_ + stats.dirty_evictions_);
+  // The flush pinned the page too.
+  EXPECT_EQ(3, stats.pin_intervals_);
+  EXPECT_GE(stats.pin_duration_ns_, 2000000);
+  // NewPage and FlushAllPages took the latch, and nothing else was running.
+  EXPECT_EQ(2, stats.latch_waits_[0]);
+  EXPECT_EQ(0, stats.latch_wait_ns_);
+
+  enable_pin_timing = false;
+  delete bpm;
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Threads hammering pages that all fit in the pool go through the lock-free hit path and must keep pin counts exact
+TEST(BufferPoolManagerInstanceTest, ConcurrentHitTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 8;
+  const int num_threads = 4;
+  const int num_rounds = 5000;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    reinterpret_cast<int *>(page->GetData())[0] = page_id_temp;
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([bpm, tid] {
+      std::default_random_engine rng(tid);
+      std::uniform_int_distribution<page_id_t> uniform_dist(0, buffer_pool_size - 1);
+      for (int round = 0; round < num_rounds; ++round) {
+        page_id_t page_id = uniform_dist(rng);
+        auto *page = bpm->FetchPage(page_id);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(page_id, reinterpret_cast<int *>(page->GetData())[0]);
+        EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  // Every pin was dropped, so every frame can be reused.
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    EXPECT_EQ(0, bpm->GetPages()[i].GetPinCount());
+  }
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// A flush latches one page at a time, so it does not deadlock with a thread that latches pages in another order
+TEST(BufferPoolManagerInstanceTest, FlushLatchOrderTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+  page_id_t page_ids[2];
+  for (auto &page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, true));
+  }
+
+  // Hold the second page while the flush gets to it, then take the first.
+  Page *second = bpm->FetchPage(page_ids[1]);
+  second->WLatch();
+  std::thread flusher([bpm] { bpm->FlushAllPages(); });
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  Page *first = bpm->FetchPage(page_ids[0]);
+  first->WLatch();
+  first->WUnlatch();
+  second->WUnlatch();
+  flusher.join();
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[0], false));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids[1], false));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// The pool grows into its reserved frames and shrinks while one of the removed frames is still pinned
+TEST(BufferPoolManagerInstanceTest, ResizeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 10;
+  const size_t max_pool_size = 20;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU, NO_NUMA_NODE,
+                                            max_pool_size);
+  EXPECT_EQ(buffer_pool_size, bpm->GetPoolSize());
+  EXPECT_EQ(max_pool_size, bpm->GetMaxPoolSize());
+  EXPECT_EQ(false, bpm->Resize(0));
+  EXPECT_EQ(false, bpm->Resize(max_pool_size + 1));
+
+  // Growing makes room for more pinned pages.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page_id_t page_id_temp;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    page_ids.push_back(page_id_temp);
+  }
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+  EXPECT_EQ(true, bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size, bpm->GetPoolSize());
+  for (size_t i = buffer_pool_size; i < max_pool_size; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    page_ids.push_back(page_id_temp);
+  }
+  for (size_t i = 0; i < max_pool_size - 1; ++i) {
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], true));
+  }
+
+  // The last page stays pinned, so shrinking waits for the thread holding it.
+  std::thread holder([bpm, &page_ids] {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids.back(), true));
+  });
+  const size_t small_pool_size = 5;
+  EXPECT_EQ(true, bpm->Resize(small_pool_size));
+  holder.join();
+  EXPECT_EQ(small_pool_size, bpm->GetPoolSize());
+  for (size_t i = small_pool_size; i < max_pool_size; ++i) {
+    EXPECT_EQ(INVALID_PAGE_ID, bpm->GetPages()[i].GetPageId());
+  }
+
+  // The evicted pages were written back.
+  for (size_t i = buffer_pool_size; i < max_pool_size; ++i) {
+    auto *page = bpm->FetchPage(page_ids[i]);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_ids[i])).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_ids[i], false));
+  }
+
+  // Only the remaining frames can hold pinned pages.
+  for (size_t i = 0; i < small_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -19,7 +19,7 @@
 
 namespace bustub {
 
-TEST(ClockReplacerTest, DISABLED_SampleTest) {
+TEST(ClockReplacerTest, SampleTest) {
   ClockReplacer clock_replacer(7);
 
   // Scenario: unpin six elements, i.e. add them to the replacer.
@@ -59,4 +59,75 @@ TEST(ClockReplacerTest, DISABLED_SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(ClockReplacerTest, PeekVictimsTest) {
+  ClockReplacer clock_replacer(7);
+  for (frame_id_t frame_id = 1; frame_id <= 5; ++frame_id) {
+    clock_replacer.Unpin(frame_id);
+  }
+
+  // Every frame is referenced, so the first victim takes a full sweep and clears all the reference bits.
+  int value;
+  clock_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  clock_replacer.Unpin(3);
+
+  // Peeking reports the victims in the order Victim would return them and leaves them in the replacer.
+  std::vector<frame_id_t> frame_ids;
+  clock_replacer.PeekVictims(10, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{2, 4, 5, 3}), frame_ids);
+  EXPECT_EQ(4, clock_replacer.Size());
+  for (frame_id_t frame_id : frame_ids) {
+    clock_replacer.Victim(&value);
+    EXPECT_EQ(frame_id, value);
+  }
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+}
+
+TEST(ClockReplacerTest, ConcurrentTest) {
+  const size_t num_frames = 64;
+  const int num_threads = 4;
+  ClockReplacer clock_replacer(num_frames);
+
+  // Each thread owns a quarter of the frames and ends with all of them unpinned.
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([&clock_replacer, tid] {
+      for (int round = 0; round < 1000; ++round) {
+        for (size_t frame_id = tid; frame_id < num_frames; frame_id += num_threads) {
+          clock_replacer.Unpin(frame_id);
+          clock_replacer.Pin(frame_id);
+          clock_replacer.Unpin(frame_id);
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(num_frames, clock_replacer.Size());
+
+  std::vector<bool> seen(num_frames, false);
+  int value;
+  for (size_t i = 0; i < num_frames; ++i) {
+    ASSERT_TRUE(clock_replacer.Victim(&value));
+    EXPECT_FALSE(seen[value]);
+    seen[value] = true;
+  }
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+  EXPECT_EQ(0, clock_replacer.Size());
+}
+
+TEST(ClockReplacerTest, LateUnpinTest) {
+  ClockReplacer clock_replacer(2);
+  clock_replacer.Unpin(0);
+
+  // Frame 0 is claimed for page 11 by an eviction, and the unpin that dropped its last pin comes in just after.
+  int value;
+  ASSERT_TRUE(clock_replacer.Victim(&value));
+  clock_replacer.Unpin(0);
+  clock_replacer.SetFramePage(0, 11);
+  EXPECT_EQ(0, clock_replacer.Size());
+  EXPECT_FALSE(clock_replacer.Victim(&value));
+}
+
 }  // namespace bustub
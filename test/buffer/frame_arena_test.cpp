@@ -0,0 +1,86 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_arena_test.cpp
+//
+// Identification: test/buffer/frame_arena_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "buffer/frame_arena.h"
+#include "buffer/parallel_buffer_pool_manager.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(FrameArenaTest, SampleTest) {
+  const size_t num_frames = 1000;
+  FrameArena arena(num_frames);
+
+  // The frames are contiguous, start on a huge page boundary, and start out zeroed.
+  EXPECT_EQ(0, reinterpret_cast<uintptr_t>(arena.GetFrame(0)) % FrameArena::HUGE_PAGE_SIZE);
+  for (frame_id_t frame_id = 1; frame_id < static_cast<frame_id_t>(num_frames); ++frame_id) {
+    EXPECT_EQ(arena.GetFrame(frame_id - 1) + PAGE_SIZE, arena.GetFrame(frame_id));
+  }
+  char zeros[PAGE_SIZE] = {};
+  EXPECT_EQ(0, memcmp(zeros, arena.GetFrame(num_frames - 1), PAGE_SIZE));
+
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); ++frame_id) {
+    memset(arena.GetFrame(frame_id), frame_id % 128, PAGE_SIZE);
+  }
+  for (frame_id_t frame_id = 0; frame_id < static_cast<frame_id_t>(num_frames); ++frame_id) {
+    EXPECT_EQ(frame_id % 128, arena.GetFrame(frame_id)[PAGE_SIZE - 1]);
+  }
+}
+
+TEST(FrameArenaTest, NumaNodeTest) {
+  EXPECT_GE(FrameArena::NumNumaNodes(), 1);
+  int numa_node = FrameArena::CurrentNumaNode();
+  EXPECT_GE(numa_node, 0);
+
+  // Binding to the node the test runs on works wherever the kernel supports NUMA policies at all.
+  FrameArena arena(16, numa_node);
+  memset(arena.GetFrame(15), 1, PAGE_SIZE);
+  EXPECT_EQ(1, arena.GetFrame(15)[0]);
+}
+
+TEST(FrameArenaTest, NumaAwareBufferPoolTest) {
+  const std::string db_name = "test.db";
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(4, 8, disk_manager, nullptr, ReplacerType::LRU, true);
+
+  // New pages are created in the instances whose frames are on the caller's node.
+  const int num_nodes = FrameArena::NumNumaNodes();
+  const int numa_node = FrameArena::CurrentNumaNode();
+  std::vector<page_id_t> page_ids;
+  for (int i = 0; i < 16; ++i) {
+    page_id_t page_id_temp;
+    Page *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(numa_node, page_id_temp % 4 % num_nodes);
+    snprintf(page->GetData(), PAGE_SIZE, "Page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+  for (page_id_t page_id : page_ids) {
+    Page *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("Page " + std::to_string(page_id)).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+}  // namespace bustub
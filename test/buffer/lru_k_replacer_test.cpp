@@ -0,0 +1,144 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Simulate the buffer pool loading a page into a frame and releasing it. */
+static void Access(LRUKReplacer *replacer, frame_id_t frame_id) {
+  replacer->Pin(frame_id);
+  replacer->Unpin(frame_id);
+}
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2, 0);
+  for (frame_id_t frame_id = 1; frame_id <= 6; ++frame_id) {
+    lru_k_replacer.SetFramePage(frame_id, frame_id);
+    Access(&lru_k_replacer, frame_id);
+  }
+  // Frames 1 and 2 are referenced a second time, so they have a finite backward 2-distance.
+  Access(&lru_k_replacer, 2);
+  Access(&lru_k_replacer, 1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+
+  // Frames with a single reference go first, in LRU order.
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(3, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+
+  // Pinning takes a frame out; unpinning it again counts as another reference.
+  lru_k_replacer.Pin(5);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  lru_k_replacer.Unpin(5);
+  EXPECT_EQ(4, lru_k_replacer.Size());
+
+  std::vector<frame_id_t> frame_ids;
+  lru_k_replacer.PeekVictims(10, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{6, 1, 2, 5}), frame_ids);
+
+  // Then the frame whose second most recent reference is the oldest.
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  const size_t num_frames = 8;
+  LRUKReplacer lru_k_replacer(num_frames, 2, 4);
+
+  // Two hot pages, each referenced twice far enough apart to count as two references.
+  lru_k_replacer.SetFramePage(0, 100);
+  lru_k_replacer.SetFramePage(1, 101);
+  for (int i = 0; i < 2; ++i) {
+    Access(&lru_k_replacer, 0);
+    Access(&lru_k_replacer, 1);
+    for (int tick = 0; tick < 4; ++tick) {
+      lru_k_replacer.Pin(7);
+    }
+  }
+
+  // A scan touches every other frame many times in a row. Those references are correlated and count once.
+  page_id_t next_page_id = 0;
+  for (frame_id_t frame_id = 2; frame_id < static_cast<frame_id_t>(num_frames) - 1; ++frame_id) {
+    lru_k_replacer.SetFramePage(frame_id, next_page_id++);
+    for (int tuple = 0; tuple < 3; ++tuple) {
+      Access(&lru_k_replacer, frame_id);
+    }
+  }
+
+  // Keep scanning: every new page evicts an older scan page, never a hot one.
+  int value;
+  for (int i = 0; i < 20; ++i) {
+    ASSERT_TRUE(lru_k_replacer.Victim(&value));
+    EXPECT_NE(0, value);
+    EXPECT_NE(1, value);
+    lru_k_replacer.SetFramePage(value, next_page_id++);
+    for (int tuple = 0; tuple < 3; ++tuple) {
+      Access(&lru_k_replacer, value);
+    }
+  }
+}
+
+TEST(LRUKReplacerTest, EvictedHistoryTest) {
+  LRUKReplacer lru_k_replacer(3, 2, 0);
+  lru_k_replacer.SetFramePage(0, 10);
+  lru_k_replacer.SetFramePage(1, 11);
+  Access(&lru_k_replacer, 0);
+  Access(&lru_k_replacer, 0);
+  Access(&lru_k_replacer, 1);
+
+  // Page 10 is evicted from frame 0 in favor of page 12...
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.SetFramePage(0, 12);
+  Access(&lru_k_replacer, 0);
+
+  // ...and read back into frame 2. Its history comes with it, so it is kept over pages referenced only once.
+  lru_k_replacer.SetFramePage(2, 10);
+  Access(&lru_k_replacer, 2);
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(0, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+}
+
+TEST(LRUKReplacerTest, LateUnpinTest) {
+  LRUKReplacer lru_k_replacer(2, 2, 0);
+  lru_k_replacer.SetFramePage(0, 10);
+  Access(&lru_k_replacer, 0);
+
+  // Frame 0 is claimed for page 11 by an eviction, and the unpin that dropped its last pin comes in just after.
+  int value;
+  ASSERT_TRUE(lru_k_replacer.Victim(&value));
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.SetFramePage(0, 11);
+  lru_k_replacer.Pin(0);
+  EXPECT_EQ(0, lru_k_replacer.Size());
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+}  // namespace bustub
@@ -59,4 +59,40 @@ TEST(LRUReplacerTest, SampleTest) {
   EXPECT_EQ(4, value);
 }
 
+TEST(LRUReplacerTest, PeekVictimsTest) {
+  LRUReplacer lru_replacer(7);
+  for (frame_id_t frame_id = 1; frame_id <= 5; ++frame_id) {
+    lru_replacer.Unpin(frame_id);
+  }
+  lru_replacer.Pin(2);
+
+  // Peeking reports the victims in eviction order and leaves them in the replacer.
+  std::vector<frame_id_t> frame_ids;
+  lru_replacer.PeekVictims(3, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 3, 4}), frame_ids);
+  EXPECT_EQ(4, lru_replacer.Size());
+
+  lru_replacer.PeekVictims(10, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 3, 4, 5}), frame_ids);
+
+  int value;
+  lru_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_replacer.PeekVictims(1, &frame_ids);
+  EXPECT_EQ((std::vector<frame_id_t>{3}), frame_ids);
+}
+
+TEST(LRUReplacerTest, LateUnpinTest) {
+  LRUReplacer lru_replacer(2);
+  lru_replacer.Unpin(0);
+
+  // Frame 0 is claimed for page 11 by an eviction, and the unpin that dropped its last pin comes in just after.
+  int value;
+  ASSERT_TRUE(lru_replacer.Victim(&value));
+  lru_replacer.Unpin(0);
+  lru_replacer.SetFramePage(0, 11);
+  EXPECT_EQ(0, lru_replacer.Size());
+  EXPECT_FALSE(lru_replacer.Victim(&value));
+}
+
 }  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table_test.cpp
+//
+// Identification: test/buffer/page_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <random>
+#include <thread>  // NOLINT
+#include <unordered_map>
+#include <vector>
+
+#include "buffer/page_table.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(PageTableTest, SampleTest) {
+  PageTable page_table(4);
+  frame_id_t frame_id;
+
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+  page_table.Insert(0, 3);
+  page_table.Insert(8, 1);
+  page_table.Insert(16, 2);
+  EXPECT_TRUE(page_table.Find(8, &frame_id));
+  EXPECT_EQ(1, frame_id);
+
+  // Inserting an existing page replaces its frame.
+  page_table.Insert(8, 0);
+  EXPECT_TRUE(page_table.Find(8, &frame_id));
+  EXPECT_EQ(0, frame_id);
+
+  EXPECT_TRUE(page_table.Remove(0));
+  EXPECT_FALSE(page_table.Remove(0));
+  EXPECT_FALSE(page_table.Find(0, &frame_id));
+  EXPECT_TRUE(page_table.Find(8, &frame_id));
+  EXPECT_EQ(0, frame_id);
+  EXPECT_TRUE(page_table.Find(16, &frame_id));
+  EXPECT_EQ(2, frame_id);
+}
+
+TEST(PageTableTest, RandomOperationTest) {
+  // Keep the table full so that probe sequences are long and wrap around, and compare against a reference map.
+  const size_t num_frames = 64;
+  PageTable page_table(num_frames);
+  std::unordered_map<page_id_t, frame_id_t> reference;
+  std::default_random_engine rng(0);
+  std::uniform_int_distribution<page_id_t> page_dist(0, 4 * num_frames);
+
+  for (int i = 0; i < 20000; ++i) {
+    page_id_t page_id = page_dist(rng);
+    if (reference.count(page_id) != 0) {
+      EXPECT_TRUE(page_table.Remove(page_id));
+      reference.erase(page_id);
+    } else if (reference.size() < num_frames) {
+      page_table.Insert(page_id, i % num_frames);
+      reference[page_id] = i % num_frames;
+    }
+    for (page_id_t check = 0; check <= static_cast<page_id_t>(4 * num_frames); ++check) {
+      frame_id_t frame_id;
+      auto iter = reference.find(check);
+      ASSERT_EQ(iter != reference.end(), page_table.Find(check, &frame_id));
+      if (iter != reference.end()) {
+        EXPECT_EQ(iter->second, frame_id);
+      }
+    }
+  }
+}
+
+TEST(PageTableTest, ConcurrentFindTest) {
+  // One writer keeps moving entries around while readers look up pages that are never removed. Readers may miss
+  // them, but must never see a wrong frame.
+  const size_t num_frames = 32;
+  const page_id_t num_stable = 8;
+  PageTable page_table(num_frames);
+  for (page_id_t page_id = 0; page_id < num_stable; ++page_id) {
+    page_table.Insert(page_id, page_id);
+  }
+
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int tid = 0; tid < 2; ++tid) {
+    readers.emplace_back([&page_table, &done] {
+      while (!done) {
+        for (page_id_t page_id = 0; page_id < num_stable; ++page_id) {
+          frame_id_t frame_id;
+          if (page_table.Find(page_id, &frame_id)) {
+            EXPECT_EQ(page_id, frame_id);
+          }
+        }
+      }
+    });
+  }
+
+  for (int round = 0; round < 2000; ++round) {
+    for (page_id_t page_id = num_stable; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+      page_table.Insert(page_id + round, page_id);
+    }
+    for (page_id_t page_id = num_stable; page_id < static_cast<page_id_t>(num_frames); ++page_id) {
+      page_table.Remove(page_id + round);
+    }
+  }
+  done = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+
+  for (page_id_t page_id = 0; page_id < num_stable; ++page_id) {
+    frame_id_t frame_id;
+    ASSERT_TRUE(page_table.Find(page_id, &frame_id));
+    EXPECT_EQ(page_id, frame_id);
+  }
+}
+
+}  // namespace bustub
@@ -12,8 +12,12 @@
 
 #include "buffer/parallel_buffer_pool_manager.h"
 #include <cstdio>
+#include <cstring>
 #include <random>
+#include <set>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 #include "buffer/buffer_pool_manager.h"
 #include "gtest/gtest.h"
 
@@ -151,4 +155,135 @@ TEST(ParallelBufferPoolManagerTest, SampleTest) {
   delete disk_manager;
 }
 
+TEST(ParallelBufferPoolManagerTest, StatsTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 2;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  // Create dirty pages, push them out with clean ones, then fetch them all back.
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    page_id_t page_id_temp;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+  for (size_t i = 0; i < buffer_pool_size * num_instances; ++i) {
+    page_id_t page_id_temp;
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id_temp));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, false));
+  }
+  for (page_id_t page_id : page_ids) {
+    ASSERT_NE(nullptr, bpm->FetchPage(page_id));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+  ASSERT_NE(nullptr, bpm->FetchPage(page_ids.back()));
+  EXPECT_EQ(true, bpm->UnpinPage(page_ids.back(), false));
+
+  // The counters of every instance add up.
+  BufferPoolStats stats = bpm->GetStats();
+  EXPECT_EQ(2 * buffer_pool_size * num_instances, stats.new_pages_);
+  EXPECT_EQ(buffer_pool_size * num_instances, stats.misses_);
+  EXPECT_EQ(1, stats.hits_);
+  EXPECT_EQ(buffer_pool_size * num_instances, stats.dirty_evictions_);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(ParallelBufferPoolManagerTest, ResizeTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 4;
+  const size_t max_pool_size = 8;
+  const size_t num_instances = 3;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager, nullptr, ReplacerType::LRU,
+                                            false, max_pool_size);
+  EXPECT_EQ(buffer_pool_size * num_instances, bpm->GetPoolSize());
+  EXPECT_EQ(false, bpm->Resize(max_pool_size + 1));
+
+  // Fill the grown pool with dirty pages, then shrink it below its original size.
+  EXPECT_EQ(true, bpm->Resize(max_pool_size));
+  EXPECT_EQ(max_pool_size * num_instances, bpm->GetPoolSize());
+  std::vector<page_id_t> page_ids;
+  for (size_t i = 0; i < max_pool_size * num_instances; ++i) {
+    page_id_t page_id_temp;
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+    page_ids.push_back(page_id_temp);
+  }
+  EXPECT_EQ(true, bpm->Resize(2));
+  EXPECT_EQ(2 * num_instances, bpm->GetPoolSize());
+
+  for (page_id_t page_id : page_ids) {
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), ("page " + std::to_string(page_id)).c_str()));
+    EXPECT_EQ(true, bpm->UnpinPage(page_id, false));
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+// Threads creating pages at the same time get distinct pages until every frame of every instance is pinned
+TEST(ParallelBufferPoolManagerTest, ConcurrentNewPageTest) {
+  const std::string db_name = "test.db";
+  const size_t buffer_pool_size = 16;
+  const size_t num_instances = 4;
+  const size_t num_threads = 4;
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new ParallelBufferPoolManager(num_instances, buffer_pool_size, disk_manager);
+
+  std::vector<std::vector<page_id_t>> thread_page_ids(num_threads);
+  std::vector<std::thread> threads;
+  for (size_t tid = 0; tid < num_threads; ++tid) {
+    threads.emplace_back([bpm, &thread_page_ids, tid] {
+      for (size_t i = 0; i < buffer_pool_size * num_instances / num_threads; ++i) {
+        page_id_t page_id_temp;
+        auto *page = bpm->NewPage(&page_id_temp);
+        ASSERT_NE(nullptr, page);
+        EXPECT_EQ(page_id_temp, page->GetPageId());
+        thread_page_ids[tid].push_back(page_id_temp);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  std::set<page_id_t> page_ids;
+  for (auto &ids : thread_page_ids) {
+    page_ids.insert(ids.begin(), ids.end());
+  }
+  EXPECT_EQ(buffer_pool_size * num_instances, page_ids.size());
+  page_id_t page_id_temp;
+  EXPECT_EQ(nullptr, bpm->NewPage(&page_id_temp));
+
+  // A frame freed in any instance is found again.
+  EXPECT_EQ(true, bpm->UnpinPage(*page_ids.begin(), false));
+  EXPECT_NE(nullptr, bpm->NewPage(&page_id_temp));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+
+  delete bpm;
+  delete disk_manager;
+}
+
 }  // namespace bustub
@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bounded_queue_test.cpp
+//
+// Identification: test/common/bounded_queue_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <memory>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/bounded_queue.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BoundedQueueTest, SingleThreadTest) {
+  BoundedQueue<std::unique_ptr<int>> queue(5);
+  ASSERT_EQ(8, queue.GetCapacity());
+
+  // Around the ring a few times, first in first out.
+  for (int lap = 0; lap < 3; lap++) {
+    for (int i = 0; i < 8; i++) {
+      auto item = std::make_unique<int>(i);
+      ASSERT_TRUE(queue.TryPush(&item));
+      EXPECT_EQ(nullptr, item);
+    }
+    auto extra = std::make_unique<int>(8);
+    EXPECT_FALSE(queue.TryPush(&extra));
+    EXPECT_NE(nullptr, extra);
+    for (int i = 0; i < 8; i++) {
+      std::unique_ptr<int> item;
+      ASSERT_TRUE(queue.TryPop(&item));
+      EXPECT_EQ(i, *item);
+    }
+    std::unique_ptr<int> item;
+    EXPECT_FALSE(queue.TryPop(&item));
+  }
+
+  // A closed queue takes no more items, and gives out those it has.
+  auto item = std::make_unique<int>(1);
+  ASSERT_TRUE(queue.Push(&item));
+  queue.Close();
+  EXPECT_TRUE(queue.IsClosed());
+  item = std::make_unique<int>(2);
+  EXPECT_FALSE(queue.Push(&item));
+  ASSERT_TRUE(queue.Pop(&item));
+  EXPECT_EQ(1, *item);
+  EXPECT_FALSE(queue.Pop(&item));
+}
+
+// NOLINTNEXTLINE
+TEST(BoundedQueueTest, ConcurrentTest) {
+  const int num_threads = 4;
+  const int num_items = 20000;
+  BoundedQueue<int> queue(16);
+
+  // Producers and consumers wait on each other through a small queue; every item comes out exactly once.
+  std::vector<std::atomic<int>> seen(num_threads * num_items);
+  std::vector<std::thread> producers;
+  std::vector<std::thread> consumers;
+  for (int tid = 0; tid < num_threads; tid++) {
+    producers.emplace_back([&queue, tid] {
+      for (int i = 0; i < num_items; i++) {
+        int item = tid * num_items + i;
+        ASSERT_TRUE(queue.Push(&item));
+      }
+    });
+    consumers.emplace_back([&queue, &seen] {
+      int item;
+      while (queue.Pop(&item)) {
+        seen[item]++;
+      }
+    });
+  }
+  for (auto &producer : producers) {
+    producer.join();
+  }
+  queue.Close();
+  for (auto &consumer : consumers) {
+    consumer.join();
+  }
+  for (const auto &count : seen) {
+    ASSERT_EQ(1, count.load());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,99 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// bustub_instance_test.cpp
+//
+// Identification: test/common/bustub_instance_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+
+#include "common/bustub_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(BustubInstanceTest, PageSizeTest) {
+  remove("test.db");
+  remove("test.log");
+
+  // A new database records its page size in its header page.
+  auto *bustub_instance = new BustubInstance("test.db", 16, 2);
+  EXPECT_EQ(32, bustub_instance->buffer_pool_manager_->GetPoolSize());
+  auto *header_page = static_cast<HeaderPage *>(bustub_instance->buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  ASSERT_NE(nullptr, header_page);
+  EXPECT_EQ(PAGE_SIZE, header_page->GetPageSize());
+  EXPECT_EQ(0, header_page->GetRecordCount());
+  bustub_instance->buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+  delete bustub_instance;
+
+  // It opens again with the same page size.
+  bustub_instance = new BustubInstance("test.db");
+  EXPECT_EQ(BUFFER_POOL_SIZE, bustub_instance->buffer_pool_manager_->GetPoolSize());
+  delete bustub_instance;
+
+  // It does not open with any other.
+  auto *disk_manager = new DiskManager("test.db");
+  char data[PAGE_SIZE];
+  disk_manager->ReadPage(HEADER_PAGE_ID, data);
+  uint32_t page_size = 2 * PAGE_SIZE;
+  memcpy(data + 4, &page_size, sizeof(page_size));
+  EXPECT_EQ(page_size, HeaderPage::ReadPageSize(data));
+  disk_manager->WritePage(HEADER_PAGE_ID, data);
+  disk_manager->ShutDown();
+  delete disk_manager;
+  EXPECT_THROW(BustubInstance("test.db"), Exception);
+
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BustubInstanceTest, LegacyHeaderPageTest) {
+  remove("test.db");
+  remove("test.log");
+
+  // A header page written before the page size was recorded: the record count, then the records.
+  auto *disk_manager = new DiskManager("test.db");
+  EXPECT_EQ(HEADER_PAGE_ID, disk_manager->AllocatePage());
+  char data[PAGE_SIZE] = {0};
+  int record_count = 1;
+  page_id_t root_id = 7;
+  memcpy(data, &record_count, sizeof(record_count));
+  strncpy(data + 4, "legacy", 32);
+  memcpy(data + 4 + 32, &root_id, sizeof(root_id));
+  disk_manager->WritePage(HEADER_PAGE_ID, data);
+  disk_manager->ShutDown();
+  delete disk_manager;
+
+  // Such databases were created with 4096 byte pages.
+  if (PAGE_SIZE != 4096) {
+    EXPECT_THROW(BustubInstance("test.db"), Exception);
+  } else {
+    auto *bustub_instance = new BustubInstance("test.db");
+    auto *header_page = static_cast<HeaderPage *>(bustub_instance->buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+    ASSERT_NE(nullptr, header_page);
+    EXPECT_EQ(4096, header_page->GetPageSize());
+    EXPECT_EQ(1, header_page->GetRecordCount());
+    page_id_t found_root_id;
+    EXPECT_TRUE(header_page->GetRootId("legacy", &found_root_id));
+    EXPECT_EQ(root_id, found_root_id);
+    EXPECT_TRUE(header_page->InsertRecord("added", 8));
+    EXPECT_TRUE(header_page->GetRootId("added", &found_root_id));
+    EXPECT_EQ(8, found_root_id);
+    EXPECT_EQ(2, header_page->GetRecordCount());
+    bustub_instance->buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+    delete bustub_instance;
+  }
+
+  remove("test.db");
+  remove("test.log");
+}
+
+}  // namespace bustub
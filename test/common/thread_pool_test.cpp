@@ -0,0 +1,63 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// thread_pool_test.cpp
+//
+// Identification: test/common/thread_pool_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <mutex>  // NOLINT
+
+#include "common/thread_pool.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(ThreadPoolTest, BlockingTasksTest) {
+  const int num_tasks = 8;
+  ThreadPool pool;
+  std::mutex latch;
+  std::condition_variable cv;
+
+  // Each task waits for all of them to have started, which only finishes if every task gets a thread.
+  for (int round = 0; round < 3; round++) {
+    int started = 0;
+    int finished = 0;
+    for (int i = 0; i < num_tasks; i++) {
+      pool.Submit([&] {
+        std::unique_lock<std::mutex> lock(latch);
+        started++;
+        cv.notify_all();
+        cv.wait(lock, [&] { return started == num_tasks; });
+        finished++;
+        cv.notify_all();
+      });
+    }
+    std::unique_lock<std::mutex> lock(latch);
+    cv.wait(lock, [&] { return finished == num_tasks; });
+    EXPECT_EQ(num_tasks, started);
+  }
+  EXPECT_LE(num_tasks, pool.GetNumThreads());
+}
+
+// NOLINTNEXTLINE
+TEST(ThreadPoolTest, ShutdownTest) {
+  // The tasks submitted run before the pool is gone.
+  std::atomic<int> count{0};
+  {
+    ThreadPool pool;
+    for (int i = 0; i < 100; i++) {
+      pool.Submit([&count] { count++; });
+    }
+  }
+  EXPECT_EQ(100, count.load());
+}
+
+}  // namespace bustub
@@ -11,6 +11,7 @@
 //===----------------------------------------------------------------------===//
 
 #include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
@@ -139,4 +140,45 @@ TEST(HashTableTest, SampleTest) {
   delete bpm;
 }
 
+// NOLINTNEXTLINE
+TEST(HashTableTest, BulkInsertTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  ExtendibleHashTable<int, int, IntComparator> ht("blah", bpm, IntComparator(), HashFunction<int>());
+
+  // an empty table is built bottom-up with the directory sized for the batch
+  const size_t num_keys = 5000;
+  std::vector<std::pair<int, int>> entries;
+  for (size_t i = 0; i < num_keys; i++) {
+    entries.emplace_back(i, i);
+  }
+  EXPECT_EQ(num_keys, ht.BulkInsert(nullptr, entries));
+  EXPECT_LT(0, ht.GetGlobalDepth());
+  ht.VerifyIntegrity();
+  for (int i = 0; i < static_cast<int>(num_keys); i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    ASSERT_EQ(1, res.size()) << "Failed to keep " << i << std::endl;
+    EXPECT_EQ(i, res[0]);
+  }
+
+  // a batch into a non-empty table goes through the normal inserts, which reject duplicated pairs
+  entries.clear();
+  for (int i = 0; i < static_cast<int>(num_keys); i++) {
+    entries.emplace_back(i, i % 2 == 0 ? i : 2 * i);
+  }
+  EXPECT_EQ(num_keys / 2, ht.BulkInsert(nullptr, entries));
+  ht.VerifyIntegrity();
+  for (int i = 0; i < static_cast<int>(num_keys); i++) {
+    std::vector<int> res;
+    ht.GetValue(nullptr, i, &res);
+    EXPECT_EQ(i % 2 == 0 ? 1U : 2U, res.size()) << "Failed to insert " << i << std::endl;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete disk_manager;
+  delete bpm;
+}
+
 }  // namespace bustub
@@ -0,0 +1,208 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_expression_test.cpp
+//
+// Identification: test/execution/compiled_expression_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/compiled_expression.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** The types of the columns of the test batches. */
+static const std::vector<TypeId> COLUMN_TYPES{TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT,
+                                              TypeId::DECIMAL, TypeId::TIMESTAMP, TypeId::BOOLEAN, TypeId::VARCHAR};
+
+/** @return a value of a type from a small integer, or null one time in eight */
+static Value MakeValue(TypeId type_id, int i, bool null) {
+  if (null) {
+    return ValueFactory::GetNullValueByType(type_id);
+  }
+  switch (type_id) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(i));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(i));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(i);
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(i);
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(static_cast<double>(i) / 2);
+    case TypeId::TIMESTAMP:
+      return ValueFactory::GetTimestampValue(i + 4);
+    case TypeId::BOOLEAN:
+      return ValueFactory::GetBooleanValue(i >= 0);
+    default:
+      return ValueFactory::GetVarcharValue(std::to_string(i));
+  }
+}
+
+/** @return a column of each of COLUMN_TYPES */
+static std::vector<Column> MakeColumns() {
+  std::vector<Column> columns;
+  for (uint32_t col_idx = 0; col_idx < COLUMN_TYPES.size(); col_idx++) {
+    std::string name = "col" + std::to_string(col_idx);
+    if (COLUMN_TYPES[col_idx] == TypeId::VARCHAR) {
+      columns.emplace_back(name, TypeId::VARCHAR, 8);
+    } else {
+      columns.emplace_back(name, COLUMN_TYPES[col_idx]);
+    }
+  }
+  return columns;
+}
+
+/** Fill a batch of a schema of COLUMN_TYPES with small values, and a few nulls. */
+static void FillBatch(const Schema *schema, size_t num_rows, std::mt19937 *generator, TupleBatch *batch) {
+  std::uniform_int_distribution<int> distribution(-4, 4);
+  batch->Init(schema);
+  for (size_t i = 0; i < num_rows; i++) {
+    for (uint32_t col_idx = 0; col_idx < COLUMN_TYPES.size(); col_idx++) {
+      batch->AppendValue(col_idx, MakeValue(COLUMN_TYPES[col_idx], distribution(*generator), (*generator)() % 8 == 0));
+    }
+    batch->FinishRow(RID());
+  }
+}
+
+static CmpBool ToCmpBool(const Value &value) {
+  if (value.IsNull()) {
+    return CmpBool::CmpNull;
+  }
+  return value.GetAs<bool>() ? CmpBool::CmpTrue : CmpBool::CmpFalse;
+}
+
+static const std::vector<ComparisonType> COMPARISON_TYPES{ComparisonType::Equal,
+                                                          ComparisonType::NotEqual,
+                                                          ComparisonType::LessThan,
+                                                          ComparisonType::LessThanOrEqual,
+                                                          ComparisonType::GreaterThan,
+                                                          ComparisonType::GreaterThanOrEqual};
+
+/** @return true if two types can be compared: both numeric, or both of the same type */
+static bool IsComparable(TypeId left, TypeId right) {
+  auto is_numeric = [](TypeId type_id) {
+    return type_id != TypeId::TIMESTAMP && type_id != TypeId::BOOLEAN && type_id != TypeId::VARCHAR;
+  };
+  return left == right || (is_numeric(left) && is_numeric(right));
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, BatchTest) {
+  std::mt19937 generator(15445);
+  Schema schema(MakeColumns());
+  TupleBatch batch;
+  FillBatch(&schema, 200, &generator, &batch);
+
+  std::vector<ColumnValueExpression> cols;
+  std::vector<ConstantValueExpression> constants;
+  for (uint32_t col_idx = 0; col_idx < COLUMN_TYPES.size(); col_idx++) {
+    cols.emplace_back(0, col_idx, COLUMN_TYPES[col_idx]);
+    constants.emplace_back(MakeValue(COLUMN_TYPES[col_idx], 1, false));
+  }
+
+  // Every comparison of two columns, or of a column and a constant, of types that compare.
+  for (uint32_t left = 0; left < COLUMN_TYPES.size(); left++) {
+    for (uint32_t right = 0; right < COLUMN_TYPES.size(); right++) {
+      if (!IsComparable(COLUMN_TYPES[left], COLUMN_TYPES[right])) {
+        continue;
+      }
+      for (ComparisonType comp_type : COMPARISON_TYPES) {
+        ComparisonExpression col_col(&cols[left], &cols[right], comp_type);
+        ComparisonExpression col_const(&cols[left], &constants[right], comp_type);
+        for (const AbstractExpression *expr : std::vector<const AbstractExpression *>{&col_col, &col_const}) {
+          CompiledExpression compiled(expr, &schema);
+          for (uint32_t row = 0; row < batch.Size(); row++) {
+            ASSERT_EQ(ToCmpBool(expr->EvaluateInBatch(&batch, row)), compiled.EvaluateInBatch(&batch, row))
+                << "columns " << left << ", " << right << ", row " << row;
+          }
+        }
+      }
+    }
+  }
+
+  // (col2 < 1 AND col4 >= col0) OR (col7 = '1' AND col6), nulls included
+  ComparisonExpression int_lt(&cols[2], &constants[2], ComparisonType::LessThan);
+  ComparisonExpression decimal_ge(&cols[4], &cols[0], ComparisonType::GreaterThanOrEqual);
+  ComparisonExpression varchar_eq(&cols[7], &constants[7], ComparisonType::Equal);
+  LogicExpression left_and(&int_lt, &decimal_ge, LogicType::And);
+  LogicExpression right_and(&varchar_eq, &cols[6], LogicType::And);
+  LogicExpression or_expr(&left_and, &right_and, LogicType::Or);
+  CompiledExpression compiled(&or_expr, &schema);
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    ASSERT_EQ(ToCmpBool(or_expr.EvaluateInBatch(&batch, row)), compiled.EvaluateInBatch(&batch, row)) << "row " << row;
+  }
+
+  // Loads of col2, col4 and col0, a conversion of col0, two comparisons and AND; the constant needs no instruction.
+  EXPECT_EQ(7U, CompiledExpression(&left_and, &schema).GetNumInstructions());
+  // The comparison of VARCHARs is evaluated as a whole.
+  EXPECT_EQ(1U, CompiledExpression(&varchar_eq, &schema).GetNumInstructions());
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, JoinTest) {
+  std::mt19937 generator(15445);
+  Schema schema(MakeColumns());
+  TupleBatch left_batch;
+  TupleBatch right_batch;
+  FillBatch(&schema, 40, &generator, &left_batch);
+  FillBatch(&schema, 40, &generator, &right_batch);
+
+  // left.col2 = right.col3 AND left.col5 < right.col5
+  ColumnValueExpression left_int(0, 2, TypeId::INTEGER);
+  ColumnValueExpression right_bigint(1, 3, TypeId::BIGINT);
+  ColumnValueExpression left_timestamp(0, 5, TypeId::TIMESTAMP);
+  ColumnValueExpression right_timestamp(1, 5, TypeId::TIMESTAMP);
+  ComparisonExpression key_eq(&left_int, &right_bigint, ComparisonType::Equal);
+  ComparisonExpression timestamp_lt(&left_timestamp, &right_timestamp, ComparisonType::LessThan);
+  LogicExpression and_expr(&key_eq, &timestamp_lt, LogicType::And);
+
+  CompiledExpression compiled(&and_expr, &schema, &schema);
+  for (uint32_t left_row = 0; left_row < left_batch.Size(); left_row++) {
+    for (uint32_t right_row = 0; right_row < right_batch.Size(); right_row++) {
+      ASSERT_EQ(ToCmpBool(and_expr.EvaluateJoinInBatch(&left_batch, left_row, &right_batch, right_row)),
+                compiled.EvaluateJoinInBatch(&left_batch, left_row, &right_batch, right_row));
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(CompiledExpressionTest, AggregateTest) {
+  // HAVING count > 2 OR max(decimal) <= group_by
+  AggregateValueExpression group_by(true, 0, TypeId::INTEGER);
+  AggregateValueExpression count(false, 0, TypeId::INTEGER);
+  AggregateValueExpression max(false, 1, TypeId::DECIMAL);
+  ConstantValueExpression two(ValueFactory::GetIntegerValue(2));
+  ComparisonExpression count_gt(&count, &two, ComparisonType::GreaterThan);
+  ComparisonExpression max_le(&max, &group_by, ComparisonType::LessThanOrEqual);
+  LogicExpression having(&count_gt, &max_le, LogicType::Or);
+  CompiledExpression compiled(&having);
+
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int> distribution(-4, 4);
+  for (int i = 0; i < 200; i++) {
+    std::vector<Value> group_bys{MakeValue(TypeId::INTEGER, distribution(generator), generator() % 8 == 0)};
+    std::vector<Value> aggregates{MakeValue(TypeId::INTEGER, distribution(generator), false),
+                                  MakeValue(TypeId::DECIMAL, distribution(generator), generator() % 8 == 0)};
+    ASSERT_EQ(ToCmpBool(having.EvaluateAggregate(group_bys, aggregates)),
+              compiled.EvaluateAggregate(group_bys, aggregates));
+  }
+}
+
+}  // namespace bustub
@@ -10,9 +10,11 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
 #include <memory>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -30,6 +32,7 @@
 #include "execution/expressions/constant_value_expression.h"
 #include "execution/plans/delete_plan.h"
 #include "execution/plans/distinct_plan.h"
+#include "execution/plans/exchange_plan.h"
 #include "execution/plans/hash_join_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/seq_scan_plan.h"
@@ -110,6 +113,183 @@ TEST_F(ExecutorTest, SimpleSeqScanTest) {
   }
 }
 
+// SELECT col_a, col_b FROM test_1 WHERE col_a < 900, a batch at a time
+TEST_F(ExecutorTest, BatchSeqScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const900 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(900));
+  auto *predicate = MakeComparisonExpression(col_a, const900, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+
+  // Read the scan a batch at a time
+  executor->Init();
+  TupleBatch batch;
+  std::vector<RID> rids;
+  while (executor->NextBatch(&batch)) {
+    ASSERT_LE(batch.Size(), EXECUTION_BATCH_SIZE);
+    for (size_t i = 0; i < batch.Size(); i++) {
+      uint32_t row = batch.GetRow(i);
+      ASSERT_TRUE(batch.GetValue(0, row).GetAs<int32_t>() < 900);
+      ASSERT_TRUE(batch.GetValue(1, row).GetAs<int32_t>() < 10);
+      rids.push_back(batch.GetRid(row));
+    }
+  }
+  ASSERT_EQ(rids.size(), 900);
+
+  // Read it again a tuple at a time
+  executor->Init();
+  Tuple tuple;
+  RID rid;
+  size_t num_tuples = 0;
+  while (executor->Next(&tuple, &rid)) {
+    ASSERT_LT(num_tuples, rids.size());
+    ASSERT_EQ(rid, rids[num_tuples++]);
+    ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 900);
+  }
+  ASSERT_EQ(num_tuples, rids.size());
+}
+
+// SELECT col_a, col_b FROM test_1 WHERE col_a < 900, on four threads
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const900 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(900));
+  auto *predicate = MakeComparisonExpression(col_a, const900, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode plan{out_schema, predicate, table_info->oid_};
+
+  auto serial = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  serial->Init();
+  std::vector<RID> expected;
+  Tuple tuple;
+  RID rid;
+  while (serial->Next(&tuple, &rid)) {
+    expected.push_back(rid);
+  }
+  ASSERT_EQ(expected.size(), 900);
+  std::sort(expected.begin(), expected.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+
+  // The threads return the same tuples, in some order, every time the scan is run.
+  GetExecutorContext()->SetParallelism(4);
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  for (int round = 0; round < 2; round++) {
+    executor->Init();
+    std::vector<RID> rids;
+    while (executor->Next(&tuple, &rid)) {
+      ASSERT_TRUE(tuple.GetValue(out_schema, out_schema->GetColIdx("colA")).GetAs<int32_t>() < 900);
+      rids.push_back(rid);
+    }
+    std::sort(rids.begin(), rids.end(), [](const RID &a, const RID &b) { return a.Get() < b.Get(); });
+    ASSERT_EQ(expected, rids);
+  }
+
+  // A scan abandoned part way stops its threads.
+  executor->Init();
+  ASSERT_TRUE(executor->Next(&tuple, &rid));
+  executor.reset();
+  GetExecutorContext()->SetParallelism(1);
+}
+
+// INSERT INTO empty_table2 VALUES ..., a few rows at a time, after the first of several pages is emptied
+TEST_F(ExecutorTest, RawInsertReusesFreeSpaceTest) {
+  auto table_info = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  const auto &schema = table_info->schema_;
+  std::vector<RID> rids;
+  for (int i = 0; i < 1000; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetIntegerValue(0)};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, GetTxn()));
+    rids.push_back(rid);
+  }
+  page_id_t first_page_id = rids.front().GetPageId();
+  ASSERT_NE(first_page_id, rids.back().GetPageId());
+  Transaction *delete_txn = GetTxnManager()->Begin();
+  int num_deleted = 0;
+  for (const RID &rid : rids) {
+    if (rid.GetPageId() == first_page_id) {
+      ASSERT_TRUE(table_info->table_->MarkDelete(rid, delete_txn));
+      num_deleted++;
+    }
+  }
+  GetTxnManager()->Commit(delete_txn);
+  delete delete_txn;
+
+  // More rows than the last page has room for: small inserts reuse the emptied page rather than append to the table.
+  for (int i = 0; i < num_deleted; i += 50) {
+    std::vector<std::vector<Value>> raw_vals;
+    for (int j = i; j < std::min(num_deleted, i + 50); j++) {
+      raw_vals.push_back({ValueFactory::GetIntegerValue(1000 + j), ValueFactory::GetIntegerValue(0)});
+    }
+    InsertPlanNode insert_plan{std::move(raw_vals), table_info->oid_};
+    GetExecutionEngine()->Execute(&insert_plan, nullptr, GetTxn(), GetExecutorContext());
+  }
+
+  auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto out_schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+  executor->Init();
+  Tuple tuple;
+  RID rid;
+  size_t count = 0;
+  size_t num_reused = 0;
+  while (executor->Next(&tuple, &rid)) {
+    if (tuple.GetValue(out_schema, 0).GetAs<int32_t>() >= 1000 && rid.GetPageId() == first_page_id) {
+      num_reused++;
+    }
+    count++;
+  }
+  ASSERT_EQ(rids.size(), count);
+  ASSERT_LT(0, num_reused);
+}
+
+// SELECT a FROM read_ahead_table, with and without read-ahead
+TEST_F(ExecutorTest, SeqScanReadAheadTest) {
+  Schema schema{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  TableInfo *table_info = GetCatalog()->CreateTable(GetTxn(), "read_ahead_table", schema);
+  const int num_tuples = 800;
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(150, 'x'))};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(Tuple(values, &schema), &rid, GetTxn()));
+  }
+  GetBPM()->FlushAllPages();
+  // Few enough frames that read-ahead evicts pages before the scan reaches them, if it is not held back.
+  ASSERT_TRUE(static_cast<BufferPoolManagerInstance *>(GetBPM())->Resize(10));
+
+  auto *col_a = MakeColumnValueExpression(schema, 0, "a");
+  auto *out_schema = MakeOutputSchema({{"a", col_a}});
+  SeqScanPlanNode plan{out_schema, nullptr, table_info->oid_};
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &plan);
+  auto scan_reads = [&] {
+    int num_reads = GetDiskManager()->GetNumReads();
+    executor->Init();
+    int count = 0;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      count++;
+    }
+    EXPECT_EQ(num_tuples, count);
+    return GetDiskManager()->GetNumReads() - num_reads;
+  };
+
+  // The scan follows the read-ahead window of the table, and reads no page more than once either way.
+  table_info->table_->SetReadAheadWindow(0);
+  int reads_without = scan_reads();
+  EXPECT_EQ(0, GetBPM()->GetStats().prefetches_);
+  table_info->table_->SetReadAheadWindow(TABLE_READ_AHEAD_WINDOW);
+  int reads_with = scan_reads();
+  EXPECT_LT(0, GetBPM()->GetStats().prefetches_);
+  EXPECT_EQ(reads_without, reads_with);
+}
+
 // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
 TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // Create Values to insert
@@ -417,6 +597,53 @@ TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   ASSERT_EQ(result_set.size(), 100);
 }
 
+// SELECT test_1.colA, test_2.col1 FROM test_1, test_2
+TEST_F(ExecutorTest, BatchNestedLoopJoinTest) {
+  const Schema *out_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto col_a = MakeColumnValueExpression(schema, 0, "colA");
+    out_schema1 = MakeOutputSchema({{"colA", col_a}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(out_schema1, nullptr, table_info->oid_);
+  }
+
+  const Schema *out_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto col1 = MakeColumnValueExpression(schema, 0, "col1");
+    out_schema2 = MakeOutputSchema({{"col1", col1}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(out_schema2, nullptr, table_info->oid_);
+  }
+
+  // The cross product takes many output batches
+  const Schema *out_final;
+  std::unique_ptr<NestedLoopJoinPlanNode> join_plan;
+  {
+    auto col_a = MakeColumnValueExpression(*out_schema1, 0, "colA");
+    auto col1 = MakeColumnValueExpression(*out_schema2, 1, "col1");
+    out_final = MakeOutputSchema({{"colA", col_a}, {"col1", col1}});
+    join_plan = std::make_unique<NestedLoopJoinPlanNode>(
+        out_final, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, nullptr);
+  }
+
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(join_plan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(result_set.size(), TEST1_SIZE * TEST2_SIZE);
+
+  // Every row of test_1 is joined with every row of test_2
+  std::vector<size_t> counts(TEST1_SIZE, 0);
+  for (const auto &tuple : result_set) {
+    counts[tuple.GetValue(out_final, 0).GetAs<int32_t>()]++;
+  }
+  for (size_t count : counts) {
+    ASSERT_EQ(count, TEST2_SIZE);
+  }
+}
+
 // SELECT test_4.colA, test_4.colB, test_6.colA, test_6.colB FROM test_4 JOIN test_6 ON test_4.colA = test_6.colA;
 TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // Construct sequential scan of table test_4
@@ -486,6 +713,74 @@ TEST_F(ExecutorTest, SimpleHashJoinTest) {
   }
 }
 
+// SELECT a.colA, a.colB, b.colA, b.colB FROM test_1 a JOIN test_1 b ON a.colA = b.colA, then ON a.colB = b.colB,
+// with a memory budget far smaller than the build side
+TEST_F(ExecutorTest, SpillingHashJoinTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  const Schema *scan_schema{};
+  std::unique_ptr<AbstractPlanNode> scan_plan1{};
+  std::unique_ptr<AbstractPlanNode> scan_plan2{};
+  {
+    auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+    scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(scan_schema, nullptr, table_info->oid_);
+  }
+  auto *left_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *left_col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  auto *right_col_a = MakeColumnValueExpression(*scan_schema, 1, "colA");
+  auto *right_col_b = MakeColumnValueExpression(*scan_schema, 1, "colB");
+  const Schema *out_schema = MakeOutputSchema(
+      {{"left_colA", left_col_a}, {"left_colB", left_col_b}, {"right_colA", right_col_a}, {"right_colB", right_col_b}});
+
+  // The expected number of matches on colB, which takes only 10 values
+  std::vector<size_t> col_b_counts(10);
+  {
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(scan_plan1.get(), &result_set, GetTxn(), GetExecutorContext());
+    for (const auto &tuple : result_set) {
+      col_b_counts[tuple.GetValue(scan_schema, 1).GetAs<int32_t>()]++;
+    }
+  }
+  size_t expected_col_b_matches = 0;
+  for (size_t count : col_b_counts) {
+    expected_col_b_matches += count * count;
+  }
+
+  // Unique keys: the build side is split, and split again
+  GetExecutorContext()->SetMemoryBudget(8192);
+  {
+    HashJoinPlanNode join_plan{out_schema, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()},
+                               left_col_a, right_col_a};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), TEST1_SIZE);
+    std::vector<bool> seen(TEST1_SIZE);
+    for (const auto &tuple : result_set) {
+      auto left_a = tuple.GetValue(out_schema, 0).GetAs<int32_t>();
+      ASSERT_EQ(left_a, tuple.GetValue(out_schema, 2).GetAs<int32_t>());
+      ASSERT_EQ(tuple.GetValue(out_schema, 1).GetAs<int32_t>(), tuple.GetValue(out_schema, 3).GetAs<int32_t>());
+      ASSERT_FALSE(seen[left_a]);
+      seen[left_a] = true;
+    }
+  }
+
+  // Few keys: partitions that cannot be split are joined one chunk at a time
+  GetExecutorContext()->SetMemoryBudget(2048);
+  {
+    HashJoinPlanNode join_plan{out_schema, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()},
+                               left_col_b, right_col_b};
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), expected_col_b_matches);
+    for (const auto &tuple : result_set) {
+      ASSERT_EQ(tuple.GetValue(out_schema, 1).GetAs<int32_t>(), tuple.GetValue(out_schema, 3).GetAs<int32_t>());
+    }
+  }
+}
+
 // SELECT COUNT(col_a), SUM(col_a), min(col_a), max(col_a) from test_1;
 TEST_F(ExecutorTest, SimpleAggregationTest) {
   const Schema *scan_schema;
@@ -653,4 +948,211 @@ TEST_F(ExecutorTest, SimpleDistinctTest) {
   ASSERT_TRUE(std::equal(results.cbegin(), results.cend(), expected.cbegin()));
 }
 
+// SELECT col_a, col_b FROM test_1 WHERE col_a < 900, on four copies of the scan gathered into one stream
+TEST_F(ExecutorTest, GatherExchangeTest) {
+  TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  const Schema &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *const900 = MakeConstantValueExpression(ValueFactory::GetIntegerValue(900));
+  auto *predicate = MakeComparisonExpression(col_a, const900, ComparisonType::LessThan);
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode scan_plan{out_schema, predicate, table_info->oid_};
+  ExchangePlanNode gather_plan{out_schema, &scan_plan, ExchangeType::Gather};
+
+  // Run serially, the exchange passes the scan through; in parallel, the copies split the table between them.
+  for (size_t parallelism : {1, 4, 4}) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&gather_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(result_set.size(), 900);
+    std::vector<int32_t> values;
+    for (const auto &tuple : result_set) {
+      values.push_back(tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+    std::sort(values.begin(), values.end());
+    for (int32_t i = 0; i < 900; i++) {
+      ASSERT_EQ(i, values[i]);
+    }
+  }
+
+  // A gather abandoned part way stops its copies.
+  auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &gather_plan);
+  executor->Init();
+  Tuple tuple;
+  RID rid;
+  ASSERT_TRUE(executor->Next(&tuple, &rid));
+  executor.reset();
+  GetExecutorContext()->SetParallelism(1);
+}
+
+// SELECT count(col_a), col_b FROM test_1 GROUP BY col_b, on four copies of the aggregation, each fed the groups that
+// hash to it
+TEST_F(ExecutorTest, RepartitionExchangeTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *scan_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+  SeqScanPlanNode scan_plan{scan_schema, nullptr, table_info->oid_};
+
+  auto *scan_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+  auto *scan_col_b = MakeColumnValueExpression(*scan_schema, 0, "colB");
+  ExchangePlanNode repartition_plan{scan_schema, &scan_plan, ExchangeType::Repartition, {scan_col_b}};
+
+  const AbstractExpression *groupby_b = MakeAggregateValueExpression(true, 0);
+  const AbstractExpression *count_a = MakeAggregateValueExpression(false, 0);
+  auto *agg_schema = MakeOutputSchema({{"countA", count_a}, {"colB", groupby_b}});
+  AggregationPlanNode agg_plan{
+      agg_schema, &repartition_plan, nullptr, {scan_col_b}, {scan_col_a}, {AggregationType::CountAggregate}};
+  ExchangePlanNode gather_plan{agg_schema, &agg_plan, ExchangeType::Gather};
+
+  // The serial plan gives the count of each group.
+  std::vector<Tuple> expected_set{};
+  GetExecutionEngine()->Execute(&gather_plan, &expected_set, GetTxn(), GetExecutorContext());
+  std::unordered_map<int32_t, int32_t> expected;
+  for (const auto &tuple : expected_set) {
+    expected[tuple.GetValue(agg_schema, 1).GetAs<int32_t>()] = tuple.GetValue(agg_schema, 0).GetAs<int32_t>();
+  }
+  ASSERT_EQ(expected.size(), 10);
+
+  // In parallel, every group is counted whole, by one of the copies.
+  GetExecutorContext()->SetParallelism(4);
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&gather_plan, &result_set, GetTxn(), GetExecutorContext());
+  GetExecutorContext()->SetParallelism(1);
+  ASSERT_EQ(result_set.size(), expected.size());
+  for (const auto &tuple : result_set) {
+    auto group = tuple.GetValue(agg_schema, 1).GetAs<int32_t>();
+    ASSERT_EQ(expected.count(group), 1);
+    ASSERT_EQ(expected[group], tuple.GetValue(agg_schema, 0).GetAs<int32_t>());
+    expected.erase(group);
+  }
+}
+
+// SELECT test_4.colA, test_6.colA FROM test_4 JOIN test_6 ON test_4.colA = test_6.colA, on four copies of the join,
+// each building on the whole of test_4 and probing with a part of test_6
+TEST_F(ExecutorTest, BroadcastExchangeTest) {
+  auto *table4_info = GetExecutorContext()->GetCatalog()->GetTable("test_4");
+  auto *table4_col_a = MakeColumnValueExpression(table4_info->schema_, 0, "colA");
+  auto *schema4 = MakeOutputSchema({{"colA", table4_col_a}});
+  SeqScanPlanNode scan_plan4{schema4, nullptr, table4_info->oid_};
+  ExchangePlanNode broadcast_plan{schema4, &scan_plan4, ExchangeType::Broadcast};
+
+  auto *table6_info = GetExecutorContext()->GetCatalog()->GetTable("test_6");
+  auto *table6_col_a = MakeColumnValueExpression(table6_info->schema_, 0, "colA");
+  auto *schema6 = MakeOutputSchema({{"colA", table6_col_a}});
+  SeqScanPlanNode scan_plan6{schema6, nullptr, table6_info->oid_};
+
+  auto *left_col_a = MakeColumnValueExpression(*schema4, 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*schema6, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"table4_colA", left_col_a}, {"table6_colA", right_col_a}});
+  HashJoinPlanNode join_plan{out_schema, {&broadcast_plan, &scan_plan6}, left_col_a, right_col_a};
+  ExchangePlanNode gather_plan{out_schema, &join_plan, ExchangeType::Gather};
+
+  GetExecutorContext()->SetParallelism(4);
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(&gather_plan, &result_set, GetTxn(), GetExecutorContext());
+  GetExecutorContext()->SetParallelism(1);
+
+  // Every row of test_6 finds its match once.
+  ASSERT_EQ(result_set.size(), TEST6_SIZE);
+  std::vector<size_t> counts(TEST6_SIZE, 0);
+  for (const auto &tuple : result_set) {
+    auto key = tuple.GetValue(out_schema, 1).GetAs<int64_t>();
+    ASSERT_EQ(key, tuple.GetValue(out_schema, 0).GetAs<int64_t>());
+    counts[key]++;
+  }
+  for (size_t count : counts) {
+    ASSERT_EQ(count, 1);
+  }
+}
+
+// SELECT test_1.colA, test_8.colA, test_9.colA FROM test_1, test_8, test_9
+TEST_F(ExecutorTest, BroadcastNestedLoopJoinTest) {
+  auto make_scan = [this](const std::string &table_name, const Schema **schema) {
+    auto *table_info = GetExecutorContext()->GetCatalog()->GetTable(table_name);
+    auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+    *schema = MakeOutputSchema({{"colA", col_a}});
+    return std::make_unique<SeqScanPlanNode>(*schema, nullptr, table_info->oid_);
+  };
+  const Schema *schema1;
+  const Schema *schema8;
+  const Schema *schema9;
+  auto scan_plan1 = make_scan("test_1", &schema1);
+  auto scan_plan8 = make_scan("test_8", &schema8);
+  auto scan_plan9 = make_scan("test_9", &schema9);
+  ExchangePlanNode broadcast_plan8{schema8, scan_plan8.get(), ExchangeType::Broadcast};
+  ExchangePlanNode broadcast_plan9{schema9, scan_plan9.get(), ExchangeType::Broadcast};
+
+  // The inner join takes many output batches, and the outer one reads its broadcast inner side again for each.
+  auto *col1 = MakeColumnValueExpression(*schema1, 0, "colA");
+  auto *col8 = MakeColumnValueExpression(*schema8, 1, "colA");
+  auto *inner_schema = MakeOutputSchema({{"colA", col1}, {"test_8_colA", col8}});
+  NestedLoopJoinPlanNode inner_join_plan{inner_schema, {scan_plan1.get(), &broadcast_plan8}, nullptr};
+  auto *inner_col1 = MakeColumnValueExpression(*inner_schema, 0, "colA");
+  auto *inner_col8 = MakeColumnValueExpression(*inner_schema, 0, "test_8_colA");
+  auto *col9 = MakeColumnValueExpression(*schema9, 1, "colA");
+  auto *out_schema = MakeOutputSchema({{"colA", inner_col1}, {"test_8_colA", inner_col8}, {"test_9_colA", col9}});
+  NestedLoopJoinPlanNode join_plan{out_schema, {&inner_join_plan, &broadcast_plan9}, nullptr};
+  ExchangePlanNode gather_plan{out_schema, &join_plan, ExchangeType::Gather};
+
+  for (size_t parallelism : {1, 2, 4}) {
+    GetExecutorContext()->SetParallelism(parallelism);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&gather_plan, &result_set, GetTxn(), GetExecutorContext());
+    GetExecutorContext()->SetParallelism(1);
+
+    // Every row of test_1 is joined with every pair of rows of test_8 and test_9.
+    ASSERT_EQ(result_set.size(), TEST1_SIZE * TEST8_SIZE * TEST9_SIZE);
+    std::vector<size_t> counts(TEST1_SIZE, 0);
+    for (const auto &tuple : result_set) {
+      counts[tuple.GetValue(out_schema, 0).GetAs<int32_t>()]++;
+    }
+    for (size_t count : counts) {
+      ASSERT_EQ(count, TEST8_SIZE * TEST9_SIZE);
+    }
+  }
+}
+
+// A scan in a copy of a pipeline splits the table with the scans of the other copies, so it cannot be read again
+TEST_F(ExecutorTest, SharedSeqScanReadOnceTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_9");
+  auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto *schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode scan_plan{schema, nullptr, table_info->oid_};
+
+  auto pipeline_ctx = GetExecutorContext()->MakePipelineContext(2);
+  auto executor = ExecutorFactory::CreateExecutor(pipeline_ctx.get(), &scan_plan);
+  executor->Init();
+  executor->Init();
+  TupleBatch batch;
+  size_t num_rows = 0;
+  while (executor->NextBatch(&batch)) {
+    num_rows += batch.Size();
+  }
+  // The other copy never claimed a morsel, so this one read the whole table.
+  EXPECT_EQ(num_rows, TEST9_SIZE);
+  EXPECT_THROW(executor->Init(), Exception);
+}
+
+// An exchange shared by the copies of a pipeline keeps what it reads only for a consumer that reads it again
+TEST_F(ExecutorTest, SharedExchangeReadOnceTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_9");
+  auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto *schema = MakeOutputSchema({{"colA", col_a}});
+  SeqScanPlanNode scan_plan{schema, nullptr, table_info->oid_};
+  ExchangePlanNode broadcast_plan{schema, &scan_plan, ExchangeType::Broadcast};
+
+  GetExecutorContext()->SetParallelism(2);
+  auto pipeline_ctx = GetExecutorContext()->MakePipelineContext(2);
+  auto executor = ExecutorFactory::CreateExecutor(pipeline_ctx.get(), &broadcast_plan);
+  executor->Init();
+  executor->Init();
+  TupleBatch batch;
+  ASSERT_TRUE(executor->NextBatch(&batch));
+  EXPECT_THROW(executor->Init(), Exception);
+  GetExecutorContext()->SetParallelism(1);
+}
+
 }  // namespace bustub
@@ -96,6 +96,9 @@ class ExecutorTest : public ::testing::Test {
   /** @return The buffer pool manager for our test instance. */
   BufferPoolManager *GetBPM() { return bpm_.get(); }
 
+  /** @return The disk manager for our test instance. */
+  DiskManager *GetDiskManager() { return disk_manager_.get(); }
+
   /** @return The lock manager for our test instance. */
   LockManager *GetLockManager() { return lock_manager_.get(); }
 
@@ -0,0 +1,155 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// filter_kernels_test.cpp
+//
+// Identification: test/execution/filter_kernels_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/batch_filter.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/expressions/logic_expression.h"
+#include "execution/filter_kernels.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+/** @return a value of a type from a small integer, spread over the whole range of the type */
+static Value MakeValue(TypeId type_id, int64_t i) {
+  switch (type_id) {
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(i * (1 << 27)));
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(i * (int64_t{1} << 59));
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(static_cast<double>(i) / 4);
+    default:
+      // Timestamps above 2^63 check that they are compared unsigned.
+      return ValueFactory::GetTimestampValue(static_cast<int64_t>(static_cast<uint64_t>(i + 8) << 60));
+  }
+}
+
+/** Check the bitmap of a predicate against evaluating it on each row. */
+static void CheckBitmap(const AbstractExpression &predicate, const TupleBatch &batch, const SelectionBitmap &bitmap) {
+  ASSERT_EQ(batch.Size(), bitmap.NumRows());
+  size_t count = 0;
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    Value value = predicate.EvaluateInBatch(&batch, row);
+    bool selected = !value.IsNull() && value.GetAs<bool>();
+    ASSERT_EQ(selected, bitmap.IsSet(row)) << "row " << row;
+    count += selected ? 1 : 0;
+  }
+  EXPECT_EQ(count, bitmap.Count());
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, CompareTest) {
+  std::mt19937 generator(15445);
+  std::uniform_int_distribution<int64_t> distribution(-7, 7);
+  for (TypeId type_id : {TypeId::INTEGER, TypeId::BIGINT, TypeId::DECIMAL, TypeId::TIMESTAMP}) {
+    SCOPED_TRACE(Type::TypeIdToString(type_id));
+    ASSERT_TRUE(FilterKernels::IsSupported(type_id));
+    std::vector<Column> columns{Column("a", type_id), Column("b", type_id)};
+    Schema schema(columns);
+
+    // A number of rows that leaves a partial register at the end, and a few nulls.
+    TupleBatch batch;
+    batch.Init(&schema);
+    for (int i = 0; i < 1001; i++) {
+      Value null = ValueFactory::GetNullValueByType(type_id);
+      batch.AppendValue(0, i % 13 == 0 ? null : MakeValue(type_id, distribution(generator)));
+      batch.AppendValue(1, i % 17 == 0 ? null : MakeValue(type_id, distribution(generator)));
+      batch.FinishRow(RID());
+    }
+
+    ColumnValueExpression col_a(0, 0, type_id);
+    ColumnValueExpression col_b(0, 1, type_id);
+    SelectionBitmap bitmap;
+    for (ComparisonType comp_type :
+         {ComparisonType::Equal, ComparisonType::NotEqual, ComparisonType::LessThan, ComparisonType::LessThanOrEqual,
+          ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual}) {
+      for (int64_t i : {-8, 0, 3, 8}) {
+        ConstantValueExpression constant(MakeValue(type_id, i));
+        FilterKernels::CompareConstant(comp_type, batch.GetColumn(0), constant.Evaluate(nullptr, nullptr), &bitmap);
+        CheckBitmap(ComparisonExpression(&col_a, &constant, comp_type), batch, bitmap);
+      }
+      FilterKernels::CompareColumns(comp_type, batch.GetColumn(0), batch.GetColumn(1), &bitmap);
+      CheckBitmap(ComparisonExpression(&col_a, &col_b, comp_type), batch, bitmap);
+
+      // Nothing compares true with null.
+      FilterKernels::CompareConstant(comp_type, batch.GetColumn(0), ValueFactory::GetNullValueByType(type_id), &bitmap);
+      EXPECT_EQ(0U, bitmap.Count());
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(FilterKernelsTest, BatchFilterTest) {
+  std::vector<Column> columns{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT),
+                              Column("c", TypeId::VARCHAR, 8)};
+  Schema schema(columns);
+  TupleBatch batch;
+  batch.Init(&schema);
+  for (int i = 0; i < 300; i++) {
+    batch.AppendValue(0, i % 10 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                     : ValueFactory::GetIntegerValue(i));
+    batch.AppendValue(1, ValueFactory::GetBigIntValue(300 - i));
+    batch.AppendValue(2, ValueFactory::GetVarcharValue(i % 2 == 0 ? "even" : "odd"));
+    batch.FinishRow(RID());
+  }
+
+  ColumnValueExpression col_a(0, 0, TypeId::INTEGER);
+  ColumnValueExpression col_b(0, 1, TypeId::BIGINT);
+  ColumnValueExpression col_c(0, 2, TypeId::VARCHAR);
+  ConstantValueExpression const100(ValueFactory::GetIntegerValue(100));
+  ConstantValueExpression const250(ValueFactory::GetIntegerValue(250));
+  ConstantValueExpression big(ValueFactory::GetBigIntValue(int64_t{1} << 40));
+  ConstantValueExpression even(ValueFactory::GetVarcharValue("even"));
+
+  // a < 100 AND b < 250, with an INTEGER constant cast to the BIGINT column
+  ComparisonExpression a_lt_100(&col_a, &const100, ComparisonType::LessThan);
+  ComparisonExpression b_lt_250(&col_b, &const250, ComparisonType::LessThan);
+  // 100 <= a, with the constant on the left
+  ComparisonExpression a_ge_100(&const100, &col_a, ComparisonType::LessThanOrEqual);
+  // a < 2^40, with a BIGINT constant that does not fit the column
+  ComparisonExpression a_lt_big(&col_a, &big, ComparisonType::LessThan);
+  // c = 'even', evaluated row by row
+  ComparisonExpression c_even(&col_c, &even, ComparisonType::Equal);
+  // a > b, on two columns of different types
+  ComparisonExpression a_gt_b(&col_a, &col_b, ComparisonType::GreaterThan);
+  LogicExpression and_expr(&a_lt_100, &b_lt_250, LogicType::And);
+  LogicExpression or_expr(&and_expr, &c_even, LogicType::Or);
+  LogicExpression nested(&or_expr, &a_ge_100, LogicType::Or);
+
+  SelectionBitmap bitmap;
+  for (const AbstractExpression *predicate : std::vector<const AbstractExpression *>{
+           &a_lt_100, &b_lt_250, &a_ge_100, &a_lt_big, &c_even, &a_gt_b, &and_expr, &or_expr, &nested}) {
+    BatchFilter filter(predicate, &schema);
+    filter.Evaluate(batch, &bitmap);
+    CheckBitmap(*predicate, batch, bitmap);
+  }
+
+  // The selection vector lists the rows of the bitmap.
+  BatchFilter filter(&and_expr, &schema);
+  filter.Evaluate(batch, &bitmap);
+  std::vector<uint32_t> selection;
+  bitmap.ToSelection(&selection);
+  ASSERT_EQ(bitmap.Count(), selection.size());
+  for (uint32_t row : selection) {
+    EXPECT_TRUE(bitmap.IsSet(row));
+    EXPECT_LT(batch.GetValue(0, row).GetAs<int32_t>(), 100);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,77 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// join_hash_table_test.cpp
+//
+// Identification: test/execution/join_hash_table_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/join_hash_table.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(JoinHashTableTest, InsertFindTest) {
+  std::vector<Column> columns{Column("key", TypeId::VARCHAR, 16), Column("value", TypeId::INTEGER)};
+  Schema schema(columns);
+  auto make_key = [](int key) { return ValueFactory::GetVarcharValue("key" + std::to_string(key)); };
+
+  // Enough keys for the slots to grow and enough rows for several chunks.
+  JoinHashTable table;
+  const int num_keys = 1000;
+  const int rows_per_key = 3;
+  for (int i = 0; i < rows_per_key; i++) {
+    for (int key = 0; key < num_keys; key++) {
+      Value key_value = make_key(key);
+      std::vector<Value> values{key_value, ValueFactory::GetIntegerValue(key * rows_per_key + i)};
+      table.Insert(key_value, HashUtil::HashValue(&key_value), Tuple(values, &schema));
+    }
+  }
+  EXPECT_EQ(static_cast<size_t>(num_keys * rows_per_key), table.GetNumTuples());
+  EXPECT_LT(0, table.GetMemory());
+
+  for (int key = 0; key < num_keys; key++) {
+    Value key_value = make_key(key);
+    std::vector<bool> seen(rows_per_key);
+    int count = 0;
+    for (const char *row = table.Find(key_value, HashUtil::HashValue(&key_value)); row != nullptr;
+         row = JoinHashTable::NextRow(row)) {
+      Tuple tuple;
+      JoinHashTable::GetTuple(row, &tuple);
+      ASSERT_EQ(key_value.ToString(), tuple.GetValue(&schema, 0).ToString());
+      int value = tuple.GetValue(&schema, 1).GetAs<int32_t>();
+      ASSERT_EQ(key, value / rows_per_key);
+      seen[value % rows_per_key] = true;
+      count++;
+    }
+    EXPECT_EQ(rows_per_key, count);
+    EXPECT_EQ(std::vector<bool>(rows_per_key, true), seen);
+  }
+
+  // A key that collides on the hash is still told apart.
+  Value missing = make_key(num_keys);
+  Value present = make_key(0);
+  EXPECT_EQ(nullptr, table.Find(missing, HashUtil::HashValue(&missing)));
+  EXPECT_EQ(nullptr, table.Find(missing, HashUtil::HashValue(&present)));
+
+  int num_rows = 0;
+  table.ForEachRow([&num_rows](const char *row) { num_rows++; });
+  EXPECT_EQ(num_keys * rows_per_key, num_rows);
+
+  table.Clear();
+  EXPECT_EQ(0, table.GetNumTuples());
+  EXPECT_EQ(0, table.GetMemory());
+  EXPECT_EQ(nullptr, table.Find(present, HashUtil::HashValue(&present)));
+}
+
+}  // namespace bustub
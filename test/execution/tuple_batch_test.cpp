@@ -0,0 +1,87 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch_test.cpp
+//
+// Identification: test/execution/tuple_batch_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/tuple_batch.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TupleBatchTest, AppendSelectTest) {
+  std::vector<Column> columns{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT),
+                              Column("c", TypeId::VARCHAR, 16)};
+  Schema schema(columns);
+
+  // Fill the batch, with rows appended either value by value or as tuples.
+  TupleBatch batch;
+  batch.Init(&schema);
+  for (int i = 0; !batch.IsFull(); i++) {
+    Value a = i % 7 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i);
+    // An INTEGER value is cast to the type of the column.
+    Value b = ValueFactory::GetIntegerValue(2 * i);
+    Value c = ValueFactory::GetVarcharValue("row" + std::to_string(i));
+    if (i % 2 == 0) {
+      batch.AppendValue(0, a);
+      batch.AppendValue(1, b);
+      batch.AppendValue(2, c);
+      batch.FinishRow(RID(i, 0));
+    } else {
+      batch.AppendTuple(Tuple({a, b, c}, &schema), RID(i, 0));
+    }
+  }
+  ASSERT_EQ(EXECUTION_BATCH_SIZE, batch.Size());
+
+  for (uint32_t row = 0; row < batch.Size(); row++) {
+    EXPECT_EQ(row % 7 == 0, batch.GetValue(0, row).IsNull());
+    if (row % 7 != 0) {
+      EXPECT_EQ(static_cast<int32_t>(row), batch.GetValue(0, row).GetAs<int32_t>());
+      EXPECT_EQ(static_cast<int32_t>(row), batch.GetColumn(0).GetData<int32_t>()[row]);
+    }
+    EXPECT_EQ(TypeId::BIGINT, batch.GetValue(1, row).GetTypeId());
+    EXPECT_EQ(2 * static_cast<int64_t>(row), batch.GetColumn(1).GetData<int64_t>()[row]);
+    EXPECT_EQ("row" + std::to_string(row), batch.GetValue(2, row).ToString());
+    EXPECT_EQ(RID(row, 0), batch.GetRid(row));
+  }
+
+  // Keep the even rows.
+  std::vector<uint32_t> selection;
+  for (uint32_t row = 0; row < batch.Size(); row += 2) {
+    selection.push_back(row);
+  }
+  batch.Select(selection);
+  ASSERT_EQ(EXECUTION_BATCH_SIZE / 2, batch.Size());
+  for (size_t i = 0; i < batch.Size(); i++) {
+    uint32_t row = batch.GetRow(i);
+    EXPECT_EQ(2 * i, row);
+    Tuple tuple = batch.GetTuple(row);
+    EXPECT_EQ("row" + std::to_string(row), tuple.GetValue(&schema, 2).ToString());
+    EXPECT_EQ(2 * static_cast<int64_t>(row), tuple.GetValue(&schema, 1).GetAs<int64_t>());
+  }
+
+  // Reusing the batch drops its rows and its selection.
+  batch.Init(&schema);
+  EXPECT_TRUE(batch.IsEmpty());
+  batch.AppendTuple(Tuple({ValueFactory::GetIntegerValue(1), ValueFactory::GetBigIntValue(2),
+                           ValueFactory::GetVarcharValue("x")},
+                          &schema),
+                    RID(1, 1));
+  ASSERT_EQ(1U, batch.Size());
+  EXPECT_EQ(0U, batch.GetRow(0));
+  EXPECT_EQ(2, batch.GetValue(1, 0).GetAs<int64_t>());
+}
+
+}  // namespace bustub
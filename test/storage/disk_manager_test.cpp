@@ -10,10 +10,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <condition_variable>  // NOLINT
 #include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
+#include "storage/disk/async_disk_manager.h"
 #include "storage/disk/disk_manager.h"
 
 namespace bustub {
@@ -24,12 +30,14 @@ class DiskManagerTest : public ::testing::Test {
   void SetUp() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
   }
 
   // This function is called after every test.
   void TearDown() override {
     remove("test.db");
     remove("test.log");
+    remove("test.fsm");
   };
 };
 
@@ -72,7 +80,177 @@ TEST_F(DiskManagerTest, ReadWriteLogTest) {
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapTest) {
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+    dm.WritePage(page_id, data);
+  }
+
+  // Deallocated pages are reused, lowest first.
+  dm.DeallocatePage(3);
+  dm.DeallocatePage(1);
+  dm.DeallocatePage(1);
+  EXPECT_EQ(true, dm.IsFreePage(1));
+  EXPECT_EQ(2, dm.GetNumFreePages());
+  EXPECT_EQ(1, dm.AllocatePage());
+  EXPECT_EQ(false, dm.IsFreePage(1));
+
+  // Free pages at the end of the file are truncated away.
+  dm.DeallocatePage(4);
+  EXPECT_EQ(0, dm.GetNumFreePages());
+  EXPECT_EQ(3, dm.GetNumPages());
+  EXPECT_EQ(3, dm.AllocatePage());
+
+  // The map outlives the disk manager.
+  dm.DeallocatePage(2);
+  dm.ShutDown();
+  auto reopened = DiskManager(db_file, true);
+  EXPECT_EQ(true, reopened.IsFreePage(2));
+  EXPECT_EQ(2, reopened.AllocatePage());
+  EXPECT_EQ(4, reopened.AllocatePage());
+  reopened.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapOptInTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+  EXPECT_EQ(0, dm.AllocatePage());
+  EXPECT_EQ(1, dm.AllocatePage());
+
+  // Without the map file, freed pages are still reused within the run.
+  dm.DeallocatePage(0);
+  EXPECT_EQ(0, dm.AllocatePage());
+  dm.ShutDown();
+  EXPECT_EQ(false, std::ifstream("test.fsm").good());
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, FreePageMapWriteBackTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file, true);
+  auto read_map = [] {
+    std::ifstream fsm("test.fsm", std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(fsm), std::istreambuf_iterator<char>());
+  };
+  std::vector<char> empty_map = read_map();
+
+  // Allocating and deallocating pages only changes the map in memory.
+  for (page_id_t page_id = 0; page_id < 20; ++page_id) {
+    EXPECT_EQ(page_id, dm.AllocatePage());
+  }
+  dm.DeallocatePage(3);
+  dm.DeallocatePage(5);
+  EXPECT_EQ(empty_map, read_map());
+  dm.FlushFreeMap();
+  std::vector<char> map = read_map();
+  ASSERT_LT(sizeof(page_id_t), map.size());
+  EXPECT_EQ((1 << 3) | (1 << 5), map[sizeof(page_id_t)]);
+
+  // Handing out a page the file still has free writes its bit through.
+  EXPECT_EQ(3, dm.AllocatePage());
+  EXPECT_EQ(1 << 5, read_map()[sizeof(page_id_t)]);
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, StripedAllocationTest) {
+  std::string db_file("test.db");
+  auto dm = DiskManager(db_file);
+
+  // Each stripe gets page ids congruent to its offset. Skipped ids are left to the other stripes.
+  EXPECT_EQ(2, dm.AllocatePage(3, 2));
+  EXPECT_EQ(2, dm.GetNumFreePages());
+  EXPECT_EQ(0, dm.AllocatePage(3, 0));
+  EXPECT_EQ(1, dm.AllocatePage(3, 1));
+  EXPECT_EQ(4, dm.AllocatePage(3, 1));
+  EXPECT_EQ(1, dm.GetNumFreePages());
+
+  // Hole punching keeps the file size.
+  char data[PAGE_SIZE] = {0};
+  for (page_id_t page_id = 0; page_id < 5; ++page_id) {
+    dm.WritePage(page_id, data);
+  }
+  dm.SetPunchHoles(true);
+  dm.DeallocatePage(1);
+  EXPECT_EQ(5, dm.GetNumPages());
+  dm.ShutDown();
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ThrowBadFileTest) { EXPECT_THROW(DiskManager("dev/null\\/foo/bar/baz/test.db"), Exception); }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncReadWritePageTest) {
+  char buf[PAGE_SIZE] = {0};
+  char data[PAGE_SIZE] = {0};
+  std::string db_file("test.db");
+  AsyncDiskManager dm(db_file);
+  std::strncpy(data, "A test string.", sizeof(data));
+
+  dm.ReadPage(0, buf);  // tolerate empty read
+
+  dm.WritePage(0, data);
+  dm.ReadPage(0, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  std::memset(buf, 0, sizeof(buf));
+  dm.WritePage(5, data);
+  dm.ReadPage(5, buf);
+  EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
+
+  // Pages that were never written read back as zeros.
+  dm.ReadPage(3, buf);
+  EXPECT_EQ(buf[0], 0);
+
+  dm.ShutDown();
+}
+
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncManyInFlightTest) {
+  const int num_pages = 4 * DISK_QUEUE_DEPTH;
+  std::string db_file("test.db");
+  AsyncDiskManager dm(db_file);
+
+  // Offset every buffer by one byte so that O_DIRECT has to go through the bounce buffers.
+  std::vector<char> data(static_cast<size_t>(num_pages) * PAGE_SIZE + 1);
+  std::vector<char> buf(static_cast<size_t>(num_pages) * PAGE_SIZE + 1);
+  for (int i = 0; i < num_pages; ++i) {
+    std::memset(&data[1 + static_cast<size_t>(i) * PAGE_SIZE], 'a' + i % 26, PAGE_SIZE);
+  }
+
+  std::mutex latch;
+  std::condition_variable cv;
+  int remaining = num_pages;
+  auto callback = [&] {
+    std::lock_guard<std::mutex> guard(latch);
+    if (--remaining == 0) {
+      cv.notify_one();
+    }
+  };
+  auto wait = [&] {
+    std::unique_lock<std::mutex> lock(latch);
+    cv.wait(lock, [&] { return remaining == 0; });
+  };
+
+  for (int i = 0; i < num_pages; ++i) {
+    dm.WritePageAsync(i, &data[1 + static_cast<size_t>(i) * PAGE_SIZE], callback);
+  }
+  wait();
+  EXPECT_EQ(dm.GetNumWrites(), num_pages);
+
+  remaining = num_pages;
+  for (int i = num_pages - 1; i >= 0; --i) {
+    dm.ReadPageAsync(i, &buf[1 + static_cast<size_t>(i) * PAGE_SIZE], callback);
+  }
+  wait();
+  EXPECT_EQ(std::memcmp(&buf[1], &data[1], static_cast<size_t>(num_pages) * PAGE_SIZE), 0);
+
+  dm.ShutDown();
+}
+
 }  // namespace bustub
@@ -10,25 +10,29 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <cstdio>
+#include <string>
 #include <vector>
 
+#include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "storage/page/tmp_tuple_page.h"
+#include "storage/table/tmp_tuple_store.h"
 #include "type/value_factory.h"
 
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
-  // There are many ways to do this assignment, and this is only one of them.
-  // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
-  // You will get full credit as long as you are correctly using a linear probe hash table.
+TEST(TmpTuplePageTest, BasicTest) {
+  // Page memory belongs to the buffer pool, so take the page from one.
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(1, disk_manager);
+  page_id_t page_id;
+  auto *page = static_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+  ASSERT_NE(nullptr, page);
+  page->Init(page_id, PAGE_SIZE);
 
-  TmpTuplePage page{};
-  page_id_t page_id = 15445;
-  page.Init(page_id, PAGE_SIZE);
-
-  char *data = page.GetData();
+  char *data = page->GetData();
   ASSERT_EQ(*reinterpret_cast<page_id_t *>(data), page_id);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE);
 
@@ -41,11 +45,89 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
 
   Tuple tuple(values, &schema);
   TmpTuple tmp_tuple(INVALID_PAGE_ID, 0);
-  page.Insert(tuple, &tmp_tuple);
+  ASSERT_TRUE(page->Insert(tuple, &tmp_tuple));
 
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  EXPECT_TRUE(tmp_tuple == TmpTuple(page_id, PAGE_SIZE - 8));
+
+  Tuple read;
+  page->Get(tmp_tuple.GetOffset(), &read);
+  EXPECT_EQ(123, read.GetValue(&schema, 0).GetAs<int32_t>());
+  EXPECT_EQ(PAGE_SIZE, page->NextOffset(tmp_tuple.GetOffset()));
+
+  bpm->UnpinPage(page_id, true);
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(TmpTuplePageTest, TmpTupleStoreTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(4, disk_manager);
+
+  std::vector<Column> columns;
+  columns.emplace_back("A", TypeId::INTEGER);
+  columns.emplace_back("B", TypeId::VARCHAR, 100);
+  Schema schema(columns);
+  auto make_tuple = [&schema](int i) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(i),
+                              ValueFactory::GetVarcharValue(std::string(i % 100, 'x'))};
+    return Tuple(values, &schema);
+  };
+
+  // The store outgrows the buffer pool; its pages are evicted and read back.
+  const int num_tuples = 2000;
+  std::vector<TmpTuple> locations;
+  {
+    TmpTupleStore store(bpm);
+    for (int i = 0; i < num_tuples; i++) {
+      TmpTuple location(INVALID_PAGE_ID, 0);
+      ASSERT_TRUE(store.Append(make_tuple(i), &location));
+      locations.push_back(location);
+    }
+    EXPECT_EQ(static_cast<size_t>(num_tuples), store.GetNumTuples());
+    EXPECT_LT(4, store.GetNumPages());
+
+    int expected = 0;
+    for (auto itr = store.Begin(); itr != store.End(); ++itr) {
+      EXPECT_EQ(expected, itr->GetValue(&schema, 0).GetAs<int32_t>());
+      EXPECT_EQ(std::string(expected % 100, 'x'), itr->GetValue(&schema, 1).ToString());
+      expected++;
+    }
+    EXPECT_EQ(num_tuples, expected);
+
+    for (int i = num_tuples - 1; i >= 0; i -= 7) {
+      Tuple tuple;
+      ASSERT_TRUE(store.Get(locations[i], &tuple));
+      EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    }
+
+    // A tuple larger than a page is rejected.
+    std::vector<Value> values{ValueFactory::GetIntegerValue(0),
+                              ValueFactory::GetVarcharValue(std::string(PAGE_SIZE, 'x'))};
+    EXPECT_FALSE(store.Append(Tuple(values, &schema)));
+
+    store.Clear();
+    EXPECT_EQ(0, store.GetNumPages());
+    EXPECT_TRUE(store.Begin() == store.End());
+    ASSERT_TRUE(store.Append(make_tuple(1)));
+    EXPECT_EQ(1, store.GetNumTuples());
+  }
+
+  // The pages of a store are deleted with it, and allocated again.
+  page_id_t page_id;
+  ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+  EXPECT_EQ(0, page_id);
+  bpm->UnpinPage(page_id, false);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  delete bpm;
+  delete disk_manager;
 }
 
 }  // namespace bustub
@@ -13,12 +13,17 @@
 #include <algorithm>
 #include <cstdio>
 #include <iostream>
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
+#include <thread>  // NOLINT
 #include <vector>
 
 #include "buffer/buffer_pool_manager_instance.h"
 #include "gtest/gtest.h"
 #include "logging/common.h"
+#include "storage/disk/async_disk_manager.h"
+#include "storage/table/morsel_dispenser.h"
 #include "storage/table/table_heap.h"
 #include "storage/table/tuple.h"
 
@@ -71,4 +76,235 @@ TEST(TupleTest, DISABLED_TableHeapTest) {
   delete disk_manager;
 }
 
+/**
+ * TableHeapTest gives each test a table of (INTEGER a, VARCHAR(200) b) tuples in a small buffer pool, and removes its
+ * files afterwards.
+ */
+class TableHeapTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    transaction_ = std::make_unique<Transaction>(0);
+    disk_manager_ = MakeDiskManager();
+    bpm_ = std::make_unique<BufferPoolManagerInstance>(16, disk_manager_.get());
+    lock_manager_ = std::make_unique<LockManager>();
+    table_ = std::make_unique<TableHeap>(bpm_.get(), lock_manager_.get(), nullptr, transaction_.get());
+  }
+
+  void TearDown() override {
+    table_.reset();
+    bpm_.reset();
+    disk_manager_->ShutDown();
+    remove("test.db");
+  }
+
+  /** @return the disk manager of the table's buffer pool */
+  virtual std::unique_ptr<DiskManager> MakeDiskManager() { return std::make_unique<DiskManager>("test.db"); }
+
+  /** @return a tuple whose first column is i, which takes up about 150 bytes */
+  Tuple MakeTuple(int i) {
+    std::vector<Value> values{Value(TypeId::INTEGER, i), Value(TypeId::VARCHAR, std::string(150, 'x'))};
+    return Tuple(values, &schema_);
+  }
+
+  /** Insert the tuples first to first + count - 1 with InsertTuple. */
+  void InsertTuples(int first, int count, std::vector<RID> *rids = nullptr) {
+    for (int i = first; i < first + count; ++i) {
+      RID rid;
+      ASSERT_TRUE(table_->InsertTuple(MakeTuple(i), &rid, transaction_.get()));
+      if (rids != nullptr) {
+        rids->push_back(rid);
+      }
+    }
+  }
+
+  Schema schema_{std::vector<Column>{Column{"a", TypeId::INTEGER}, Column{"b", TypeId::VARCHAR, 200}}};
+  std::unique_ptr<Transaction> transaction_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManagerInstance> bpm_;
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<TableHeap> table_;
+};
+
+/** TableHeapAsyncTest reads and writes the table through an AsyncDiskManager. */
+class TableHeapAsyncTest : public TableHeapTest {
+ protected:
+  std::unique_ptr<DiskManager> MakeDiskManager() override { return std::make_unique<AsyncDiskManager>("test.db"); }
+};
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapAsyncTest, ReadAheadTest) {
+  // Enough tuples to span many more pages than the pool holds, so the scan has to go to disk.
+  const int num_tuples = 800;
+  InsertTuples(0, num_tuples);
+  bpm_->FlushAllPages();
+
+  for (size_t window : {0, 1, 4, 8}) {
+    table_->SetReadAheadWindow(window);
+    int expected = 0;
+    for (auto itr = table_->Begin(transaction_.get()); itr != table_->End(); ++itr) {
+      EXPECT_EQ(expected++, itr->GetValue(&schema_, 0).GetAs<int32_t>());
+    }
+    EXPECT_EQ(num_tuples, expected);
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, ReadAheadDiskReadsTest) {
+  InsertTuples(0, 800);
+  bpm_->FlushAllPages();
+  // Few enough frames that read-ahead evicts pages before the scan reaches them, if it is not held back.
+  ASSERT_TRUE(bpm_->Resize(10));
+  auto scan_reads = [this] {
+    int num_reads = disk_manager_->GetNumReads();
+    int count = 0;
+    for (auto itr = table_->Begin(transaction_.get()); itr != table_->End(); ++itr) {
+      ++count;
+    }
+    EXPECT_EQ(800, count);
+    return disk_manager_->GetNumReads() - num_reads;
+  };
+
+  // Read-ahead reads the pages a scan needs before it gets to them, but does not read any page more than once.
+  table_->SetReadAheadWindow(0);
+  int reads_without = scan_reads();
+  EXPECT_EQ(0, bpm_->GetStats().prefetches_);
+  table_->SetReadAheadWindow(TABLE_READ_AHEAD_WINDOW);
+  int reads_with = scan_reads();
+  EXPECT_LT(0, bpm_->GetStats().prefetches_);
+  EXPECT_EQ(reads_without, reads_with);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, MorselDispenserTest) {
+  const int num_tuples = 800;
+  InsertTuples(0, num_tuples);
+  std::vector<page_id_t> chain;
+  for (auto itr = table_->Begin(transaction_.get()); itr != table_->End(); ++itr) {
+    if (chain.empty() || chain.back() != itr->GetRid().GetPageId()) {
+      chain.push_back(itr->GetRid().GetPageId());
+    }
+  }
+
+  // A reopened table does not know its pages, so the dispenser has to follow the chain itself.
+  TableHeap reopened(bpm_.get(), lock_manager_.get(), nullptr, table_->GetFirstPageId());
+  for (TableHeap *heap : {&reopened, table_.get()}) {
+    MorselDispenser dispenser(heap, 2);
+    for (int round = 0; round < 2; ++round) {
+      // Four threads claim morsels at once; every page goes to one of them, each morsel in the order of the chain.
+      std::vector<std::vector<page_id_t>> morsels;
+      std::mutex morsels_latch;
+      std::vector<std::thread> threads;
+      for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] {
+          std::vector<page_id_t> page_ids;
+          while (dispenser.Next(&page_ids)) {
+            std::lock_guard<std::mutex> guard(morsels_latch);
+            morsels.push_back(page_ids);
+          }
+        });
+      }
+      for (auto &thread : threads) {
+        thread.join();
+      }
+      std::sort(morsels.begin(), morsels.end(), [&chain](const auto &a, const auto &b) {
+        return std::find(chain.begin(), chain.end(), a[0]) < std::find(chain.begin(), chain.end(), b[0]);
+      });
+      std::vector<page_id_t> claimed;
+      for (const auto &morsel : morsels) {
+        ASSERT_GE(2U, morsel.size());
+        claimed.insert(claimed.end(), morsel.begin(), morsel.end());
+      }
+      EXPECT_EQ(chain, claimed);
+      dispenser.Reset();
+    }
+  }
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, FreeSpaceMapTest) {
+  const int num_tuples = 200;
+  std::vector<RID> rids;
+  InsertTuples(0, num_tuples, &rids);
+  size_t num_pages = table_->GetFreeSpaceMap()->GetNumPages();
+  EXPECT_LT(1, num_pages);
+
+  // Space freed in the first page is reused before the table grows.
+  int num_freed = 0;
+  for (const RID &rid : rids) {
+    if (rid.GetPageId() == table_->GetFirstPageId()) {
+      ASSERT_TRUE(table_->MarkDelete(rid, transaction_.get()));
+      table_->ApplyDelete(rid, transaction_.get());
+      ++num_freed;
+    }
+  }
+  int num_reused = 0;
+  int next_value = num_tuples;
+  while (table_->GetFreeSpaceMap()->GetNumPages() == num_pages) {
+    RID rid;
+    ASSERT_TRUE(table_->InsertTuple(MakeTuple(next_value++), &rid, transaction_.get()));
+    num_reused += rid.GetPageId() == table_->GetFirstPageId() ? 1 : 0;
+  }
+  EXPECT_EQ(num_freed, num_reused);
+
+  // A reopened table learns its pages on its first insert, which goes to the page with room rather than a new one.
+  TableHeap reopened(bpm_.get(), lock_manager_.get(), nullptr, table_->GetFirstPageId());
+  EXPECT_EQ(0, reopened.GetFreeSpaceMap()->GetNumPages());
+  RID rid;
+  ASSERT_TRUE(reopened.InsertTuple(MakeTuple(next_value++), &rid, transaction_.get()));
+  EXPECT_EQ(num_pages + 1, reopened.GetFreeSpaceMap()->GetNumPages());
+  int count = 0;
+  for (auto itr = reopened.Begin(transaction_.get()); itr != reopened.End(); ++itr) {
+    ++count;
+  }
+  EXPECT_EQ(next_value - num_freed, count);
+}
+
+// NOLINTNEXTLINE
+TEST_F(TableHeapTest, BulkInsertTest) {
+  // Load the tuples in a few batches; they land in order, each page filled before the next one is started.
+  const int num_tuples = 1000;
+  const int batch_size = 300;
+  std::vector<RID> all_rids;
+  for (int start = 0; start < num_tuples; start += batch_size) {
+    std::vector<Tuple> batch;
+    for (int i = start; i < std::min(num_tuples, start + batch_size); ++i) {
+      batch.push_back(MakeTuple(i));
+    }
+    std::vector<RID> rids;
+    ASSERT_TRUE(table_->BulkInsert(batch, &rids, transaction_.get()));
+    ASSERT_EQ(batch.size(), rids.size());
+    all_rids.insert(all_rids.end(), rids.begin(), rids.end());
+  }
+  uint32_t tuple_space = TablePage::SpaceNeeded(MakeTuple(0));
+  size_t num_pages = 1;
+  for (size_t i = 1; i < all_rids.size(); ++i) {
+    if (all_rids[i].GetPageId() != all_rids[i - 1].GetPageId()) {
+      ++num_pages;
+      EXPECT_EQ(0, all_rids[i].GetSlotNum());
+    } else {
+      EXPECT_EQ(all_rids[i - 1].GetSlotNum() + 1, all_rids[i].GetSlotNum());
+    }
+  }
+  EXPECT_EQ(num_pages, table_->GetFreeSpaceMap()->GetNumPages());
+  for (auto page_id = table_->GetFirstPageId(); page_id != all_rids.back().GetPageId();) {
+    auto *page = static_cast<TablePage *>(bpm_->FetchPage(page_id));
+    EXPECT_GT(tuple_space, page->GetFreeSpaceRemaining());
+    page_id_t next_page_id = page->GetNextPageId();
+    bpm_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+  int expected = 0;
+  for (auto itr = table_->Begin(transaction_.get()); itr != table_->End(); ++itr) {
+    EXPECT_EQ(expected++, itr->GetValue(&schema_, 0).GetAs<int32_t>());
+  }
+  EXPECT_EQ(num_tuples, expected);
+
+  // A batch with a tuple larger than a page inserts nothing.
+  std::vector<Value> large_values{Value(TypeId::INTEGER, 0), Value(TypeId::VARCHAR, std::string(PAGE_SIZE, 'x'))};
+  std::vector<Tuple> large_batch{MakeTuple(num_tuples), Tuple(large_values, &schema_)};
+  std::vector<RID> rids;
+  EXPECT_FALSE(table_->BulkInsert(large_batch, &rids, transaction_.get()));
+  EXPECT_TRUE(rids.empty());
+}
+
 }  // namespace bustub
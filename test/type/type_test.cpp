@@ -95,4 +95,14 @@ TEST(TypeTests, TemplateTest) {
   BPlusTreePage<Value, Value> node;
   node.GetInfo(val1, val2);
 }
+
+// NOLINTNEXTLINE
+TEST(TypeTests, TimestampComparableTest) {
+  Value ts1(TypeId::TIMESTAMP, static_cast<uint64_t>(42));
+  Value ts2(TypeId::TIMESTAMP, static_cast<uint64_t>(43));
+  Value str(TypeId::VARCHAR, std::string("42"));
+  EXPECT_TRUE(ts1.CheckComparable(ts2));
+  EXPECT_FALSE(ts1.CheckComparable(str));
+  EXPECT_EQ(ts1.CompareLessThan(ts2), CmpBool::CmpTrue);
+}
 }  // namespace bustub